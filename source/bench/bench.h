@@ -0,0 +1,61 @@
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+/*!
+ * @file bench.h
+ * @brief Tiny timing helpers shared by the benchmarks.
+ *
+ * Each benchmark runs a callable a few times and keeps the best time, which
+ * filters out most of the noise from page faults and frequency scaling.
+ */
+
+#include <chrono>     // std::chrono
+#include <cstdio>     // std::printf
+#include <string>     // std::string
+
+namespace bench {
+    /// Keeps the compiler from optimizing away a computed value.
+    template <typename T>
+    inline void do_not_optimize( const T & value )
+    {
+        asm volatile( "" : : "r"( &value ) : "memory" );
+    }
+
+    /// Runs setup() then f() reps times and returns the best time of f(), in milliseconds.
+    template <typename Setup, typename F>
+    double best_of( int reps, Setup setup, F f )
+    {
+        double best{ 1e300 };
+        for ( int i{0} ; i < reps ; ++i )
+        {
+            setup();
+            auto start = std::chrono::steady_clock::now();
+            f();
+            auto stop = std::chrono::steady_clock::now();
+            double ms = std::chrono::duration<double, std::milli>( stop - start ).count();
+            if ( ms < best ) best = ms;
+        }
+        return best;
+    }
+
+    /// Same as above, without a setup step.
+    template <typename F>
+    double best_of( int reps, F f )
+    {
+        return best_of( reps, []{}, f );
+    }
+
+    /// Prints a header line for a table of results.
+    inline void header( const std::string & title )
+    {
+        std::printf( "\n%s\n", title.c_str() );
+        std::printf( "%-44s %12s %10s\n", "case", "time (ms)", "speedup" );
+    }
+
+    /// Prints one result, with its speedup over the baseline time.
+    inline void row( const std::string & name, double ms, double baseline_ms )
+    {
+        std::printf( "%-44s %12.3f %9.2fx\n", name.c_str(), ms, baseline_ms / ms );
+    }
+} // namespace bench.
+#endif
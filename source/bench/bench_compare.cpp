@@ -0,0 +1,69 @@
+/*!
+ * @file bench_compare.cpp
+ * @brief Equality and ordering of two large, almost identical vectors.
+ *
+ * The vectors differ only in their last element, so every comparison scans
+ * them whole, as a change-detection check does when nothing changed. The
+ * baseline is the element-by-element loop that operator== used to run.
+ */
+
+#include <algorithm>  // std::lexicographical_compare
+#include <cstdint>    // std::int32_t
+#include <string>     // std::to_string
+
+#include "bench.h"
+#include "vector.h"
+
+/// The element-by-element loop of the old operator==.
+template < typename V >
+bool loop_equal( const V & lhs, const V & rhs )
+{
+    if ( lhs.size() != rhs.size() )
+        return false;
+    for ( std::size_t i{0} ; i < lhs.size() ; i++ )
+        if ( lhs[i] != rhs[i] )
+            return false;
+    return true;
+}
+
+template < typename T >
+void run( const std::string & type, unsigned long n )
+{
+    sc::vector<T> a, b;
+    for ( unsigned long i{0} ; i < n ; ++i )
+    {
+        a.push_back( static_cast<T>( i % 1000 ) );
+        b.push_back( static_cast<T>( i % 1000 ) );
+    }
+    b[n - 1] = 1;
+
+    bench::header( "a == b, N = " + std::to_string( n ) + " " + type );
+    double base = bench::best_of( 5, [&]{ bench::do_not_optimize( loop_equal( a, b ) ); } );
+    bench::row( "element loop (old operator==)", base, base );
+    const char * names[] = { "operator==, scalar", "operator==, sse2", "operator==, avx2", "operator==, avx512" };
+    for ( auto lvl : { sc::simd::level::scalar, sc::simd::level::sse2, sc::simd::level::avx2, sc::simd::level::avx512 } )
+    {
+        if ( sc::simd::set_max_level( lvl ) != lvl ) continue;
+        bench::row( names[ static_cast<int>( lvl ) ], bench::best_of( 5, [&]{ bench::do_not_optimize( a == b ); } ), base );
+    }
+
+    bench::header( "a < b, N = " + std::to_string( n ) + " " + type );
+    base = bench::best_of( 5, [&]{
+        bench::do_not_optimize( std::lexicographical_compare( a.data(), a.data() + n, b.data(), b.data() + n ) ); } );
+    bench::row( "std::lexicographical_compare", base, base );
+    const char * less_names[] = { "operator<, scalar", "operator<, sse2", "operator<, avx2", "operator<, avx512" };
+    for ( auto lvl : { sc::simd::level::scalar, sc::simd::level::sse2, sc::simd::level::avx2, sc::simd::level::avx512 } )
+    {
+        if ( sc::simd::set_max_level( lvl ) != lvl ) continue;
+        bench::row( less_names[ static_cast<int>( lvl ) ], bench::best_of( 5, [&]{ bench::do_not_optimize( a < b ); } ), base );
+    }
+    sc::simd::set_max_level( sc::simd::level::avx512 );
+}
+
+int main( void )
+{
+    run< std::int32_t >( "int32", 1ul << 24 );
+    run< float >( "float", 1ul << 24 );
+    run< double >( "double", 1ul << 23 );
+    return 0;
+}
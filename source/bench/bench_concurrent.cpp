@@ -0,0 +1,79 @@
+/*!
+ * @file bench_concurrent.cpp
+ * @brief sc::concurrent_vector against a mutex-wrapped sc::vector, from 1 to 64 producer threads.
+ *
+ * T threads append 4M uint64_t in total (4M / T each) into one shared
+ * container: push_back under a std::mutex into sc::vector, lock-free
+ * push_back into sc::concurrent_vector, and grow_by in batches of 64. The
+ * maximum thread count is an optional argument (64 by default); on a
+ * machine with fewer cores the extra threads only measure contention.
+ */
+
+#include <cstdint>        // std::uint64_t
+#include <cstdlib>        // std::atoi
+#include <mutex>          // std::mutex, std::lock_guard
+#include <string>         // std::string
+#include <thread>         // std::thread
+#include <vector>         // std::vector
+
+#include "bench.h"
+#include "concurrent_vector.h"
+#include "vector.h"
+
+const int reps{ 3 };
+const std::size_t total{ std::size_t{1} << 22 };
+
+//* Runs work(thread index) on `threads` threads and waits for all of them.
+template < typename Work >
+void run_threads( unsigned threads, Work work )
+{
+    std::vector<std::thread> pool;
+    for ( unsigned t{0} ; t < threads ; ++t ) pool.emplace_back( work, t );
+    for ( auto & th : pool ) th.join();
+}
+
+int main( int argc, char * argv[] )
+{
+    unsigned max_threads{ argc > 1 ? static_cast<unsigned>( std::atoi( argv[1] ) ) : 64u };
+    if ( max_threads == 0 ) max_threads = 1;
+
+    for ( unsigned threads{1} ; threads <= max_threads ; threads *= 2 )
+    {
+        const std::size_t each{ total / threads };
+        bench::header( std::to_string( total ) + " appends from " + std::to_string( threads ) + " threads" );
+
+        sc::vector<std::uint64_t> locked;
+        std::mutex mutex;
+        double base = bench::best_of( reps, [&]{ locked = sc::vector<std::uint64_t>(); }, [&]{
+            run_threads( threads, [&]( unsigned t ) {
+                for ( std::size_t i{0} ; i < each ; ++i )
+                {
+                    std::lock_guard<std::mutex> lock( mutex );
+                    locked.push_back( t * each + i );
+                }
+            } );
+        } );
+        bench::row( "std::mutex + sc::vector::push_back", base, base );
+
+        bench::row( "sc::concurrent_vector::push_back", bench::best_of( reps, [&]{
+            sc::concurrent_vector<std::uint64_t> shared;
+            run_threads( threads, [&]( unsigned t ) {
+                for ( std::size_t i{0} ; i < each ; ++i ) shared.push_back( t * each + i );
+            } );
+            bench::do_not_optimize( shared.size() );
+        } ), base );
+
+        bench::row( "sc::concurrent_vector::grow_by(64)", bench::best_of( reps, [&]{
+            sc::concurrent_vector<std::uint64_t> shared;
+            run_threads( threads, [&]( unsigned t ) {
+                for ( std::size_t i{0} ; i < each ; i += 64 )
+                {
+                    auto first = shared.grow_by( 64 );
+                    for ( std::size_t j{0} ; j < 64 ; ++j ) shared[first + j] = t * each + i + j;
+                }
+            } );
+            bench::do_not_optimize( shared.size() );
+        } ), base );
+    }
+    return 0;
+}
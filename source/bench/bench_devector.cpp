@@ -0,0 +1,86 @@
+/*!
+ * @file bench_devector.cpp
+ * @brief sc::devector against sc::vector on front-heavy workloads.
+ *
+ * Three workloads on int elements: building N elements with insertions at
+ * the front (sc::vector::insert(begin(), x) against push_front), a sliding
+ * window of W elements that pushes at the back and drops at the front
+ * (erase(begin()) against pop_front), and a double-ended queue that
+ * alternates both ends.
+ */
+
+#include <string>         // std::string
+
+#include "bench.h"
+#include "devector.h"
+#include "vector.h"
+
+const int reps{ 3 };
+
+void front_insertions( std::size_t n )
+{
+    bench::header( "insert " + std::to_string( n ) + " ints at the front" );
+    double base = bench::best_of( reps, [&]{
+        sc::vector<int> v;
+        for ( std::size_t i{0} ; i < n ; ++i ) v.insert( v.begin(), int( i ) );
+        bench::do_not_optimize( v.data() );
+    } );
+    bench::row( "sc::vector::insert(begin(), x)", base, base );
+    bench::row( "sc::devector::push_front", bench::best_of( reps, [&]{
+        sc::devector<int> d;
+        for ( std::size_t i{0} ; i < n ; ++i ) d.push_front( int( i ) );
+        bench::do_not_optimize( d.data() );
+    } ), base );
+}
+
+void sliding_window( std::size_t window, std::size_t steps )
+{
+    bench::header( "sliding window of " + std::to_string( window ) + " ints, " + std::to_string( steps ) + " steps" );
+    double base = bench::best_of( reps, [&]{
+        sc::vector<int> v;
+        for ( std::size_t i{0} ; i < window ; ++i ) v.push_back( int( i ) );
+        for ( std::size_t i{0} ; i < steps ; ++i ) { v.erase( v.begin() ); v.push_back( int( i ) ); }
+        bench::do_not_optimize( v.data() );
+    } );
+    bench::row( "sc::vector, push_back + erase(begin())", base, base );
+    bench::row( "sc::devector, push_back + pop_front", bench::best_of( reps, [&]{
+        sc::devector<int> d;
+        for ( std::size_t i{0} ; i < window ; ++i ) d.push_back( int( i ) );
+        for ( std::size_t i{0} ; i < steps ; ++i ) { d.pop_front(); d.push_back( int( i ) ); }
+        bench::do_not_optimize( d.data() );
+    } ), base );
+}
+
+void both_ends( std::size_t n )
+{
+    bench::header( "alternate both ends, " + std::to_string( n ) + " ints" );
+    double base = bench::best_of( reps, [&]{
+        sc::vector<int> v;
+        for ( std::size_t i{0} ; i < n ; ++i )
+        {
+            if ( i % 2 ) v.push_back( int( i ) );
+            else v.insert( v.begin(), int( i ) );
+        }
+        bench::do_not_optimize( v.data() );
+    } );
+    bench::row( "sc::vector, push_back + insert(begin(), x)", base, base );
+    bench::row( "sc::devector, push_back + push_front", bench::best_of( reps, [&]{
+        sc::devector<int> d;
+        for ( std::size_t i{0} ; i < n ; ++i )
+        {
+            if ( i % 2 ) d.push_back( int( i ) );
+            else d.push_front( int( i ) );
+        }
+        bench::do_not_optimize( d.data() );
+    } ), base );
+}
+
+int main( void )
+{
+    for ( std::size_t n : { std::size_t{1000}, std::size_t{10000}, std::size_t{100000} } )
+        front_insertions( n );
+    for ( std::size_t w : { std::size_t{64}, std::size_t{4096}, std::size_t{65536} } )
+        sliding_window( w, 200000 );
+    both_ends( 100000 );
+    return 0;
+}
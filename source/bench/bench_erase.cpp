@@ -0,0 +1,78 @@
+/*!
+ * @file bench_erase.cpp
+ * @brief Filtering a large vector: erase() in a loop against one-pass compaction.
+ *
+ * The vector holds N random values in [0, 4), and we remove every 0: a quarter
+ * of the elements, in an order the branch predictor can not guess. The
+ * baseline is std::remove_if + erase(first, last). sc::erase_if() compacts
+ * branch-free, and sc::erase() is shown on each SIMD level. A loop of
+ * erase(pos) (quadratic) is timed on a much smaller input, for scale.
+ */
+
+#include <algorithm>  // std::remove_if
+#include <cstdint>    // std::int32_t
+#include <random>     // std::mt19937
+#include <string>     // std::to_string
+
+#include "bench.h"
+#include "compact.h"
+
+using value_t = std::int32_t;
+using vec_t = sc::vector< value_t >;
+
+/// A vector with n random values in [0, 4).
+vec_t make_input( unsigned long n )
+{
+    std::mt19937 gen{ 42 };
+    vec_t vec;
+    vec.reserve( n );
+    for ( unsigned long i{0} ; i < n ; ++i )
+        vec.push_back( static_cast<value_t>( gen() % 4 ) );
+    return vec;
+}
+
+/// Times f(vec) on a fresh copy of input.
+template < typename F >
+double time_filter( const vec_t & input, F f )
+{
+    vec_t vec;
+    return bench::best_of( 5, [&]{ vec = input; }, [&]{ f( vec ); bench::do_not_optimize( vec.data() ); } );
+}
+
+int main( void )
+{
+    const unsigned long small{ 1ul << 15 };
+    vec_t input = make_input( small );
+    bench::header( "remove the zeros from N = " + std::to_string( small ) + " int32" );
+    double base = time_filter( input, []( vec_t & v ) {
+        auto first = v.data(), last = v.data() + v.size();
+        v.erase( v.begin() + ( std::remove_if( first, last, []( value_t x ) { return x == 0; } ) - first ), v.end() );
+    } );
+    bench::row( "std::remove_if + erase(first, last)", base, base );
+    bench::row( "erase(pos) in a loop", time_filter( input, []( vec_t & v ) {
+        for ( auto i{ v.size() } ; i > 0 ; --i )
+            if ( v[i - 1] == 0 ) v.erase( v.begin() + ( i - 1 ) );
+    } ), base );
+
+    for ( unsigned long n : { 1ul << 20, 1ul << 24 } )
+    {
+        input = make_input( n );
+        bench::header( "remove the zeros from N = " + std::to_string( n ) + " int32" );
+        base = time_filter( input, []( vec_t & v ) {
+            auto first = v.data(), last = v.data() + v.size();
+            v.erase( v.begin() + ( std::remove_if( first, last, []( value_t x ) { return x == 0; } ) - first ), v.end() );
+        } );
+        bench::row( "std::remove_if + erase(first, last)", base, base );
+        bench::row( "sc::erase_if (branch-free)", time_filter( input, []( vec_t & v ) {
+            sc::erase_if( v, []( value_t x ) { return x == 0; } );
+        } ), base );
+        const char * names[] = { "sc::erase, scalar", "sc::erase, sse2", "sc::erase, avx2", "sc::erase, avx512" };
+        for ( auto lvl : { sc::simd::level::scalar, sc::simd::level::avx2, sc::simd::level::avx512 } )
+        {
+            if ( sc::simd::set_max_level( lvl ) != lvl ) continue;
+            bench::row( names[ static_cast<int>( lvl ) ], time_filter( input, []( vec_t & v ) { sc::erase( v, 0 ); } ), base );
+        }
+        sc::simd::set_max_level( sc::simd::level::avx512 );
+    }
+    return 0;
+}
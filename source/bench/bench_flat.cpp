@@ -0,0 +1,110 @@
+/*!
+ * @file bench_flat.cpp
+ * @brief sc::flat_map against std::map and std::unordered_map on read-heavy workloads.
+ *
+ * For N random uint64_t keys (1K, 64K, 1M) each map is built from the whole
+ * batch, then probed with 4M lookups, half of them hits. The mixed case runs
+ * 4M operations with one insertion every R lookups (R = 10, 100, 1000),
+ * starting from N = 64K entries: single insertions shift the flat arrays, so
+ * flat_map only wins once reads dominate.
+ */
+
+#include <cstdint>        // std::uint64_t
+#include <map>            // std::map
+#include <string>         // std::string
+#include <unordered_map>  // std::unordered_map
+#include <utility>        // std::pair
+#include <vector>         // std::vector
+
+#include "bench.h"
+#include "flat_map.h"
+
+const int reps{ 3 };
+const std::size_t lookups{ std::size_t{1} << 22 };
+
+std::uint64_t next( std::uint64_t & seed )
+{
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    return seed ^ ( seed >> 29 );
+}
+
+template < typename Map >
+std::size_t probe( const Map & m, const std::vector<std::uint64_t> & queries )
+{
+    std::size_t hits{0};
+    for ( std::uint64_t q : queries ) hits += m.find( q ) != m.end();
+    return hits;
+}
+
+void read_only( std::size_t n )
+{
+    std::uint64_t seed{ 1 };
+    std::vector< std::pair<std::uint64_t, std::uint64_t> > batch;
+    for ( std::size_t i{0} ; i < n ; ++i ) batch.push_back( std::make_pair( next( seed ), i ) );
+    std::vector<std::uint64_t> queries;
+    for ( std::size_t i{0} ; i < lookups ; ++i )
+        queries.push_back( i % 2 ? batch[ next( seed ) % n ].first : next( seed ) );
+
+    std::map<std::uint64_t, std::uint64_t> tree;
+    std::unordered_map<std::uint64_t, std::uint64_t> hash;
+    sc::flat_map<std::uint64_t, std::uint64_t> flat;
+
+    bench::header( "build from a batch, N = " + std::to_string( n ) );
+    double base = bench::best_of( reps, [&]{ tree.clear(); }, [&]{ tree.insert( batch.begin(), batch.end() ); } );
+    bench::row( "std::map::insert(first, last)", base, base );
+    bench::row( "std::unordered_map::insert(first, last)",
+                bench::best_of( reps, [&]{ hash.clear(); }, [&]{ hash.insert( batch.begin(), batch.end() ); } ), base );
+    bench::row( "sc::flat_map::insert(first, last)",
+                bench::best_of( reps, [&]{ flat.clear(); }, [&]{ flat.insert( batch.begin(), batch.end() ); } ), base );
+
+    bench::header( std::to_string( lookups ) + " lookups (half hits), N = " + std::to_string( n ) );
+    base = bench::best_of( reps, [&]{ bench::do_not_optimize( probe( tree, queries ) ); } );
+    bench::row( "std::map::find", base, base );
+    bench::row( "std::unordered_map::find", bench::best_of( reps, [&]{ bench::do_not_optimize( probe( hash, queries ) ); } ), base );
+    bench::row( "sc::flat_map::find", bench::best_of( reps, [&]{ bench::do_not_optimize( probe( flat, queries ) ); } ), base );
+}
+
+template < typename Map >
+std::size_t mixed( Map & m, const std::vector<std::uint64_t> & ops, std::size_t ratio )
+{
+    std::size_t hits{0};
+    for ( std::size_t i{0} ; i < ops.size() ; ++i )
+    {
+        if ( i % ( ratio + 1 ) == ratio ) m.insert( std::make_pair( ops[i], i ) );
+        else hits += m.find( ops[i] ) != m.end();
+    }
+    return hits;
+}
+
+void read_mostly( std::size_t n, std::size_t ratio )
+{
+    std::uint64_t seed{ 2 };
+    std::vector< std::pair<std::uint64_t, std::uint64_t> > batch;
+    for ( std::size_t i{0} ; i < n ; ++i ) batch.push_back( std::make_pair( next( seed ), i ) );
+    std::vector<std::uint64_t> ops;
+    for ( std::size_t i{0} ; i < lookups ; ++i )
+        ops.push_back( i % 2 ? batch[ next( seed ) % n ].first : next( seed ) );
+
+    std::map<std::uint64_t, std::uint64_t> tree;
+    std::unordered_map<std::uint64_t, std::uint64_t> hash;
+    sc::flat_map<std::uint64_t, std::uint64_t> flat;
+
+    bench::header( "1 insert per " + std::to_string( ratio ) + " lookups, " + std::to_string( lookups ) +
+                   " operations from N = " + std::to_string( n ) );
+    double base = bench::best_of( reps, [&]{ tree.clear(); tree.insert( batch.begin(), batch.end() ); },
+                                  [&]{ bench::do_not_optimize( mixed( tree, ops, ratio ) ); } );
+    bench::row( "std::map", base, base );
+    bench::row( "std::unordered_map", bench::best_of( reps, [&]{ hash.clear(); hash.insert( batch.begin(), batch.end() ); },
+                                                      [&]{ bench::do_not_optimize( mixed( hash, ops, ratio ) ); } ), base );
+    bench::row( "sc::flat_map", bench::best_of( reps, [&]{ flat.clear(); flat.insert( batch.begin(), batch.end() ); },
+                                                [&]{ bench::do_not_optimize( mixed( flat, ops, ratio ) ); } ), base );
+}
+
+int main( void )
+{
+    for ( std::size_t n : { std::size_t{1000}, std::size_t{1} << 16, std::size_t{1000000} } )
+        read_only( n );
+    for ( std::size_t ratio : { std::size_t{10}, std::size_t{100}, std::size_t{1000} } )
+        read_mostly( std::size_t{1} << 16, ratio );
+    return 0;
+}
@@ -0,0 +1,72 @@
+/*!
+ * @file bench_growth.cpp
+ * @brief Growth time of a large sc::vector: copy-based reserve() against realloc() and mremap().
+ *
+ * For each size N, the vector starts with N elements and capacity N, and we
+ * time a single reserve(2N). Then we time N push_backs from an empty vector,
+ * which includes every intermediate growth step.
+ */
+
+#include <cstdint>    // std::uint64_t
+#include <string>     // std::to_string
+
+#include "bench.h"
+#include "vector.h"
+#include "allocator.h"
+#include "mmap_allocator.h"
+
+using value_t = std::uint64_t;
+using std_vector = sc::vector< value_t >;
+using malloc_vector = sc::vector< value_t, sc::malloc_allocator<value_t> >;
+using mmap_vector = sc::vector< value_t, sc::mmap_allocator<value_t> >;
+
+/// Times reserve(2N) on a full vector of N elements.
+template < typename Vector >
+double time_reserve( unsigned long n )
+{
+    Vector vec;
+    return bench::best_of( 5,
+        [&]{
+            vec = Vector{};
+            vec.reserve( n );
+            for ( unsigned long i{0} ; i < n ; ++i )
+                vec.push_back( i );
+        },
+        [&]{
+            vec.reserve( 2 * n );
+            bench::do_not_optimize( vec.data() );
+        } );
+}
+
+/// Times n push_backs from an empty vector.
+template < typename Vector >
+double time_push_back( unsigned long n )
+{
+    return bench::best_of( 3, [&]{
+            Vector vec;
+            for ( unsigned long i{0} ; i < n ; ++i )
+                vec.push_back( i );
+            bench::do_not_optimize( vec.data() );
+        } );
+}
+
+int main( void )
+{
+    for ( unsigned long n : { 1ul << 20, 1ul << 23, 1ul << 26 } )
+    {
+        std::string mib = std::to_string( n * sizeof(value_t) >> 20 ) + " MiB";
+
+        bench::header( "reserve(2N) with N = " + std::to_string( n ) + " (" + mib + ")" );
+        double base = time_reserve< std_vector >( n );
+        bench::row( "std::allocator (allocate + memcpy + free)", base, base );
+        bench::row( "sc::malloc_allocator (realloc)", time_reserve< malloc_vector >( n ), base );
+        bench::row( "sc::mmap_allocator (mremap)", time_reserve< mmap_vector >( n ), base );
+
+        bench::header( "N push_backs from empty, N = " + std::to_string( n ) );
+        base = time_push_back< std_vector >( n );
+        bench::row( "std::allocator", base, base );
+        bench::row( "sc::malloc_allocator", time_push_back< malloc_vector >( n ), base );
+        bench::row( "sc::mmap_allocator", time_push_back< mmap_vector >( n ), base );
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+/*!
+ * @file bench_insert.cpp
+ * @brief Range insert into a full vector, at the front, middle and back.
+ *
+ * The vector starts with N elements and capacity N, so the insertion has to
+ * grow it. The baseline reproduces the old two-pass strategy: reserve() copies
+ * the whole buffer, then the insertion shifts the suffix a second time.
+ * sc::vector::insert() now builds the new buffer in one pass (prefix, new
+ * elements, suffix). std::vector is shown for reference.
+ */
+
+#include <cstdint>    // std::uint64_t
+#include <string>     // std::string, std::to_string
+#include <vector>     // std::vector
+
+#include "bench.h"
+#include "vector.h"
+
+/// Times the insertion of k elements at index (size * where) of a full vector of n elements.
+template < typename Vector, bool TwoPass >
+double time_insert( unsigned long n, unsigned long k, double where, const typename Vector::value_type & value )
+{
+    Vector vec;
+    Vector extra;
+    extra.assign( k, value );
+    return bench::best_of( 7,
+        [&]{
+            vec = Vector{};
+            vec.assign( n, value );
+            vec.shrink_to_fit();
+        },
+        [&]{
+            auto pos = vec.begin() + static_cast<long>( vec.size() * where );
+            if ( TwoPass )
+            {
+                auto offset = pos - vec.begin();
+                vec.reserve( 2 * vec.size() );
+                pos = vec.begin() + offset;
+            }
+            vec.insert( pos, extra.begin(), extra.end() );
+            bench::do_not_optimize( vec.data() );
+        } );
+}
+
+template < typename T >
+void run( const std::string & type, unsigned long n, const T & value )
+{
+    const unsigned long k{ 16 };
+    const char * names[] = { "front", "middle", "back" };
+    const double where[] = { 0.0, 0.5, 1.0 };
+    for ( int w{0} ; w < 3 ; ++w )
+    {
+        bench::header( std::string( names[w] ) + " insert of " + std::to_string( k ) + " " + type
+                       + " into a full vector of " + std::to_string( n ) );
+        double base = time_insert< sc::vector<T>, true >( n, k, where[w], value );
+        bench::row( "reserve() then insert (two passes)", base, base );
+        bench::row( "sc::vector::insert (one pass)", time_insert< sc::vector<T>, false >( n, k, where[w], value ), base );
+        bench::row( "std::vector::insert", time_insert< std::vector<T>, false >( n, k, where[w], value ), base );
+    }
+}
+
+int main( void )
+{
+    run< std::uint64_t >( "uint64_t", 1ul << 22, 42 );
+    run< std::string >( "std::string", 1ul << 20, std::string( 32, 'x' ) );
+    return 0;
+}
@@ -0,0 +1,97 @@
+/*!
+ * @file bench_kernels.cpp
+ * @brief sc::kernels against hand-written loops and the <algorithm>/<numeric> functions.
+ *
+ * For float and int32 vectors of N elements (a few MiB, so they live in the
+ * last-level cache) each kernel is timed against a loop over begin()/end(),
+ * the standard algorithm over begin()/end(), and its own scalar version.
+ * find and contains look for a value that is absent, so the whole vector is scanned.
+ */
+
+#include <algorithm>  // std::find, std::count, std::minmax_element
+#include <cstdint>    // std::int32_t
+#include <numeric>    // std::accumulate, std::inner_product
+#include <string>     // std::string
+
+#include "bench.h"
+#include "vector.h"
+#include "kernels.h"
+
+const int reps{ 20 };
+
+/// Times kernel(vec) on every SIMD level the machine has.
+template < typename F >
+void levels( const std::string & name, F kernel, double base )
+{
+    const char * suffix[] = { " (scalar)", " (sse2)", " (avx2)", " (avx512)" };
+    for ( auto lvl : { sc::simd::level::scalar, sc::simd::level::sse2, sc::simd::level::avx2, sc::simd::level::avx512 } )
+    {
+        if ( sc::simd::set_max_level( lvl ) != lvl ) continue;
+        bench::row( name + suffix[ static_cast<int>( lvl ) ], bench::best_of( reps, kernel ), base );
+    }
+    sc::simd::set_max_level( sc::simd::level::avx512 );
+}
+
+template < typename T >
+void run( const std::string & type, unsigned long n )
+{
+    sc::vector<T> a, b;
+    for ( unsigned long i{0} ; i < n ; ++i )
+    {
+        a.push_back( static_cast<T>( i % 1000 ) );
+        b.push_back( static_cast<T>( i % 7 ) );
+    }
+    const T absent = static_cast<T>( -1 );
+
+    bench::header( "sum, N = " + std::to_string( n ) + " " + type );
+    double base = bench::best_of( reps, [&]{
+        T s{0};
+        for ( auto it = a.begin() ; it != a.end() ; ++it ) s += *it;
+        bench::do_not_optimize( s ); } );
+    bench::row( "loop over begin()/end()", base, base );
+    bench::row( "std::accumulate", bench::best_of( reps, [&]{ bench::do_not_optimize( std::accumulate( a.begin(), a.end(), T{0} ) ); } ), base );
+    levels( "kernels::sum", [&]{ bench::do_not_optimize( sc::kernels::sum( a ) ); }, base );
+
+    bench::header( "dot, N = " + std::to_string( n ) + " " + type );
+    base = bench::best_of( reps, [&]{
+        T s{0};
+        for ( std::size_t i{0} ; i < n ; ++i ) s += a[i] * b[i];
+        bench::do_not_optimize( s ); } );
+    bench::row( "loop with operator[]", base, base );
+    bench::row( "std::inner_product", bench::best_of( reps, [&]{ bench::do_not_optimize( std::inner_product( a.begin(), a.end(), b.begin(), T{0} ) ); } ), base );
+    levels( "kernels::dot", [&]{ bench::do_not_optimize( sc::kernels::dot( a, b ) ); }, base );
+
+    bench::header( "minmax, N = " + std::to_string( n ) + " " + type );
+    base = bench::best_of( reps, [&]{
+        T lo{a[0]}, hi{a[0]};
+        for ( auto it = a.begin() ; it != a.end() ; ++it ) { if ( *it < lo ) lo = *it; if ( hi < *it ) hi = *it; }
+        bench::do_not_optimize( lo ); bench::do_not_optimize( hi ); } );
+    bench::row( "loop over begin()/end()", base, base );
+    bench::row( "std::minmax_element", bench::best_of( reps, [&]{ bench::do_not_optimize( *std::minmax_element( a.begin(), a.end() ).first ); } ), base );
+    levels( "kernels::minmax", [&]{ bench::do_not_optimize( sc::kernels::minmax( a ).first ); }, base );
+
+    bench::header( "find (absent), N = " + std::to_string( n ) + " " + type );
+    base = bench::best_of( reps, [&]{
+        auto it = a.begin();
+        while ( it != a.end() and *it != absent ) ++it;
+        bench::do_not_optimize( it ); } );
+    bench::row( "loop over begin()/end()", base, base );
+    bench::row( "std::find", bench::best_of( reps, [&]{ bench::do_not_optimize( std::find( a.begin(), a.end(), absent ) ); } ), base );
+    levels( "kernels::find", [&]{ bench::do_not_optimize( sc::kernels::find( a, absent ) ); }, base );
+
+    bench::header( "count, N = " + std::to_string( n ) + " " + type );
+    base = bench::best_of( reps, [&]{
+        std::size_t c{0};
+        for ( auto it = b.begin() ; it != b.end() ; ++it ) c += *it == T{3};
+        bench::do_not_optimize( c ); } );
+    bench::row( "loop over begin()/end()", base, base );
+    bench::row( "std::count", bench::best_of( reps, [&]{ bench::do_not_optimize( std::count( b.begin(), b.end(), T{3} ) ); } ), base );
+    levels( "kernels::count", [&]{ bench::do_not_optimize( sc::kernels::count( b, T{3} ) ); }, base );
+}
+
+int main( void )
+{
+    run< float >( "float", 1ul << 20 );
+    run< std::int32_t >( "int32", 1ul << 20 );
+    return 0;
+}
@@ -0,0 +1,92 @@
+/*!
+ * @file bench_packed.cpp
+ * @brief sc::packed_int_vector and sc::delta_packed_vector against sc::vector: memory and scans.
+ *
+ * Sorted 32- and 64-bit IDs with small random gaps, and small counters. For
+ * each, the table shows the bytes held by every form and the time to sum all
+ * elements: sc::vector with a plain loop, packed_int_vector by index and
+ * through decode(), and delta_packed_vector through for_each_block() on every
+ * SIMD level the machine has.
+ */
+
+#include <cstdint>    // std::uint32_t, std::uint64_t
+#include <string>     // std::string
+
+#include "bench.h"
+#include "packed_int_vector.h"
+#include "vector.h"
+
+const int reps{ 10 };
+
+template < typename T >
+void run( const std::string & name, const sc::vector<T> & plain )
+{
+    std::size_t n{ plain.size() };
+    sc::packed_int_vector<T> packed( plain );
+    sc::delta_packed_vector<T> delta( plain );
+
+    bench::header( name + ", N = " + std::to_string( n ) );
+    std::printf( "%-44s %12.2f\n", "sc::vector (MiB)", plain.capacity() * sizeof( T ) / 1048576.0 );
+    std::printf( "%-44s %12.2f  (width %u)\n", "sc::packed_int_vector (MiB)", packed.bytes() / 1048576.0, packed.width() );
+    std::printf( "%-44s %12.2f\n", "sc::delta_packed_vector (MiB)", delta.bytes() / 1048576.0 );
+
+    double base = bench::best_of( reps, [&]{
+        std::uint64_t sum{0};
+        for ( std::size_t i{0} ; i < n ; ++i ) sum += plain[i];
+        bench::do_not_optimize( sum );
+    } );
+    bench::row( "sum, sc::vector", base, base );
+    bench::row( "sum, packed_int_vector, operator[]", bench::best_of( reps, [&]{
+        std::uint64_t sum{0};
+        for ( std::size_t i{0} ; i < n ; ++i ) sum += packed[i];
+        bench::do_not_optimize( sum );
+    } ), base );
+    bench::row( "sum, packed_int_vector, decode()", bench::best_of( reps, [&]{
+        T buffer[1024];
+        std::uint64_t sum{0};
+        for ( std::size_t first{0} ; first < n ; first += 1024 )
+        {
+            std::size_t count{ n - first < 1024 ? n - first : 1024 };
+            packed.decode( first, count, buffer );
+            for ( std::size_t i{0} ; i < count ; ++i ) sum += buffer[i];
+        }
+        bench::do_not_optimize( sum );
+    } ), base );
+
+    const char * suffix[] = { " (scalar)", " (sse2)", " (avx2)", " (avx512)" };
+    for ( auto lvl : { sc::simd::level::scalar, sc::simd::level::sse2, sc::simd::level::avx2, sc::simd::level::avx512 } )
+    {
+        if ( sc::simd::set_max_level( lvl ) != lvl ) continue;
+        bench::row( std::string( "sum, delta_packed_vector" ) + suffix[ static_cast<int>( lvl ) ], bench::best_of( reps, [&]{
+            std::uint64_t sum{0};
+            delta.for_each_block( [&]( const T * values, std::size_t count ) {
+                for ( std::size_t i{0} ; i < count ; ++i ) sum += values[i];
+            } );
+            bench::do_not_optimize( sum );
+        } ), base );
+    }
+    sc::simd::set_max_level( sc::simd::level::avx512 );
+}
+
+int main( void )
+{
+    const std::size_t n{ std::size_t{1} << 24 };
+    std::uint64_t x{ 88172645463325252ull };
+    auto next = [&x]{ x ^= x << 13; x ^= x >> 7; x ^= x << 17; return x; };
+
+    sc::vector<std::uint32_t> ids32;
+    sc::vector<std::uint64_t> ids64;
+    sc::vector<std::uint32_t> counters;
+    std::uint64_t id{ 1000000 };
+    for ( std::size_t i{0} ; i < n ; ++i )
+    {
+        id += 1 + next() % 16;
+        ids32.push_back( static_cast<std::uint32_t>( id ) );
+        ids64.push_back( id << 20 );
+        counters.push_back( static_cast<std::uint32_t>( next() % 1000 ) );
+    }
+    run( "sorted uint32_t IDs, gaps of 1..16", ids32 );
+    run( "sorted uint64_t IDs, gaps of 1..16 << 20", ids64 );
+    run( "uint32_t counters below 1000", counters );
+    return 0;
+}
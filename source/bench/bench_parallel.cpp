@@ -0,0 +1,76 @@
+/*!
+ * @file bench_parallel.cpp
+ * @brief sc::parallel algorithms against the serial <algorithm>/<numeric> functions, per thread count.
+ *
+ * A vector of N doubles (N = 2^25, 256 MiB, far beyond the caches) goes through
+ * fill, copy, transform, for_each, reduce and inclusive_scan, serially and then
+ * on pools of 1, 2, 4, ... threads up to the hardware concurrency. The memory
+ * bound algorithms (fill, copy) stop scaling once the memory bandwidth is used
+ * up; transform with a costly op scales with the cores.
+ * The thread counts can be forced with the first argument: bench_parallel 64.
+ */
+
+#include <algorithm>  // std::fill, std::copy, std::transform, std::for_each
+#include <cmath>      // std::sqrt
+#include <cstdlib>    // std::atoi
+#include <memory>     // std::unique_ptr
+#include <numeric>    // std::accumulate, std::partial_sum
+#include <string>     // std::string
+#include <thread>     // std::thread::hardware_concurrency
+
+#include "bench.h"
+#include "vector.h"
+#include "parallel.h"
+
+const int reps{ 5 };
+
+int main( int argc, char * argv[] )
+{
+    const std::size_t n{ std::size_t{1} << 25 };
+    unsigned max_threads{ argc > 1 ? static_cast<unsigned>( std::atoi( argv[1] ) ) : std::thread::hardware_concurrency() };
+    if ( max_threads == 0 ) max_threads = 1;
+
+    sc::vector<double> a, b;
+    a.assign( n, 1.0 );
+    b.assign( n, 0.0 );
+    auto costly = []( double x ) { return std::sqrt( x * x + 1.0 ) / ( x + 2.0 ); };
+
+    // Serial baselines.
+    double fill_base = bench::best_of( reps, [&]{ std::fill( a.begin(), a.end(), 2.0 ); } );
+    double copy_base = bench::best_of( reps, [&]{ std::copy( a.data(), a.data() + n, b.data() ); } );
+    double transform_base = bench::best_of( reps, [&]{ std::transform( a.data(), a.data() + n, b.data(), costly ); } );
+    double for_each_base = bench::best_of( reps, [&]{ std::for_each( b.data(), b.data() + n, []( double & x ) { x += 1.0; } ); } );
+    double reduce_base = bench::best_of( reps, [&]{ bench::do_not_optimize( std::accumulate( a.data(), a.data() + n, 0.0 ) ); } );
+    double scan_base = bench::best_of( reps, [&]{ std::partial_sum( a.data(), a.data() + n, b.data() ); } );
+
+    struct timing { std::string name; double base; double ms[32]; };
+    timing rows[] = { { "fill", fill_base, {} }, { "copy", copy_base, {} }, { "transform (sqrt, div)", transform_base, {} },
+                      { "for_each", for_each_base, {} }, { "reduce", reduce_base, {} }, { "inclusive_scan", scan_base, {} } };
+
+    int runs{ 0 };
+    unsigned counts[32];
+    for ( unsigned threads{1} ; runs < 32 ; threads *= 2 )
+    {
+        if ( threads > max_threads ) threads = max_threads;
+        counts[runs] = threads;
+        sc::thread_pool pool( threads );
+        sc::parallel::options opt( pool );
+        rows[0].ms[runs] = bench::best_of( reps, [&]{ sc::parallel::fill( a, 2.0, opt ); } );
+        rows[1].ms[runs] = bench::best_of( reps, [&]{ sc::parallel::copy( a, b, opt ); } );
+        rows[2].ms[runs] = bench::best_of( reps, [&]{ sc::parallel::transform( a, b, costly, opt ); } );
+        rows[3].ms[runs] = bench::best_of( reps, [&]{ sc::parallel::for_each( b, []( double & x ) { x += 1.0; }, opt ); } );
+        rows[4].ms[runs] = bench::best_of( reps, [&]{ bench::do_not_optimize( sc::parallel::reduce( a, 0.0, opt ) ); } );
+        rows[5].ms[runs] = bench::best_of( reps, [&]{ sc::parallel::inclusive_scan( a, b, opt ); } );
+        ++runs;
+        if ( threads == max_threads ) break;
+    }
+
+    for ( const timing & t : rows )
+    {
+        bench::header( t.name + ", N = " + std::to_string( n ) + " double" );
+        bench::row( "serial", t.base, t.base );
+        for ( int r{0} ; r < runs ; ++r )
+            bench::row( "sc::parallel, " + std::to_string( counts[r] ) + " thread(s)", t.ms[r], t.base );
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+/*!
+ * @file bench_segmented.cpp
+ * @brief sc::segmented_vector against sc::vector: growth spikes, indexing and scans.
+ *
+ * Appending N elements one by one, sc::vector now and then relocates all of
+ * them, so the slowest push_back grows with N; sc::segmented_vector only
+ * allocates a new chunk. The scans show what the chunk directory costs on
+ * reads: indexing pays a shift and a count-leading-zeros per element, while
+ * iterators and for_each_chunk() walk each chunk as a plain array.
+ */
+
+#include <chrono>         // std::chrono
+#include <cstdint>        // std::uint64_t
+#include <string>         // std::string
+
+#include "bench.h"
+#include "segmented_vector.h"
+#include "vector.h"
+
+const int reps{ 3 };
+
+//* Appends n elements and returns the slowest push_back, in microseconds.
+template < typename Container >
+double worst_push_back( Container & c, std::size_t n )
+{
+    double worst{0};
+    for ( std::size_t i{0} ; i < n ; ++i )
+    {
+        auto start = std::chrono::steady_clock::now();
+        c.push_back( i );
+        auto stop = std::chrono::steady_clock::now();
+        double us = std::chrono::duration<double, std::micro>( stop - start ).count();
+        if ( us > worst ) worst = us;
+    }
+    return worst;
+}
+
+void growth( std::size_t n )
+{
+    bench::header( "push_back of " + std::to_string( n ) + " uint64_t" );
+    sc::vector<std::uint64_t> vec;
+    sc::segmented_vector<std::uint64_t> seg;
+    double base = bench::best_of( reps, [&]{ vec = sc::vector<std::uint64_t>(); },
+                                  [&]{ for ( std::size_t i{0} ; i < n ; ++i ) vec.push_back( i ); } );
+    bench::row( "sc::vector", base, base );
+    bench::row( "sc::segmented_vector", bench::best_of( reps, [&]{ seg = sc::segmented_vector<std::uint64_t>(); },
+                                                        [&]{ for ( std::size_t i{0} ; i < n ; ++i ) seg.push_back( i ); } ), base );
+
+    sc::vector<std::uint64_t> vec2;
+    sc::segmented_vector<std::uint64_t> seg2;
+    double vec_worst = worst_push_back( vec2, n );
+    double seg_worst = worst_push_back( seg2, n );
+    std::printf( "%-44s %12.1f\n", "slowest push_back, sc::vector (us)", vec_worst );
+    std::printf( "%-44s %12.1f\n", "slowest push_back, sc::segmented_vector (us)", seg_worst );
+}
+
+void scans( std::size_t n )
+{
+    sc::vector<std::uint64_t> vec;
+    sc::segmented_vector<std::uint64_t> seg;
+    for ( std::size_t i{0} ; i < n ; ++i ) { vec.push_back( i ); seg.push_back( i ); }
+
+    bench::header( "sum of " + std::to_string( n ) + " uint64_t" );
+    double base = bench::best_of( reps, [&]{
+        std::uint64_t sum{0};
+        for ( std::size_t i{0} ; i < n ; ++i ) sum += vec[i];
+        bench::do_not_optimize( sum );
+    } );
+    bench::row( "sc::vector, operator[]", base, base );
+    bench::row( "sc::segmented_vector, operator[]", bench::best_of( reps, [&]{
+        std::uint64_t sum{0};
+        for ( std::size_t i{0} ; i < n ; ++i ) sum += seg[i];
+        bench::do_not_optimize( sum );
+    } ), base );
+    bench::row( "sc::segmented_vector, iterators", bench::best_of( reps, [&]{
+        std::uint64_t sum{0};
+        for ( std::uint64_t v : seg ) sum += v;
+        bench::do_not_optimize( sum );
+    } ), base );
+    bench::row( "sc::segmented_vector, for_each_chunk", bench::best_of( reps, [&]{
+        std::uint64_t sum{0};
+        seg.for_each_chunk( [&]( sc::span<const std::uint64_t> c ) {
+            for ( std::size_t i{0} ; i < c.size() ; ++i ) sum += c[i];
+        } );
+        bench::do_not_optimize( sum );
+    } ), base );
+}
+
+int main( void )
+{
+    for ( std::size_t n : { std::size_t{1} << 20, std::size_t{1} << 24 } )
+    {
+        growth( n );
+        scans( n );
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+/*!
+ * @file bench_soa.cpp
+ * @brief sc::soa_vector column scans against the same records in a sc::vector of structs.
+ *
+ * Each record is a 64-byte particle (position, velocity, mass, id, padding).
+ * A scan that touches one or two fields reads the whole struct through the
+ * cache in the array-of-structs layout, but only those columns in
+ * sc::soa_vector, so the scan runs at memory bandwidth and vectorizes.
+ */
+
+#include <cstdint>        // std::uint32_t
+
+#include "bench.h"
+#include "soa_vector.h"
+#include "vector.h"
+
+const int reps{ 5 };
+
+struct particle
+{
+    float x, y, z;
+    float vx, vy, vz;
+    float mass;
+    std::uint32_t id;
+    float pad[8];
+};
+
+using particles = sc::soa_vector<float, float, float, float, float, float, float, std::uint32_t>;
+
+void scans( std::size_t n )
+{
+    sc::vector<particle> aos;
+    aos.reserve( n );
+    particles soa;
+    soa.reserve( n );
+    for ( std::size_t i{0} ; i < n ; ++i )
+    {
+        float f = static_cast<float>( i % 1000 );
+        particle p{ f, f, f, 1.f, 1.f, 1.f, f * 0.5f, static_cast<std::uint32_t>( i ), {} };
+        aos.push_back( p );
+        soa.push_back( f, f, f, 1.f, 1.f, 1.f, f * 0.5f, static_cast<std::uint32_t>( i ) );
+    }
+
+    bench::header( "sum of one field, N = " + std::to_string( n ) );
+    double base = bench::best_of( reps, [&]{
+        float sum{0};
+        for ( std::size_t i{0} ; i < n ; ++i ) sum += aos[i].mass;
+        bench::do_not_optimize( sum );
+    } );
+    bench::row( "sc::vector<particle>, p.mass", base, base );
+    bench::row( "sc::soa_vector, column<6>()", bench::best_of( reps, [&]{
+        sc::span<const float> mass = static_cast<const particles &>( soa ).column<6>();
+        float sum{0};
+        for ( std::size_t i{0} ; i < mass.size() ; ++i ) sum += mass[i];
+        bench::do_not_optimize( sum );
+    } ), base );
+
+    bench::header( "x += vx * dt, N = " + std::to_string( n ) );
+    base = bench::best_of( reps, [&]{
+        particle *p = aos.data();
+        for ( std::size_t i{0} ; i < n ; ++i ) p[i].x += p[i].vx * 0.01f;
+        bench::do_not_optimize( p[0] );
+    } );
+    bench::row( "sc::vector<particle>", base, base );
+    bench::row( "sc::soa_vector, column<0>() and column<3>()", bench::best_of( reps, [&]{
+        sc::span<float> x = soa.column<0>();
+        sc::span<float> vx = soa.column<3>();
+        for ( std::size_t i{0} ; i < x.size() ; ++i ) x[i] += vx[i] * 0.01f;
+        bench::do_not_optimize( x[0] );
+    } ), base );
+}
+
+int main( void )
+{
+    for ( std::size_t n : { std::size_t{1} << 16, std::size_t{1} << 22 } )
+        scans( n );
+    return 0;
+}
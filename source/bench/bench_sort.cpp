@@ -0,0 +1,73 @@
+/*!
+ * @file bench_sort.cpp
+ * @brief sc::sort and sc::radix_sort against std::sort and std::stable_sort.
+ *
+ * Random uint64_t keys at N = 1M, 10M and 100M, and (uint64_t, uint64_t)
+ * pairs sorted by their first member at 1M and 10M. Pairs stop at 10M: at
+ * 100M the input, its pristine copy and the scratch buffer take 4.8 GB.
+ * The merge sort runs on the shared pool (hardware concurrency, or $SC_THREADS).
+ * Sizes can be capped with the first argument, e.g. bench_sort 10000000.
+ */
+
+#include <algorithm>  // std::sort, std::stable_sort
+#include <cstdint>    // std::uint64_t
+#include <cstdlib>    // std::atol
+#include <string>     // std::string
+#include <utility>    // std::pair
+
+#include "bench.h"
+#include "vector.h"
+#include "sort.h"
+
+/// Same data on every run.
+std::uint64_t next( std::uint64_t & seed )
+{
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    return seed ^ ( seed >> 29 );
+}
+
+void keys( std::size_t n )
+{
+    const int reps{ n > 50000000 ? 1 : 3 };
+    sc::vector<std::uint64_t> pristine, v;
+    std::uint64_t seed{ 1 };
+    for ( std::size_t i{0} ; i < n ; ++i ) pristine.push_back( next( seed ) );
+    auto reset = [&]{ v = pristine; };
+
+    bench::header( "uint64_t keys, N = " + std::to_string( n ) );
+    double base = bench::best_of( reps, reset, [&]{ std::sort( v.data(), v.data() + n ); } );
+    bench::row( "std::sort", base, base );
+    bench::row( "sc::sort (radix)", bench::best_of( reps, reset, [&]{ sc::sort( v ); } ), base );
+    bench::row( "sc::sort with std::less (parallel merge)",
+                bench::best_of( reps, reset, [&]{ sc::sort( v, std::less<std::uint64_t>() ); } ), base );
+}
+
+void pairs( std::size_t n )
+{
+    typedef std::pair<std::uint64_t, std::uint64_t> record;
+    const int reps{ 3 };
+    sc::vector<record> pristine, v;
+    std::uint64_t seed{ 2 };
+    for ( std::size_t i{0} ; i < n ; ++i ) pristine.push_back( record( next( seed ), i ) );
+    auto reset = [&]{ v = pristine; };
+    auto by_key = []( const record & a, const record & b ) { return a.first < b.first; };
+
+    bench::header( "(uint64_t, uint64_t) pairs by key, N = " + std::to_string( n ) );
+    double base = bench::best_of( reps, reset, [&]{ std::sort( v.data(), v.data() + n, by_key ); } );
+    bench::row( "std::sort", base, base );
+    bench::row( "std::stable_sort", bench::best_of( reps, reset, [&]{ std::stable_sort( v.data(), v.data() + n, by_key ); } ), base );
+    bench::row( "sc::radix_sort with key extractor",
+                bench::best_of( reps, reset, [&]{ sc::radix_sort( v, []( const record & r ) { return r.first; } ); } ), base );
+    bench::row( "sc::sort (parallel merge)", bench::best_of( reps, reset, [&]{ sc::sort( v, by_key ); } ), base );
+}
+
+int main( int argc, char * argv[] )
+{
+    const std::size_t cap{ argc > 1 ? static_cast<std::size_t>( std::atol( argv[1] ) ) : 100000000 };
+    std::printf( "threads in the shared pool: %zu\n", sc::thread_pool::global().size() );
+    for ( std::size_t n : { std::size_t{1000000}, std::size_t{10000000}, std::size_t{100000000} } )
+        if ( n <= cap ) keys( n );
+    for ( std::size_t n : { std::size_t{1000000}, std::size_t{10000000} } )
+        if ( n <= cap ) pairs( n );
+    return 0;
+}
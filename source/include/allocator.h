@@ -0,0 +1,172 @@
+#ifndef _ALLOCATOR_H_
+#define _ALLOCATOR_H_
+
+#include <cstdlib>      // std::malloc, std::realloc, std::free, posix_memalign
+#include <cstddef>      // std::size_t, std::max_align_t
+#include <limits>       // std::numeric_limits<T>
+#include <new>          // std::bad_alloc
+#ifdef _WIN32
+#include <malloc.h>     // _aligned_malloc, _aligned_free
+#endif
+
+/// Sequence container namespace.
+namespace sc {
+    /// An allocator that takes its memory from the C heap (malloc/realloc/free).
+    /*!
+     * Besides the usual allocate/deallocate pair it offers reallocate(), which
+     * lets sc::vector grow or shrink the storage of trivially relocatable
+     * elements in place, without the allocate-copy-free sequence.
+     *
+     * \tparam T The type of the elements.
+     */
+    template <typename T>
+    class malloc_allocator
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "malloc() can not honor the alignment of T.");
+
+        public:
+            using value_type = T;            //!< The value type.
+            using size_type = std::size_t;   //!< The size type.
+
+            //* Rebinds the allocator to another element type.
+            template <typename U>
+            struct rebind { using other = malloc_allocator<U>; };
+
+            malloc_allocator(void) = default;
+            template <typename U>
+            malloc_allocator(const malloc_allocator<U> &) noexcept { /* empty */ }
+
+            //* Returns raw memory for n elements.
+            T *allocate(size_type n)
+            {
+                return static_cast<T*>(checked(std::malloc(bytes(n))));
+            }
+
+            //* Gives back the memory acquired with allocate() or reallocate().
+            void deallocate(T *p, size_type) noexcept { std::free(p); }
+
+            //* Resizes the block p (holding old_n elements) to new_n elements, in place if possible.
+            //* The contents are kept bitwise; if it fails, p is left untouched and std::bad_alloc is thrown.
+            T *reallocate(T *p, size_type /* old_n */, size_type new_n)
+            {
+                return static_cast<T*>(checked(std::realloc(p, bytes(new_n))));
+            }
+
+        private:
+            //* Size in bytes of n elements, guarding against overflow.
+            static size_type bytes(size_type n)
+            {
+                if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+                    throw std::bad_alloc();
+                return n * sizeof(T);
+            }
+
+            //* Turns a null pointer coming from the C heap into an exception.
+            static void *checked(void *p)
+            {
+                if (p == nullptr)
+                    throw std::bad_alloc();
+                return p;
+            }
+    };
+
+    //* All malloc_allocators share the same heap, so any of them can free the memory of another.
+    template <typename T, typename U>
+    bool operator==(const malloc_allocator<T> &, const malloc_allocator<U> &) { return true; }
+
+    template <typename T, typename U>
+    bool operator!=(const malloc_allocator<T> &, const malloc_allocator<U> &) { return false; }
+
+    /// An allocator whose blocks all start at a multiple of Align bytes.
+    /*!
+     * Use it to get storage aligned to a cache line (64) or to the width of a
+     * SIMD register (32 for AVX, 64 for AVX-512), so numeric kernels can use
+     * aligned loads from the first element on. The guarantee holds for every
+     * block, hence across reserve(), shrink_to_fit(), assign() and copies.
+     *
+     * \tparam T The type of the elements.
+     * \tparam Align The alignment in bytes: a power of two, at least alignof(T).
+     */
+    template <typename T, std::size_t Align>
+    class aligned_allocator
+    {
+        static_assert(Align != 0 and (Align & (Align - 1)) == 0, "The alignment must be a power of two.");
+        static_assert(Align >= alignof(T), "The alignment can not be weaker than alignof(T).");
+
+        public:
+            using value_type = T;            //!< The value type.
+            using size_type = std::size_t;   //!< The size type.
+
+            //* The alignment of every block, in bytes.
+            static constexpr size_type alignment = Align;
+
+            //* Rebinds the allocator to another element type, keeping the alignment.
+            template <typename U>
+            struct rebind { using other = aligned_allocator<U, Align>; };
+
+            aligned_allocator(void) = default;
+            template <typename U>
+            aligned_allocator(const aligned_allocator<U, Align> &) noexcept { /* empty */ }
+
+            //* Returns raw memory for n elements, starting at a multiple of Align.
+            T *allocate(size_type n)
+            {
+                if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+                    throw std::bad_alloc();
+                void *p{nullptr};
+#ifdef _WIN32
+                p = _aligned_malloc(n * sizeof(T), Align);
+#else
+                // posix_memalign() wants at least the alignment of a pointer.
+                if (posix_memalign(&p, Align < sizeof(void*) ? sizeof(void*) : Align, n * sizeof(T)) != 0)
+                    p = nullptr;
+#endif
+                if (p == nullptr)
+                    throw std::bad_alloc();
+                return static_cast<T*>(p);
+            }
+
+            //* Gives back the memory acquired with allocate().
+            void deallocate(T *p, size_type) noexcept
+            {
+#ifdef _WIN32
+                _aligned_free(p);
+#else
+                std::free(p);
+#endif
+            }
+    };
+
+    template <typename T, std::size_t Align>
+    constexpr typename aligned_allocator<T, Align>::size_type aligned_allocator<T, Align>::alignment;
+
+    //* The memory of an aligned_allocator can be freed by any other with the same alignment.
+    template <typename T, typename U, std::size_t Align>
+    bool operator==(const aligned_allocator<T, Align> &, const aligned_allocator<U, Align> &) { return true; }
+
+    template <typename T, typename U, std::size_t Align>
+    bool operator!=(const aligned_allocator<T, Align> &, const aligned_allocator<U, Align> &) { return false; }
+
+    /// Recipe for the Allocator argument of sc::vector: `sc::vector<float, sc::aligned<64>>`
+    /// stores its elements in an aligned_allocator<float, 64>.
+    template <std::size_t Align>
+    struct aligned
+    {
+        template <typename T>
+        using allocator_for = aligned_allocator<T, Align>;
+    };
+
+    /// Tells the compiler that p is a multiple of Align, so loops over it may use aligned loads.
+    /// Typically used as `sc::assume_aligned<V::alignment>(v.data())`.
+    template <std::size_t Align, typename T>
+    inline T *assume_aligned(T *p)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<T*>(__builtin_assume_aligned(p, Align));
+#else
+        return p;
+#endif
+    }
+
+} // namespace sc.
+#endif
@@ -0,0 +1,575 @@
+#ifndef _BIT_VECTOR_H_
+#define _BIT_VECTOR_H_
+
+#include <algorithm>    // std::upper_bound
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint64_t
+#include <initializer_list> // std::initializer_list
+#include <iterator>     // std::random_access_iterator_tag
+#include <stdexcept>    // std::out_of_range, std::length_error
+
+#include "simd.h"       // SC_TARGET, sc::simd::active()
+#include "vector.h"     // sc::vector
+#include "checks.h"     // SC_EXPECTS, SC_EXPECTS_NONEMPTY
+
+/// Sequence container namespace.
+namespace sc {
+    /// Kernels over contiguous ranges of elements (raw pointers, sc::vector::data(), sc::span).
+    namespace kernels {
+        namespace detail {
+            //* Portable fallback; the compiler emits popcnt by itself when the build targets it.
+            inline std::size_t popcount_scalar(const std::uint64_t *words, std::size_t n)
+            {
+                std::size_t total{0};
+                for (std::size_t i{0} ; i < n ; ++i)
+                    total += static_cast<std::size_t>(__builtin_popcountll(words[i]));
+                return total;
+            }
+
+#if SC_SIMD_X86 && defined(__x86_64__)
+            //* The popcnt instruction, with four accumulators so consecutive words do not wait on each other.
+            SC_TARGET("popcnt")
+            inline std::size_t popcount_hw(const std::uint64_t *words, std::size_t n)
+            {
+                std::uint64_t c0{0}, c1{0}, c2{0}, c3{0};
+                std::size_t i{0};
+                for ( /*empty*/ ; i + 4 <= n ; i += 4) {
+                    c0 += static_cast<std::uint64_t>(_mm_popcnt_u64(words[i]));
+                    c1 += static_cast<std::uint64_t>(_mm_popcnt_u64(words[i + 1]));
+                    c2 += static_cast<std::uint64_t>(_mm_popcnt_u64(words[i + 2]));
+                    c3 += static_cast<std::uint64_t>(_mm_popcnt_u64(words[i + 3]));
+                }
+                for ( /*empty*/ ; i < n ; ++i)
+                    c0 += static_cast<std::uint64_t>(_mm_popcnt_u64(words[i]));
+                return static_cast<std::size_t>(c0 + c1 + c2 + c3);
+            }
+#endif
+        } // namespace detail.
+
+        //* Number of set bits in the n words at words. Uses popcnt when simd::active() is avx2 or better.
+        inline std::size_t popcount(const std::uint64_t *words, std::size_t n)
+        {
+#if SC_SIMD_X86 && defined(__x86_64__)
+            if (simd::active() >= simd::level::avx2)
+                return detail::popcount_hw(words, n);
+#endif
+            return detail::popcount_scalar(words, n);
+        }
+    } // namespace kernels.
+
+    /// A sequence of bits, packed 64 to a word: one bit per flag instead of the byte of a sc::vector<bool>.
+    /*!
+     * The interface follows sc::vector (push_back, operator[], at, reserve,
+     * ...) with the bitset operations on top: count(), find_first() and
+     * find_next(), set/reset/flip, the bitwise operators, and rank/select.
+     * They all work a 64-bit word at a time: counting with popcnt and
+     * searching with a trailing-zero count, so a scan skips 64 clear bits per
+     * step.
+     *
+     * Since a bit has no address, operator[] and at() return a proxy
+     * (bit_vector::reference) that reads and writes the bit:
+     *
+     *     sc::bit_vector flags(100000000);
+     *     flags[42] = true;
+     *     for (auto i = flags.find_first() ; i != flags.size() ; i = flags.find_next(i)) ...
+     *
+     * The bits past size() in the last word are always zero, so the word
+     * loops need no masking. For many rank/select queries on a vector that no
+     * longer changes, build a sc::rank_select over it.
+     */
+    class bit_vector
+    {
+        //=== Aliases
+        public:
+            using size_type = unsigned long;    //!< The size type.
+            using value_type = bool;            //!< The value type.
+            using word_type = std::uint64_t;    //!< The storage unit.
+            static constexpr size_type word_bits = 64; //!< Bits per word.
+
+            /// A writable reference to one bit.
+            class reference
+            {
+                public:
+                    operator bool(void) const { return (*m_word & m_mask) != 0; }
+                    bool operator~(void) const { return (*m_word & m_mask) == 0; }
+
+                    reference &operator=(bool value)
+                    {
+                        if (value)
+                            *m_word |= m_mask;
+                        else
+                            *m_word &= ~m_mask;
+                        return *this;
+                    }
+
+                    //* Assigns the value of the other bit, not the reference itself.
+                    reference &operator=(const reference &other) { return *this = static_cast<bool>(other); }
+
+                    reference &flip(void)
+                    {
+                        *m_word ^= m_mask;
+                        return *this;
+                    }
+
+                private:
+                    friend class bit_vector;
+                    reference(word_type *word, word_type mask) : m_word{word}, m_mask{mask} { /* empty */ }
+
+                    word_type *m_word;  //!< The word holding the bit.
+                    word_type m_mask;   //!< The bit, inside the word.
+            };
+
+            /// Iterator over the bits; Ref is reference or bool.
+            template <typename Vec, typename Ref>
+            class bit_iterator
+            {
+                public:
+                    using difference_type = std::ptrdiff_t;
+                    using value_type = bool;
+                    using reference = Ref;
+                    using pointer = void;
+                    using iterator_category = std::random_access_iterator_tag;
+
+                    bit_iterator(Vec *vec = nullptr, size_type pos = 0) : m_vec{vec}, m_pos{pos} { /* empty */ }
+
+                    Ref operator*(void) const { return (*m_vec)[m_pos]; }
+                    Ref operator[](difference_type n) const { return (*m_vec)[m_pos + n]; }
+
+                    bit_iterator &operator++(void) { ++m_pos; return *this; }
+                    bit_iterator operator++(int) { bit_iterator old{*this}; ++m_pos; return old; }
+                    bit_iterator &operator--(void) { --m_pos; return *this; }
+                    bit_iterator operator--(int) { bit_iterator old{*this}; --m_pos; return old; }
+                    bit_iterator &operator+=(difference_type n) { m_pos += n; return *this; }
+                    bit_iterator &operator-=(difference_type n) { m_pos -= n; return *this; }
+
+                    friend bit_iterator operator+(bit_iterator it, difference_type n) { return it += n; }
+                    friend bit_iterator operator+(difference_type n, bit_iterator it) { return it += n; }
+                    friend bit_iterator operator-(bit_iterator it, difference_type n) { return it -= n; }
+                    friend difference_type operator-(const bit_iterator &a, const bit_iterator &b)
+                    {
+                        return static_cast<difference_type>(a.m_pos) - static_cast<difference_type>(b.m_pos);
+                    }
+
+                    friend bool operator==(const bit_iterator &a, const bit_iterator &b) { return a.m_pos == b.m_pos; }
+                    friend bool operator!=(const bit_iterator &a, const bit_iterator &b) { return a.m_pos != b.m_pos; }
+                    friend bool operator<(const bit_iterator &a, const bit_iterator &b) { return a.m_pos < b.m_pos; }
+                    friend bool operator>(const bit_iterator &a, const bit_iterator &b) { return a.m_pos > b.m_pos; }
+                    friend bool operator<=(const bit_iterator &a, const bit_iterator &b) { return a.m_pos <= b.m_pos; }
+                    friend bool operator>=(const bit_iterator &a, const bit_iterator &b) { return a.m_pos >= b.m_pos; }
+
+                private:
+                    Vec *m_vec;         //!< The bits iterated over.
+                    size_type m_pos;    //!< The current bit.
+            };
+
+            using iterator = bit_iterator<bit_vector, reference>;              //!< Iterator with write access.
+            using const_iterator = bit_iterator<const bit_vector, bool>;       //!< Read-only iterator.
+
+        public:
+            //!=== [I] Special members
+            //* An empty vector, without memory.
+            bit_vector(void) : m_size{0} { /* empty */ }
+
+            //* count bits, all equal to value.
+            explicit bit_vector(size_type count, bool value = false) : m_size{0} { resize(count, value); }
+
+            //* The bits of the list.
+            bit_vector(std::initializer_list<bool> il) : m_size{0}
+            {
+                reserve(il.size());
+                for (bool b : il)
+                    push_back(b);
+            }
+
+            //!=== [II] Iterators
+            iterator begin(void) { return iterator(this, 0); }
+            iterator end(void) { return iterator(this, m_size); }
+            const_iterator begin(void) const { return const_iterator(this, 0); }
+            const_iterator end(void) const { return const_iterator(this, m_size); }
+            const_iterator cbegin(void) const { return begin(); }
+            const_iterator cend(void) const { return end(); }
+
+            //!=== [III] Capacity
+            //* Number of bits.
+            size_type size(void) const { return m_size; }
+
+            //* Number of bits that fit in the words already allocated.
+            size_type capacity(void) const { return m_words.capacity() * word_bits; }
+
+            bool empty(void) const { return m_size == 0; }
+
+            //* Makes room for bits bits.
+            void reserve(size_type bits) { m_words.reserve(words_for(bits)); }
+
+            void shrink_to_fit(void) { m_words.shrink_to_fit(); }
+
+            //!=== [IV] Modifiers
+            void clear(void)
+            {
+                m_words.clear();
+                m_size = 0;
+            }
+
+            //* Appends a bit.
+            void push_back(bool value)
+            {
+                if (m_size % word_bits == 0)
+                    m_words.push_back(0);
+                if (value)
+                    m_words[m_size / word_bits] |= word_type{1} << (m_size % word_bits);
+                ++m_size;
+            }
+
+            //* Removes the last bit.
+            void pop_back(void)
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[bit_vector::pop_back()]: Can not remove a bit from an empty vector.");
+                --m_size;
+                m_words[m_size / word_bits] &= ~(word_type{1} << (m_size % word_bits));
+                if (m_size % word_bits == 0)
+                    m_words.pop_back();
+            }
+
+            //* Changes the number of bits to count; new bits are set to value.
+            void resize(size_type count, bool value = false)
+            {
+                if (count < m_size) {
+                    size_type words{words_for(count)};
+                    m_words.erase(m_words.begin() + static_cast<std::ptrdiff_t>(words), m_words.end());
+                    m_size = count;
+                    clear_tail();
+                    return;
+                }
+                // Fill the rest of the last word, then whole words.
+                if (value and m_size % word_bits != 0)
+                    m_words.back() |= ~word_type{0} << (m_size % word_bits);
+                m_words.reserve(words_for(count));
+                while (m_words.size() < words_for(count))
+                    m_words.push_back(value ? ~word_type{0} : 0);
+                m_size = count;
+                clear_tail();
+            }
+
+            //* Sets the bit at pos to value.
+            bit_vector &set(size_type pos, bool value = true)
+            {
+                (*this)[pos] = value;
+                return *this;
+            }
+
+            //* Sets every bit.
+            bit_vector &set(void)
+            {
+                word_type *words{m_words.data()};
+                size_type n{m_words.size()};
+                for (size_type i{0} ; i < n ; ++i)
+                    words[i] = ~word_type{0};
+                clear_tail();
+                return *this;
+            }
+
+            bit_vector &reset(size_type pos) { return set(pos, false); }
+
+            //* Clears every bit.
+            bit_vector &reset(void)
+            {
+                word_type *words{m_words.data()};
+                size_type n{m_words.size()};
+                for (size_type i{0} ; i < n ; ++i)
+                    words[i] = 0;
+                return *this;
+            }
+
+            bit_vector &flip(size_type pos)
+            {
+                (*this)[pos].flip();
+                return *this;
+            }
+
+            //* Flips every bit.
+            bit_vector &flip(void)
+            {
+                word_type *words{m_words.data()};
+                size_type n{m_words.size()};
+                for (size_type i{0} ; i < n ; ++i)
+                    words[i] = ~words[i];
+                clear_tail();
+                return *this;
+            }
+
+            friend void swap(bit_vector &a, bit_vector &b)
+            {
+                using std::swap;
+                swap(a.m_words, b.m_words);
+                swap(a.m_size, b.m_size);
+            }
+
+            //!=== [V] Element access
+            //* The bit at pos. Checked according to SC_BOUNDS_CHECK.
+            bool operator[](size_type pos) const
+            {
+                SC_EXPECTS(pos < m_size, std::out_of_range, "[bit_vector::operator[]]: position provided is out of vector range");
+                return (m_words[pos / word_bits] >> (pos % word_bits)) & 1;
+            }
+
+            reference operator[](size_type pos)
+            {
+                SC_EXPECTS(pos < m_size, std::out_of_range, "[bit_vector::operator[]]: position provided is out of vector range");
+                return reference(&m_words[pos / word_bits], word_type{1} << (pos % word_bits));
+            }
+
+            //* The bit at pos, with bounds-checking.
+            bool at(size_type pos) const
+            {
+                if (pos >= m_size)
+                    throw std::out_of_range("[bit_vector::at(pos)]: position provided is out of vector range");
+                return (*this)[pos];
+            }
+
+            reference at(size_type pos)
+            {
+                if (pos >= m_size)
+                    throw std::out_of_range("[bit_vector::at(pos)]: position provided is out of vector range");
+                return (*this)[pos];
+            }
+
+            bool test(size_type pos) const { return at(pos); }
+
+            //* The first and the last bit. Checked according to SC_EMPTY_CHECK.
+            bool front(void) const
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[bit_vector::front()]: empty vector.");
+                return (*this)[0];
+            }
+
+            bool back(void) const
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[bit_vector::back()]: empty vector.");
+                return (*this)[m_size - 1];
+            }
+
+            //* The words holding the bits, bit i in word i / 64 at position i % 64.
+            const word_type *data(void) const { return m_words.data(); }
+            word_type *data(void) { return m_words.data(); }
+
+            //* Number of words in data().
+            size_type word_count(void) const { return m_words.size(); }
+
+            //!=== [VI] Bit operations
+            //* Number of set bits.
+            size_type count(void) const { return kernels::popcount(m_words.data(), m_words.size()); }
+
+            bool any(void) const
+            {
+                for (size_type i{0} ; i < m_words.size() ; ++i)
+                    if (m_words[i] != 0)
+                        return true;
+                return false;
+            }
+
+            bool none(void) const { return not any(); }
+            bool all(void) const { return count() == m_size; }
+
+            //* Position of the first set bit, or size() if there is none.
+            size_type find_first(void) const { return find_from(0); }
+
+            //* Position of the first set bit after pos, or size() if there is none.
+            size_type find_next(size_type pos) const { return pos + 1 >= m_size ? m_size : find_from(pos + 1); }
+
+            //* Number of set bits in [0, pos). Linear in pos; see sc::rank_select for constant time.
+            size_type rank(size_type pos) const
+            {
+                size_type whole{pos / word_bits};
+                size_type ones{kernels::popcount(m_words.data(), whole)};
+                if (pos % word_bits != 0)
+                    ones += static_cast<size_type>(__builtin_popcountll(m_words[whole] & low_bits(pos % word_bits)));
+                return ones;
+            }
+
+            //* Position of the set bit of rank k (the first one is k = 0), or size() if there are not that many.
+            //* Linear; see sc::rank_select for logarithmic time.
+            size_type select(size_type k) const
+            {
+                for (size_type w{0} ; w < m_words.size() ; ++w) {
+                    size_type ones{static_cast<size_type>(__builtin_popcountll(m_words[w]))};
+                    if (k < ones)
+                        return w * word_bits + select_in_word(m_words[w], static_cast<unsigned>(k));
+                    k -= ones;
+                }
+                return m_size;
+            }
+
+            //* Position of the set bit of rank k inside word, which has more than k set bits.
+            static unsigned select_in_word(word_type word, unsigned k)
+            {
+                // Narrow down to a byte with popcounts, then clear the lowest bits one by one.
+                unsigned base{0};
+                for (unsigned width{32} ; width >= 8 ; width /= 2) {
+                    unsigned low{static_cast<unsigned>(__builtin_popcountll(word & low_bits(width)))};
+                    if (k >= low) {
+                        k -= low;
+                        word >>= width;
+                        base += width;
+                    }
+                }
+                for ( /*empty*/ ; k > 0 ; --k)
+                    word &= word - 1;
+                return base + static_cast<unsigned>(__builtin_ctzll(word));
+            }
+
+            //* Bitwise operations with a vector of the same size. Throw std::length_error if the sizes differ.
+            //* The loops go through data(), which unshares the words once instead of at every index, and
+            //* read the size once: a store to a word could otherwise change it, for the compiler.
+            bit_vector &operator&=(const bit_vector &other)
+            {
+                check_size(other, "[bit_vector::operator&=()]: The vectors have different sizes.");
+                word_type *words{m_words.data()};
+                size_type n{m_words.size()};
+                const word_type *theirs{other.m_words.data()};
+                for (size_type i{0} ; i < n ; ++i)
+                    words[i] &= theirs[i];
+                return *this;
+            }
+
+            bit_vector &operator|=(const bit_vector &other)
+            {
+                check_size(other, "[bit_vector::operator|=()]: The vectors have different sizes.");
+                word_type *words{m_words.data()};
+                size_type n{m_words.size()};
+                const word_type *theirs{other.m_words.data()};
+                for (size_type i{0} ; i < n ; ++i)
+                    words[i] |= theirs[i];
+                return *this;
+            }
+
+            bit_vector &operator^=(const bit_vector &other)
+            {
+                check_size(other, "[bit_vector::operator^=()]: The vectors have different sizes.");
+                word_type *words{m_words.data()};
+                size_type n{m_words.size()};
+                const word_type *theirs{other.m_words.data()};
+                for (size_type i{0} ; i < n ; ++i)
+                    words[i] ^= theirs[i];
+                return *this;
+            }
+
+            bit_vector operator~(void) const
+            {
+                bit_vector result(*this);
+                return result.flip();
+            }
+
+            friend bit_vector operator&(bit_vector a, const bit_vector &b) { return a &= b; }
+            friend bit_vector operator|(bit_vector a, const bit_vector &b) { return a |= b; }
+            friend bit_vector operator^(bit_vector a, const bit_vector &b) { return a ^= b; }
+
+            friend bool operator==(const bit_vector &a, const bit_vector &b) { return a.m_size == b.m_size and a.m_words == b.m_words; }
+            friend bool operator!=(const bit_vector &a, const bit_vector &b) { return not (a == b); }
+
+        private:
+            static size_type words_for(size_type bits) { return (bits + word_bits - 1) / word_bits; }
+
+            //* The bits [0, n) of a word set, for 0 < n < 64.
+            static word_type low_bits(unsigned long n) { return (word_type{1} << n) - 1; }
+
+            //* Zeroes the bits past size() in the last word.
+            void clear_tail(void)
+            {
+                if (m_size % word_bits != 0)
+                    m_words.back() &= low_bits(m_size % word_bits);
+            }
+
+            void check_size(const bit_vector &other, const char *msg) const
+            {
+                if (m_size != other.m_size)
+                    throw std::length_error(msg);
+            }
+
+            //* Position of the first set bit at or after pos, or size().
+            size_type find_from(size_type pos) const
+            {
+                // Also covers the empty vector, which may have no word at all.
+                if (pos >= m_size)
+                    return m_size;
+                size_type w{pos / word_bits};
+                word_type word{m_words[w] & (~word_type{0} << (pos % word_bits))};
+                while (word == 0) {
+                    if (++w == m_words.size())
+                        return m_size;
+                    word = m_words[w];
+                }
+                return w * word_bits + static_cast<size_type>(__builtin_ctzll(word));
+            }
+
+            vector<word_type> m_words;  //!< The bits, 64 per word; the unused high bits of the last word are 0.
+            size_type m_size;           //!< Number of bits.
+    };
+
+    /// Constant-time rank and logarithmic-time select over a bit_vector that no longer changes.
+    /*!
+     * Stores the number of set bits before every block of 8 words (512 bits),
+     * which costs 12.5% of the size of the bits. rank() adds a sample and at
+     * most 8 popcounts; select() binary-searches the samples, then counts
+     * through one block.
+     *
+     * The index refers to the bits of the vector it was built from: it must be
+     * rebuilt after the vector changes, and must not outlive it.
+     */
+    class rank_select
+    {
+        public:
+            using size_type = bit_vector::size_type;    //!< The size type.
+            static constexpr size_type block_words = 8; //!< Words per sample.
+
+            //* Indexes bits.
+            explicit rank_select(const bit_vector &bits) : m_bits{&bits}
+            {
+                size_type words{bits.word_count()};
+                size_type total{0};
+                m_samples.reserve(words / block_words + 2);
+                for (size_type w{0} ; w < words ; w += block_words) {
+                    m_samples.push_back(total);
+                    total += kernels::popcount(bits.data() + w, words - w < block_words ? words - w : block_words);
+                }
+                m_samples.push_back(total);
+            }
+
+            //* Number of set bits in [0, pos).
+            size_type rank(size_type pos) const
+            {
+                size_type w{pos / bit_vector::word_bits};
+                size_type block{w / block_words};
+                size_type ones{m_samples[block] + kernels::popcount(m_bits->data() + block * block_words, w - block * block_words)};
+                if (pos % bit_vector::word_bits != 0)
+                    ones += static_cast<size_type>(__builtin_popcountll(
+                        m_bits->data()[w] & ((bit_vector::word_type{1} << (pos % bit_vector::word_bits)) - 1)));
+                return ones;
+            }
+
+            //* Position of the set bit of rank k (the first one is k = 0), or size() if there are not that many.
+            size_type select(size_type k) const
+            {
+                if (k >= m_samples.back())
+                    return m_bits->size();
+                // The last block whose sample is <= k.
+                const size_type *first{m_samples.data()};
+                size_type block{static_cast<size_type>(std::upper_bound(first, first + m_samples.size(), k) - first) - 1};
+                k -= m_samples[block];
+                for (size_type w{block * block_words} ; /*empty*/ ; ++w) {
+                    size_type ones{static_cast<size_type>(__builtin_popcountll(m_bits->data()[w]))};
+                    if (k < ones)
+                        return w * bit_vector::word_bits + bit_vector::select_in_word(m_bits->data()[w], static_cast<unsigned>(k));
+                    k -= ones;
+                }
+            }
+
+            //* Total number of set bits.
+            size_type count(void) const { return m_samples.back(); }
+
+        private:
+            const bit_vector *m_bits;       //!< The indexed bits.
+            vector<size_type> m_samples;    //!< m_samples[b]: set bits before word b * block_words; the last one is the total.
+    };
+
+} // namespace sc.
+#endif
@@ -0,0 +1,62 @@
+#ifndef _CHECKS_H_
+#define _CHECKS_H_
+
+#include <cassert>      // assert()
+#include <stdexcept>    // std::out_of_range, std::length_error
+
+// How the containers check the preconditions of their unchecked operations. There are two
+// policies, each taking one of the values below; define them before the first include, the
+// same way in every translation unit of a program. at() always throws, whatever the policy.
+//
+//     SC_BOUNDS_CHECK   positions: operator[] and the iterators given to insert() and erase().
+//                       Defaults to SC_BOUNDS_ASSERT, free in release builds.
+//     SC_EMPTY_CHECK    non-empty containers: front(), back(), pop_back() and pop_front().
+//                       Defaults to SC_BOUNDS_THROWING, the behavior these always had.
+//
+//     SC_BOUNDS_UNCHECKED  nothing is checked: release hot paths.
+//     SC_BOUNDS_ASSERT     assert(), so checked unless NDEBUG is defined.
+//     SC_BOUNDS_THROWING   a violation throws std::out_of_range or std::length_error.
+#define SC_BOUNDS_UNCHECKED 0
+#define SC_BOUNDS_ASSERT 1
+#define SC_BOUNDS_THROWING 2
+
+#ifndef SC_BOUNDS_CHECK
+#define SC_BOUNDS_CHECK SC_BOUNDS_ASSERT
+#endif
+
+#ifndef SC_EMPTY_CHECK
+#define SC_EMPTY_CHECK SC_BOUNDS_THROWING
+#endif
+
+#if SC_BOUNDS_CHECK < SC_BOUNDS_UNCHECKED || SC_BOUNDS_CHECK > SC_BOUNDS_THROWING
+#error "SC_BOUNDS_CHECK must be SC_BOUNDS_UNCHECKED, SC_BOUNDS_ASSERT or SC_BOUNDS_THROWING."
+#endif
+
+#if SC_EMPTY_CHECK < SC_BOUNDS_UNCHECKED || SC_EMPTY_CHECK > SC_BOUNDS_THROWING
+#error "SC_EMPTY_CHECK must be SC_BOUNDS_UNCHECKED, SC_BOUNDS_ASSERT or SC_BOUNDS_THROWING."
+#endif
+
+// One checking macro per policy value; SC_CHECK_WITH picks it once the policy has expanded to a number.
+#define SC_CHECK_0(cond, Exception, msg) ((void)0)
+#define SC_CHECK_1(cond, Exception, msg) assert((cond) and msg)
+#define SC_CHECK_2(cond, Exception, msg) do { if (not (cond)) throw Exception(msg); } while (0)
+#define SC_CHECK_PASTE(policy, cond, Exception, msg) SC_CHECK_##policy(cond, Exception, msg)
+#define SC_CHECK_WITH(policy, cond, Exception, msg) SC_CHECK_PASTE(policy, cond, Exception, msg)
+
+//* A position precondition, checked according to SC_BOUNDS_CHECK.
+#define SC_EXPECTS(cond, Exception, msg) SC_CHECK_WITH(SC_BOUNDS_CHECK, cond, Exception, msg)
+
+//* A non-empty precondition, checked according to SC_EMPTY_CHECK.
+#define SC_EXPECTS_NONEMPTY(cond, Exception, msg) SC_CHECK_WITH(SC_EMPTY_CHECK, cond, Exception, msg)
+
+/// Sequence container namespace.
+namespace sc {
+    /// The checking policies, in the order of the SC_BOUNDS_* values.
+    enum class bounds_policy { unchecked = 0, assert = 1, throwing = 2 };
+
+    //* The policies this translation unit was compiled with.
+    constexpr bounds_policy bounds_checking{static_cast<bounds_policy>(SC_BOUNDS_CHECK)};
+    constexpr bounds_policy empty_checking{static_cast<bounds_policy>(SC_EMPTY_CHECK)};
+
+} // namespace sc.
+#endif
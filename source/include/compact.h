@@ -0,0 +1,250 @@
+#ifndef _COMPACT_H_
+#define _COMPACT_H_
+
+#include <algorithm>    // std::remove_if
+#include <cstddef>      // std::size_t, std::ptrdiff_t
+#include <cstdint>      // std::uint32_t, std::uint64_t
+#include <cstring>      // std::memcpy
+#include <type_traits>  // std::is_arithmetic, std::is_floating_point, std::is_trivially_copyable, std::decay
+
+#include "simd.h"       // SC_TARGET, sc::simd::active()
+#include "vector.h"     // sc::vector
+
+/// Sequence container namespace.
+namespace sc {
+    /// Kernels over contiguous ranges of elements (raw pointers, sc::vector::data(), sc::span).
+    namespace kernels {
+        namespace detail {
+            /// How the SIMD kernels compare a T: 0 = not vectorized, 1 = 32-bit integer, 2 = float,
+            /// 3 = 64-bit integer, 4 = double. Integers compare their bits, so the signedness does not matter.
+            template <typename T>
+            struct lane_kind : std::integral_constant<int,
+                not std::is_arithmetic<T>::value or std::is_same<T, bool>::value ? 0 :
+                std::is_floating_point<T>::value ? (sizeof(T) == 4 ? 2 : sizeof(T) == 8 ? 4 : 0) :
+                sizeof(T) == 4 ? 1 : sizeof(T) == 8 ? 3 : 0> {};
+
+            //* Branch-free compaction: every element is written, the output only advances past the kept ones.
+            //* Filters with unpredictable outcomes never pay for a mispredicted branch.
+            template <typename T, typename Pred>
+            T *remove_if_scalar(T *first, T *last, Pred pred)
+            {
+                T *out{first};
+                for ( /*empty*/ ; first != last ; ++first) {
+                    T value = *first;
+                    *out = value;
+                    out += not pred(value);
+                }
+                return out;
+            }
+
+            //* Same as above for a single value, compared with ==. The prefix [first, out) is already
+            //* compacted, [from, last) is still to be filtered.
+            template <typename T>
+            T *remove_scalar(T *out, T *from, T *last, T value)
+            {
+                for ( /*empty*/ ; from != last ; ++from) {
+                    T x = *from;
+                    *out = x;
+                    out += not (x == value);
+                }
+                return out;
+            }
+
+            template <typename T, typename Pred>
+            T *remove_if(T *first, T *last, Pred pred, std::true_type) { return remove_if_scalar(first, last, pred); }
+
+            template <typename T, typename Pred>
+            T *remove_if(T *first, T *last, Pred pred, std::false_type) { return std::remove_if(first, last, pred); }
+
+#if SC_SIMD_X86
+            //* The bits of value repeated over a 256-bit register.
+            template <typename T>
+            SC_TARGET("avx2")
+            __m256i broadcast256(T value)
+            {
+                if (sizeof(T) == 4) {
+                    std::uint32_t bits; std::memcpy(&bits, &value, 4);
+                    return _mm256_set1_epi32(static_cast<int>(bits));
+                }
+                std::uint64_t bits; std::memcpy(&bits, &value, 8);
+                return _mm256_set1_epi64x(static_cast<long long>(bits));
+            }
+
+            // One bit per 32-bit lane that is kept, i.e. that differs from the value (NaN lanes are kept).
+            SC_TARGET("avx2,bmi2")
+            inline unsigned keep_mask256(__m256i v, __m256i x, std::integral_constant<int, 1>)
+            {
+                return ~static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, x)))) & 0xFF;
+            }
+            SC_TARGET("avx2,bmi2")
+            inline unsigned keep_mask256(__m256i v, __m256i x, std::integral_constant<int, 2>)
+            {
+                return ~static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_castsi256_ps(v), _mm256_castsi256_ps(x), _CMP_EQ_OQ))) & 0xFF;
+            }
+            // 64-bit lanes give one bit per element: each is doubled to cover the two 32-bit halves.
+            SC_TARGET("avx2,bmi2")
+            inline unsigned keep_mask256(__m256i v, __m256i x, std::integral_constant<int, 3>)
+            {
+                unsigned keep{~static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, x)))) & 0xF};
+                return static_cast<unsigned>(_pdep_u32(keep, 0x55) * 3);
+            }
+            SC_TARGET("avx2,bmi2")
+            inline unsigned keep_mask256(__m256i v, __m256i x, std::integral_constant<int, 4>)
+            {
+                unsigned keep{~static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_castsi256_pd(v), _mm256_castsi256_pd(x), _CMP_EQ_OQ))) & 0xF};
+                return static_cast<unsigned>(_pdep_u32(keep, 0x55) * 3);
+            }
+
+            //* AVX2 stream compaction: compare 32 bytes, pack the kept 32-bit lanes to the front with a
+            //* permutation computed from the mask (pdep/pext), store the whole register and advance by
+            //* the number of kept lanes. The store never passes the input already read, so it is safe in place.
+            template <typename T>
+            SC_TARGET("avx2,bmi,bmi2,popcnt")
+            T *remove_avx2(T *first, T *last, T value)
+            {
+                constexpr std::ptrdiff_t per_block = 32 / sizeof(T);
+                const __m256i x = broadcast256(value);
+                T *out{first};
+                for ( /*empty*/ ; last - first >= per_block ; first += per_block) {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+                    unsigned keep{keep_mask256(v, x, lane_kind<T>{})};
+                    std::uint64_t bytes{_pdep_u64(keep, 0x0101010101010101ull) * 0xFF};
+                    std::uint64_t order{_pext_u64(0x0706050403020100ull, bytes)};
+                    __m256i perm = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<long long>(order)));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permutevar8x32_epi32(v, perm));
+                    out += _mm_popcnt_u32(keep) * 4 / sizeof(T);
+                }
+                return remove_scalar(out, first, last, value);
+            }
+
+            // Packs the lanes of v that differ from x to the front of the register; returns how many there are.
+            SC_TARGET("avx512f,popcnt")
+            inline __m512i compress512(__m512i v, __m512i x, unsigned &kept, std::integral_constant<int, 1>)
+            {
+                __mmask16 k = _mm512_cmpneq_epi32_mask(v, x);
+                kept = static_cast<unsigned>(_mm_popcnt_u32(k));
+                return _mm512_maskz_compress_epi32(k, v);
+            }
+            SC_TARGET("avx512f,popcnt")
+            inline __m512i compress512(__m512i v, __m512i x, unsigned &kept, std::integral_constant<int, 2>)
+            {
+                __mmask16 k = _mm512_cmp_ps_mask(_mm512_castsi512_ps(v), _mm512_castsi512_ps(x), _CMP_NEQ_UQ);
+                kept = static_cast<unsigned>(_mm_popcnt_u32(k));
+                return _mm512_castps_si512(_mm512_maskz_compress_ps(k, _mm512_castsi512_ps(v)));
+            }
+            SC_TARGET("avx512f,popcnt")
+            inline __m512i compress512(__m512i v, __m512i x, unsigned &kept, std::integral_constant<int, 3>)
+            {
+                __mmask8 k = _mm512_cmpneq_epi64_mask(v, x);
+                kept = static_cast<unsigned>(_mm_popcnt_u32(k));
+                return _mm512_maskz_compress_epi64(k, v);
+            }
+            SC_TARGET("avx512f,popcnt")
+            inline __m512i compress512(__m512i v, __m512i x, unsigned &kept, std::integral_constant<int, 4>)
+            {
+                __mmask8 k = _mm512_cmp_pd_mask(_mm512_castsi512_pd(v), _mm512_castsi512_pd(x), _CMP_NEQ_UQ);
+                kept = static_cast<unsigned>(_mm_popcnt_u32(k));
+                return _mm512_castpd_si512(_mm512_maskz_compress_pd(k, _mm512_castsi512_pd(v)));
+            }
+
+            //* AVX-512 stream compaction with the native compress instructions. Compressing into a
+            //* register and storing it whole is faster than the compress-to-memory form on Intel cores.
+            template <typename T>
+            SC_TARGET("avx512f,popcnt")
+            T *remove_avx512(T *first, T *last, T value)
+            {
+                constexpr std::ptrdiff_t per_block = 64 / sizeof(T);
+                __m512i x;
+                if (sizeof(T) == 4) {
+                    std::uint32_t bits; std::memcpy(&bits, &value, 4);
+                    x = _mm512_set1_epi32(static_cast<int>(bits));
+                }
+                else {
+                    std::uint64_t bits; std::memcpy(&bits, &value, 8);
+                    x = _mm512_set1_epi64(static_cast<long long>(bits));
+                }
+                T *out{first};
+                for ( /*empty*/ ; last - first >= per_block ; first += per_block) {
+                    __m512i v = _mm512_loadu_si512(first);
+                    unsigned kept{0};
+                    _mm512_storeu_si512(out, compress512(v, x, kept, lane_kind<T>{}));
+                    out += kept;
+                }
+                return remove_scalar(out, first, last, value);
+            }
+#endif
+            //* Elements the SIMD kernels do not handle.
+            template <typename T>
+            T *remove(T *first, T *last, const T &value, std::false_type)
+            {
+                return remove_if(first, last, [&value](const T &x) { return x == value; }, std::is_trivially_copyable<T>{});
+            }
+
+            template <typename T>
+            T *remove(T *first, T *last, const T &value, std::true_type)
+            {
+#if SC_SIMD_X86
+                switch (simd::active()) {
+                    case simd::level::avx512: return remove_avx512(first, last, value);
+                    case simd::level::avx2:   return remove_avx2(first, last, value);
+                    default: break;
+                }
+#endif
+                return remove_scalar(first, first, last, value);
+            }
+        } // namespace detail.
+
+        //* Moves the elements of [first, last) that are not equal to value to the front, keeping their order.
+        //* Returns the new end. 4- and 8-byte arithmetic types are compared with AVX2/AVX-512 when available.
+        template <typename T>
+        T *remove(T *first, T *last, const T &value)
+        {
+            return detail::remove(first, last, value, std::integral_constant<bool, detail::lane_kind<T>::value != 0>{});
+        }
+
+        //* Moves the elements of [first, last) for which pred is false to the front, keeping their order.
+        //* Returns the new end. Trivially copyable elements take a branch-free path.
+        template <typename T, typename Pred>
+        T *remove_if(T *first, T *last, Pred pred)
+        {
+            return detail::remove_if(first, last, pred, std::is_trivially_copyable<T>{});
+        }
+    } // namespace kernels.
+
+    //!=== Erasure
+    //* Erases every element for which pred is true, in a single linear pass. Returns how many were erased.
+    template <typename T, typename Allocator, typename GrowthPolicy, typename Pred>
+    typename vector<T, Allocator, GrowthPolicy>::size_type erase_if(vector<T, Allocator, GrowthPolicy> &vec, Pred pred)
+    {
+        T *first{vec.data()};
+        T *last{first + vec.size()};
+        T *kept{kernels::remove_if(first, last, pred)};
+        vec.erase(vec.begin() + (kept - first), vec.end());
+        return static_cast<typename vector<T, Allocator, GrowthPolicy>::size_type>(last - kept);
+    }
+
+    //* Erases every element equal to value, in a single linear pass. Returns how many were erased.
+    //* value is compared as it is, not converted to T first: erase(ints, 2.5) erases nothing.
+    template <typename T, typename Allocator, typename GrowthPolicy, typename U>
+    typename vector<T, Allocator, GrowthPolicy>::size_type erase(vector<T, Allocator, GrowthPolicy> &vec, const U &value)
+    {
+        // Copied first: value may refer into the elements, which the compaction overwrites.
+        const typename std::decay<const U>::type target(value);
+        return erase_if(vec, [&target](const T &x) { return x == target; });
+    }
+
+    //* The same, when value is a T: the compaction uses the vectorized kernels.
+    template <typename T, typename Allocator, typename GrowthPolicy>
+    typename vector<T, Allocator, GrowthPolicy>::size_type erase(vector<T, Allocator, GrowthPolicy> &vec, const T &value)
+    {
+        // Copied first: value may be one of the elements, which the compaction overwrites.
+        const T target(value);
+        T *first{vec.data()};
+        T *last{first + vec.size()};
+        T *kept{kernels::remove(first, last, target)};
+        vec.erase(vec.begin() + (kept - first), vec.end());
+        return static_cast<typename vector<T, Allocator, GrowthPolicy>::size_type>(last - kept);
+    }
+
+} // namespace sc.
+#endif
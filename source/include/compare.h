@@ -0,0 +1,249 @@
+#ifndef _COMPARE_H_
+#define _COMPARE_H_
+
+#include <algorithm>    // std::equal, std::lexicographical_compare
+#include <cstddef>      // std::size_t
+#include <cstring>      // std::memcmp
+#include <type_traits>  // std::is_integral, std::is_enum, std::is_pointer, std::integral_constant
+
+#include "simd.h"       // SC_TARGET, sc::simd::active()
+
+/// Sequence container namespace.
+namespace sc {
+    /// Tells whether two T are equal exactly when their bytes are equal (C++17's has_unique_object_representations).
+    /*!
+     * It holds for integers, enumerations and pointers. Floating-point types do
+     * not qualify (0.0 == -0.0, NaN != NaN), nor do types with padding.
+     * Specialize it to std::true_type for structs that are just packed integers,
+     * so their equality is decided with memcmp.
+     */
+    template <typename T>
+    struct has_unique_representation
+        : std::integral_constant<bool, std::is_integral<T>::value or std::is_enum<T>::value or std::is_pointer<T>::value> {};
+
+    /// Kernels over contiguous ranges of elements (raw pointers, sc::vector::data(), sc::span).
+    namespace kernels {
+        namespace detail {
+            //* How the mismatch search treats a T: 0 = one element at a time with ==, 1 = byte by byte, 2 = float lanes.
+            template <typename T>
+            struct mismatch_kind : std::integral_constant<int,
+                has_unique_representation<T>::value ? 1 :
+                std::is_same<T, float>::value or std::is_same<T, double>::value ? 2 : 0> {};
+
+            //* Portable fallback: index of the first i in [0, n) with not (a[i] == b[i]), or n.
+            template <typename T>
+            std::size_t mismatch_scalar(const T *a, const T *b, std::size_t n)
+            {
+                std::size_t i{0};
+                while (i < n and a[i] == b[i])
+                    ++i;
+                return i;
+            }
+
+#if SC_SIMD_X86
+            // First differing byte: compare a register of bytes, and look for the first zero in the equality mask.
+            SC_TARGET("sse2")
+            inline std::size_t mismatch_bytes_sse2(const unsigned char *a, const unsigned char *b, std::size_t n)
+            {
+                std::size_t i{0};
+                for ( /*empty*/ ; i + 16 <= n ; i += 16) {
+                    __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                                                _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+                    unsigned diff{~static_cast<unsigned>(_mm_movemask_epi8(eq)) & 0xFFFF};
+                    if (diff != 0)
+                        return i + __builtin_ctz(diff);
+                }
+                return i + mismatch_scalar(a + i, b + i, n - i);
+            }
+
+            SC_TARGET("avx2")
+            inline std::size_t mismatch_bytes_avx2(const unsigned char *a, const unsigned char *b, std::size_t n)
+            {
+                std::size_t i{0};
+                for ( /*empty*/ ; i + 32 <= n ; i += 32) {
+                    __m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                                   _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+                    unsigned diff{~static_cast<unsigned>(_mm256_movemask_epi8(eq))};
+                    if (diff != 0)
+                        return i + __builtin_ctz(diff);
+                }
+                return i + mismatch_bytes_sse2(a + i, b + i, n - i);
+            }
+
+            SC_TARGET("avx512f,avx512bw")
+            inline std::size_t mismatch_bytes_avx512(const unsigned char *a, const unsigned char *b, std::size_t n)
+            {
+                std::size_t i{0};
+                for ( /*empty*/ ; i + 64 <= n ; i += 64) {
+                    __mmask64 diff = _mm512_cmpneq_epi8_mask(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+                    if (diff != 0)
+                        return i + __builtin_ctzll(diff);
+                }
+                return i + mismatch_bytes_avx2(a + i, b + i, n - i);
+            }
+
+            // One bit per lane where a and b are not equal (NaN lanes included), one function per register width.
+            SC_TARGET("sse2")
+            inline unsigned neq_mask(const float *a, const float *b, std::integral_constant<int, 16>)
+            {
+                return ~static_cast<unsigned>(_mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)))) & 0xF;
+            }
+            SC_TARGET("sse2")
+            inline unsigned neq_mask(const double *a, const double *b, std::integral_constant<int, 16>)
+            {
+                return ~static_cast<unsigned>(_mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)))) & 0x3;
+            }
+            SC_TARGET("avx2")
+            inline unsigned neq_mask(const float *a, const float *b, std::integral_constant<int, 32>)
+            {
+                return ~static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(a), _mm256_loadu_ps(b), _CMP_EQ_OQ))) & 0xFF;
+            }
+            SC_TARGET("avx2")
+            inline unsigned neq_mask(const double *a, const double *b, std::integral_constant<int, 32>)
+            {
+                return ~static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b), _CMP_EQ_OQ))) & 0xF;
+            }
+            SC_TARGET("avx512f")
+            inline unsigned neq_mask(const float *a, const float *b, std::integral_constant<int, 64>)
+            {
+                return _mm512_cmp_ps_mask(_mm512_loadu_ps(a), _mm512_loadu_ps(b), _CMP_NEQ_UQ);
+            }
+            SC_TARGET("avx512f")
+            inline unsigned neq_mask(const double *a, const double *b, std::integral_constant<int, 64>)
+            {
+                return _mm512_cmp_pd_mask(_mm512_loadu_pd(a), _mm512_loadu_pd(b), _CMP_NEQ_UQ);
+            }
+
+            //* First lane where the floating-point values differ, Width bytes at a time. Each target gets
+            //* its own instantiation, so the narrower paths never contain wider instructions.
+            template <int Width, typename F>
+            inline std::size_t mismatch_float(const F *a, const F *b, std::size_t n)
+            {
+                constexpr std::size_t per_block = Width / sizeof(F);
+                std::size_t i{0};
+                for ( /*empty*/ ; i + per_block <= n ; i += per_block) {
+                    unsigned diff{neq_mask(a + i, b + i, std::integral_constant<int, Width>{})};
+                    if (diff != 0)
+                        return i + __builtin_ctz(diff);
+                }
+                return i + mismatch_scalar(a + i, b + i, n - i);
+            }
+
+            template <typename F>
+            SC_TARGET("sse2")
+            std::size_t mismatch_float_sse2(const F *a, const F *b, std::size_t n) { return mismatch_float<16>(a, b, n); }
+
+            template <typename F>
+            SC_TARGET("avx2")
+            std::size_t mismatch_float_avx2(const F *a, const F *b, std::size_t n) { return mismatch_float<32>(a, b, n); }
+
+            template <typename F>
+            SC_TARGET("avx512f")
+            std::size_t mismatch_float_avx512(const F *a, const F *b, std::size_t n) { return mismatch_float<64>(a, b, n); }
+#endif
+            template <typename T>
+            std::size_t mismatch(const T *a, const T *b, std::size_t n, std::integral_constant<int, 0>)
+            {
+                return mismatch_scalar(a, b, n);
+            }
+
+            template <typename T>
+            std::size_t mismatch(const T *a, const T *b, std::size_t n, std::integral_constant<int, 1>)
+            {
+#if SC_SIMD_X86
+                const unsigned char *x{reinterpret_cast<const unsigned char*>(a)};
+                const unsigned char *y{reinterpret_cast<const unsigned char*>(b)};
+                switch (simd::active()) {
+                    case simd::level::avx512: return mismatch_bytes_avx512(x, y, n * sizeof(T)) / sizeof(T);
+                    case simd::level::avx2:   return mismatch_bytes_avx2(x, y, n * sizeof(T)) / sizeof(T);
+                    case simd::level::sse2:   return mismatch_bytes_sse2(x, y, n * sizeof(T)) / sizeof(T);
+                    default: break;
+                }
+#endif
+                return mismatch_scalar(a, b, n);
+            }
+
+            template <typename T>
+            std::size_t mismatch(const T *a, const T *b, std::size_t n, std::integral_constant<int, 2>)
+            {
+#if SC_SIMD_X86
+                switch (simd::active()) {
+                    case simd::level::avx512: return mismatch_float_avx512(a, b, n);
+                    case simd::level::avx2:   return mismatch_float_avx2(a, b, n);
+                    case simd::level::sse2:   return mismatch_float_sse2(a, b, n);
+                    default: break;
+                }
+#endif
+                return mismatch_scalar(a, b, n);
+            }
+
+            template <typename T>
+            bool equal(const T *a, const T *b, std::size_t n, std::integral_constant<int, 0>)
+            {
+                return std::equal(a, a + n, b);
+            }
+
+            //* Bitwise equality is exactly what memcmp decides, and libc already vectorizes it.
+            template <typename T>
+            bool equal(const T *a, const T *b, std::size_t n, std::integral_constant<int, 1>)
+            {
+                return n == 0 or std::memcmp(a, b, n * sizeof(T)) == 0;
+            }
+
+            template <typename T>
+            bool equal(const T *a, const T *b, std::size_t n, std::integral_constant<int, 2>)
+            {
+                return mismatch(a, b, n, std::integral_constant<int, 2>{}) == n;
+            }
+
+            //* Any other element type only needs operator<, as with std::lexicographical_compare.
+            template <typename T>
+            bool lexicographical_less(const T *a, std::size_t na, const T *b, std::size_t nb, std::integral_constant<int, 0>)
+            {
+                return std::lexicographical_compare(a, a + na, b, b + nb);
+            }
+
+            //* Jumps from mismatch to mismatch. Elements that differ without being ordered (NaN) are skipped,
+            //* which is what std::lexicographical_compare does.
+            template <typename T, int Kind>
+            bool lexicographical_less(const T *a, std::size_t na, const T *b, std::size_t nb, std::integral_constant<int, Kind> kind)
+            {
+                std::size_t n{na < nb ? na : nb};
+                std::size_t i{0};
+                while (true) {
+                    i += mismatch(a + i, b + i, n - i, kind);
+                    if (i == n)
+                        return na < nb;
+                    if (a[i] < b[i])
+                        return true;
+                    if (b[i] < a[i])
+                        return false;
+                    ++i;
+                }
+            }
+        } // namespace detail.
+
+        //* Index of the first position where a and b hold different values, or n if there is none.
+        template <typename T>
+        std::size_t mismatch(const T *a, const T *b, std::size_t n)
+        {
+            return detail::mismatch(a, b, n, detail::mismatch_kind<T>{});
+        }
+
+        //* Whether the n elements of a and b are pairwise equal.
+        template <typename T>
+        bool equal(const T *a, const T *b, std::size_t n)
+        {
+            return detail::equal(a, b, n, detail::mismatch_kind<T>{});
+        }
+
+        //* Whether [a, a+na) comes before [b, b+nb) in lexicographical order.
+        template <typename T>
+        bool lexicographical_less(const T *a, std::size_t na, const T *b, std::size_t nb)
+        {
+            return detail::lexicographical_less(a, na, b, nb, detail::mismatch_kind<T>{});
+        }
+    } // namespace kernels.
+
+} // namespace sc.
+#endif
@@ -0,0 +1,297 @@
+#ifndef _CONCURRENT_VECTOR_H_
+#define _CONCURRENT_VECTOR_H_
+
+#include <atomic>       // std::atomic
+#include <cstddef>      // std::size_t
+#include <memory>       // std::allocator, std::allocator_traits
+#include <stdexcept>    // std::out_of_range
+#include <utility>      // std::move, std::forward
+
+#include "vector.h"             // sc::select_allocator
+#include "segmented_vector.h"   // sc::segmented_detail
+
+/// Sequence container namespace.
+namespace sc {
+    /// An append-only sequence that many threads can grow and read at the same time, without locks.
+    /*!
+     * A mutex around sc::vector serializes every producer, and a reader that
+     * races with push_back may touch a block that reserve() just freed.
+     * concurrent_vector never moves an element: it keeps them in chunks of
+     * B, B, 2B, 4B, ... elements (the layout of sc::segmented_vector), found
+     * through a fixed directory of atomic chunk pointers.
+     *
+     * - push_back/emplace_back/grow_by claim slots with one fetch_add on an
+     *   atomic counter. The thread that first needs a chunk allocates it and
+     *   installs it with a compare-and-swap; a thread that loses the race
+     *   frees its copy and uses the winner's. No thread ever waits for another.
+     * - Each slot has a ready flag, set once its element is constructed; an
+     *   append is one fetch_add, the construction and one release store.
+     * - size() is the length of the prefix of ready slots. Writers do not
+     *   maintain it: each call to size() walks the flags that became ready
+     *   since the last one and moves the shared count forward with a
+     *   compare-and-swap, so it is lock-free and amortized O(1).
+     * - operator[] on a published index is wait-free: a count-leading-zeros,
+     *   one atomic load of the chunk pointer and the access.
+     *
+     *     sc::concurrent_vector<event> log;
+     *     // From any number of threads:
+     *     auto i = log.push_back(e);       // log[i] is readable from here on.
+     *     // From any other thread:
+     *     for (std::size_t j = 0 ; j < log.size() ; ++j) consume(log[j]);
+     *
+     * Elements can not be erased while other threads use the container;
+     * clear() and the destructor need exclusive access. If an element's
+     * constructor throws, its slot never becomes ready and size() stops
+     * before it (the elements after it are still reachable through
+     * is_published()).
+     *
+     * \tparam T The type of the elements.
+     * \tparam Allocator The allocator of the chunks (or a recipe such as sc::aligned<64>).
+     */
+    template <typename T, typename Allocator = std::allocator<T>>
+    class concurrent_vector
+    {
+        //=== Aliases
+        public:
+            using size_type = unsigned long;        //!< The size type.
+            using value_type = T;                   //!< The value type.
+            using allocator_type = typename select_allocator<T, Allocator>::type; //!< The allocator type.
+            using pointer = value_type*;            //!< Pointer to a value stored in the container.
+            using reference = value_type&;          //!< Reference to a value stored in the container.
+            using const_reference = const value_type&; //!< Const reference to a value stored in the container.
+
+            //* Elements in each of the first two chunks: about 512 bytes' worth, rounded down to a power of two.
+            static constexpr size_type first_chunk = segmented_detail::floor_pow2(sizeof(T) >= 512 ? 1 : 512 / sizeof(T));
+
+            //* Entries of the chunk directory; enough to address every size_type index.
+            static constexpr size_type max_chunks = 65;
+
+        private:
+            using alloc_traits = std::allocator_traits<allocator_type>; //!< Uniform interface to the allocator.
+
+            //* A chunk: its elements and one ready flag per element.
+            struct chunk
+            {
+                pointer data;                           //!< Raw storage for chunk_size(k) elements.
+                std::atomic<unsigned char> *ready;      //!< 1 once the element in the slot is constructed.
+            };
+
+        public:
+            //!=== [I] Special members
+            //* An empty container, without memory.
+            concurrent_vector(void) : m_alloc{} { init(); }
+
+            explicit concurrent_vector(const allocator_type &alloc) : m_alloc{alloc} { init(); }
+
+            concurrent_vector(const concurrent_vector &) = delete;
+            concurrent_vector &operator=(const concurrent_vector &) = delete;
+
+            ~concurrent_vector(void) { release(); }
+
+            //!=== [II] Capacity
+            //* Number of published elements: [0, size()) are constructed and visible to the caller.
+            size_type size(void) const
+            {
+                size_type p{m_published.load(std::memory_order_acquire)};
+                for ( ;; ) {
+                    size_type q{p};
+                    while (ready(q))
+                        ++q;
+                    if (q == p)
+                        return p;
+                    // On failure p is reloaded: another reader moved it, so walk again from there.
+                    if (m_published.compare_exchange_weak(p, q, std::memory_order_acq_rel, std::memory_order_acquire))
+                        return q;
+                }
+            }
+
+            bool empty(void) const { return size() == 0; }
+
+            //* Number of slots handed out, including those still being constructed.
+            size_type claimed(void) const { return m_claimed.load(std::memory_order_relaxed); }
+
+            //* Number of elements the allocated chunks hold.
+            size_type capacity(void) const
+            {
+                size_type k{0};
+                while (k < max_chunks and m_chunks[k].load(std::memory_order_acquire) != nullptr)
+                    ++k;
+                return chunk_start(k);
+            }
+
+            //* Allocates the chunks for cap elements up front. Safe to call concurrently with appends.
+            void reserve(size_type cap)
+            {
+                for (size_type k{0} ; cap > 0 and chunk_start(k) < cap ; ++k)
+                    get_chunk(k);
+            }
+
+            //!=== [III] Modifiers
+            //* Appends an element built from args. Returns its index; the element is readable once this returns.
+            template <typename... Args>
+            size_type emplace_back(Args&&... args)
+            {
+                size_type pos{m_claimed.fetch_add(1, std::memory_order_relaxed)};
+                size_type k{chunk_of(pos)};
+                chunk *c{get_chunk(k)};
+                size_type offset{pos - chunk_start(k)};
+                alloc_traits::construct(m_alloc, c->data + offset, std::forward<Args>(args)...);
+                c->ready[offset].store(1, std::memory_order_release);
+                return pos;
+            }
+
+            size_type push_back(const T &value) { return emplace_back(value); }
+            size_type push_back(T &&value) { return emplace_back(std::move(value)); }
+
+            //* Appends n value-initialized elements in consecutive slots. Returns the index of the first.
+            size_type grow_by(size_type n) { return grow(n, [](pointer at, allocator_type &alloc) { alloc_traits::construct(alloc, at); }); }
+
+            //* Appends n copies of value in consecutive slots. Returns the index of the first.
+            size_type grow_by(size_type n, const T &value)
+            {
+                return grow(n, [&value](pointer at, allocator_type &alloc) { alloc_traits::construct(alloc, at, value); });
+            }
+
+            //* Destroys the elements and keeps the chunks. Not thread-safe: needs exclusive access.
+            void clear(void)
+            {
+                size_type n{m_claimed.load(std::memory_order_relaxed)};
+                for (size_type pos{0} ; pos < n ; ++pos) {
+                    chunk *c{m_chunks[chunk_of(pos)].load(std::memory_order_relaxed)};
+                    size_type offset{pos - chunk_start(chunk_of(pos))};
+                    if (c != nullptr and c->ready[offset].load(std::memory_order_relaxed)) {
+                        alloc_traits::destroy(m_alloc, c->data + offset);
+                        c->ready[offset].store(0, std::memory_order_relaxed);
+                    }
+                }
+                m_claimed.store(0, std::memory_order_relaxed);
+                m_published.store(0, std::memory_order_release);
+            }
+
+            //!=== [IV] Element access
+            //* Element pos, which must be published (pos < size(), or returned by an append that happened before). Wait-free.
+            reference operator[](size_type pos) { return *address(pos); }
+            const_reference operator[](size_type pos) const { return *address(pos); }
+
+            reference at(size_type pos)
+            {
+                if (pos >= size())
+                    throw std::out_of_range("[concurrent_vector::at(pos)]: position provided is not a published element");
+                return *address(pos);
+            }
+
+            const_reference at(size_type pos) const
+            {
+                if (pos >= size())
+                    throw std::out_of_range("[concurrent_vector::at(pos)]: position provided is not a published element");
+                return *address(pos);
+            }
+
+            //* Whether the element in slot pos is constructed, even if an earlier slot is not yet.
+            bool is_published(size_type pos) const
+            {
+                return pos < m_claimed.load(std::memory_order_acquire) and ready(pos);
+            }
+
+        private:
+            //!=== Chunk arithmetic
+            static size_type chunk_of(size_type pos) { return segmented_detail::chunk_of(pos, first_chunk); }
+            static size_type chunk_start(size_type k) { return segmented_detail::chunk_start(k, first_chunk); }
+            static size_type chunk_size(size_type k) { return segmented_detail::chunk_size(k, first_chunk); }
+
+            void init(void)
+            {
+                for (size_type k{0} ; k < max_chunks ; ++k)
+                    m_chunks[k].store(nullptr, std::memory_order_relaxed);
+                m_claimed.store(0, std::memory_order_relaxed);
+                m_published.store(0, std::memory_order_relaxed);
+            }
+
+            pointer address(size_type pos) const
+            {
+                size_type k{chunk_of(pos)};
+                return m_chunks[k].load(std::memory_order_acquire)->data + (pos - chunk_start(k));
+            }
+
+            //* Chunk k, allocating and installing it if no thread has yet.
+            chunk *get_chunk(size_type k)
+            {
+                chunk *current{m_chunks[k].load(std::memory_order_acquire)};
+                if (current != nullptr)
+                    return current;
+                chunk *fresh{new chunk{nullptr, nullptr}};
+                try {
+                    fresh->data = alloc_traits::allocate(m_alloc, chunk_size(k));
+                    fresh->ready = new std::atomic<unsigned char>[chunk_size(k)]();
+                }
+                catch (...) {
+                    free_chunk(fresh, k);
+                    throw;
+                }
+                if (m_chunks[k].compare_exchange_strong(current, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+                    return fresh;
+                // Another thread installed chunk k first: use it.
+                free_chunk(fresh, k);
+                return current;
+            }
+
+            void free_chunk(chunk *c, size_type k)
+            {
+                if (c->data != nullptr)
+                    alloc_traits::deallocate(m_alloc, c->data, chunk_size(k));
+                delete[] c->ready;
+                delete c;
+            }
+
+            //* Whether the element in slot pos is constructed; acquires it if so.
+            bool ready(size_type pos) const
+            {
+                chunk *c{m_chunks[chunk_of(pos)].load(std::memory_order_acquire)};
+                return c != nullptr and c->ready[pos - chunk_start(chunk_of(pos))].load(std::memory_order_acquire) != 0;
+            }
+
+            //* Claims n consecutive slots and constructs each with make(address, allocator), a chunk at a time.
+            template <typename Make>
+            size_type grow(size_type n, Make make)
+            {
+                size_type first{m_claimed.fetch_add(n, std::memory_order_relaxed)};
+                size_type pos{first};
+                while (pos < first + n) {
+                    size_type k{chunk_of(pos)};
+                    chunk *c{get_chunk(k)};
+                    size_type end{chunk_start(k) + chunk_size(k)};
+                    if (end > first + n)
+                        end = first + n;
+                    for ( /*empty*/ ; pos < end ; ++pos) {
+                        size_type offset{pos - chunk_start(k)};
+                        make(c->data + offset, m_alloc);
+                        c->ready[offset].store(1, std::memory_order_release);
+                    }
+                }
+                return first;
+            }
+
+            void release(void)
+            {
+                clear();
+                for (size_type k{0} ; k < max_chunks ; ++k) {
+                    chunk *c{m_chunks[k].load(std::memory_order_relaxed)};
+                    if (c != nullptr)
+                        free_chunk(c, k);
+                }
+            }
+
+            std::atomic<chunk *> m_chunks[max_chunks];  //!< The chunk directory; entries never change once set.
+            std::atomic<size_type> m_claimed;           //!< Slots handed out to appending threads.
+            mutable std::atomic<size_type> m_published; //!< A prefix of constructed elements; size() extends it.
+            allocator_type m_alloc;                     //!< Allocates the chunks (stateless allocators only for concurrent use).
+    };
+
+    template <typename T, typename Allocator>
+    constexpr typename concurrent_vector<T, Allocator>::size_type concurrent_vector<T, Allocator>::first_chunk;
+
+    template <typename T, typename Allocator>
+    constexpr typename concurrent_vector<T, Allocator>::size_type concurrent_vector<T, Allocator>::max_chunks;
+
+} // namespace sc.
+#endif
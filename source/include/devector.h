@@ -0,0 +1,471 @@
+#ifndef _DEVECTOR_H_
+#define _DEVECTOR_H_
+
+#include <algorithm>    // std::move, std::move_backward, std::equal
+#include <cstddef>      // std::size_t, std::ptrdiff_t
+#include <cstring>      // std::memmove, std::memcpy
+#include <initializer_list> // std::initializer_list
+#include <memory>       // std::allocator, std::allocator_traits
+#include <stdexcept>    // std::out_of_range, std::length_error
+#include <type_traits>  // std::enable_if, std::is_integral, std::integral_constant
+#include <utility>      // std::move, std::forward, std::move_if_noexcept, std::swap
+
+#include "vector.h"     // sc::MyForwardIterator, sc::is_trivially_relocatable, sc::select_allocator
+#include "growth_policy.h" // sc::growth::doubling
+#include "checks.h"     // SC_EXPECTS, SC_EXPECTS_NONEMPTY
+
+/// Sequence container namespace.
+namespace sc {
+    /// A contiguous sequence with spare capacity at both ends: O(1) amortized insertion and removal at either end.
+    /*!
+     * sc::vector only has room at the back, so insert(begin(), x) shifts every
+     * element and a sliding window (push_back + erase(begin())) is O(n) per
+     * step. devector keeps its elements in the middle of the block, between a
+     * front gap and a back gap. push_front/pop_front move no other element,
+     * and a middle insertion or erasure shifts whichever side is shorter.
+     *
+     * When an end runs out of room and the block is at most half full, the
+     * elements are re-centred in the same block (one memmove for trivially
+     * relocatable types); otherwise the block grows with GrowthPolicy and the
+     * elements land in the middle of it. Either way the next re-balance is at
+     * least a quarter of the capacity away, so both ends stay amortized O(1).
+     *
+     * The elements are always contiguous: data() can be handed to C APIs.
+     *
+     * \tparam T The type of the elements.
+     * \tparam Allocator The allocator (or a recipe such as sc::aligned<64>).
+     * \tparam GrowthPolicy How the block grows; see growth_policy.h.
+     */
+    template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = growth::doubling>
+    class devector
+    {
+        //=== Aliases
+        public:
+            using size_type = unsigned long;        //!< The size type.
+            using value_type = T;                   //!< The value type.
+            using allocator_type = typename select_allocator<T, Allocator>::type; //!< The allocator type.
+            using growth_policy = GrowthPolicy;     //!< The growth policy type.
+            using pointer = value_type*;            //!< Pointer to a value stored in the container.
+            using const_pointer = const value_type*; //!< Const pointer to a value stored in the container.
+            using reference = value_type&;          //!< Reference to a value stored in the container.
+            using const_reference = const value_type&; //!< Const reference to a value stored in the container.
+
+            using iterator = MyForwardIterator<value_type>;             //!< The iterator.
+            using const_iterator = MyForwardIterator<const value_type>; //!< The const_iterator.
+
+        private:
+            using alloc_traits = std::allocator_traits<allocator_type>; //!< Uniform interface to the allocator.
+            //* Elements may be moved around with memmove.
+            using relocatable = std::integral_constant<bool, is_trivially_relocatable<T>::value>;
+
+        public:
+            //!=== [I] Special members
+            //* An empty devector, without memory.
+            devector(void) : m_storage{nullptr}, m_capacity{0}, m_first{0}, m_last{0}, m_alloc{} { /* empty */ }
+
+            //* An empty devector that uses a copy of alloc.
+            explicit devector(const allocator_type &alloc)
+                : m_storage{nullptr}, m_capacity{0}, m_first{0}, m_last{0}, m_alloc{alloc} { /* empty */ }
+
+            //* count copies of value.
+            devector(size_type count, const_reference value, const allocator_type &alloc = allocator_type())
+                : devector(alloc)
+            {
+                reserve(count);
+                for (size_type i{0} ; i < count ; ++i)
+                    push_back(value);
+            }
+
+            //* The elements of [first, last).
+            template <typename InputItr,
+                      typename = typename std::enable_if<not std::is_integral<InputItr>::value>::type>
+            devector(InputItr first, InputItr last, const allocator_type &alloc = allocator_type())
+                : devector(alloc)
+            {
+                for ( /*empty*/ ; first != last ; ++first)
+                    push_back(*first);
+            }
+
+            devector(std::initializer_list<T> il, const allocator_type &alloc = allocator_type())
+                : devector(alloc)
+            {
+                reserve(il.size());
+                for (const T &value : il)
+                    push_back(value);
+            }
+
+            devector(const devector &other)
+                : devector(alloc_traits::select_on_container_copy_construction(other.m_alloc))
+            {
+                reserve(other.size());
+                for (const T &value : other)
+                    push_back(value);
+            }
+
+            //* Steals the block of other, which is left empty.
+            devector(devector &&other) noexcept
+                : m_storage{other.m_storage}, m_capacity{other.m_capacity},
+                  m_first{other.m_first}, m_last{other.m_last}, m_alloc{std::move(other.m_alloc)}
+            {
+                other.m_storage = nullptr;
+                other.m_capacity = other.m_first = other.m_last = 0;
+            }
+
+            ~devector(void) { release(); }
+
+            devector &operator=(devector other)
+            {
+                swap(*this, other);
+                return *this;
+            }
+
+            allocator_type get_allocator(void) const { return m_alloc; }
+
+            //!=== [II] Iterators
+            iterator begin(void) { return iterator(m_storage + m_first); }
+            iterator end(void) { return iterator(m_storage + m_last); }
+            const_iterator begin(void) const { return const_iterator(m_storage + m_first); }
+            const_iterator end(void) const { return const_iterator(m_storage + m_last); }
+            const_iterator cbegin(void) const { return begin(); }
+            const_iterator cend(void) const { return end(); }
+
+            //!=== [III] Capacity
+            size_type size(void) const { return m_last - m_first; }
+            bool empty(void) const { return m_first == m_last; }
+            size_type capacity(void) const { return m_capacity; }
+
+            //* Elements that push_front can add before the block is re-balanced.
+            size_type front_capacity(void) const { return m_first; }
+
+            //* Elements that push_back can add before the block is re-balanced.
+            size_type back_capacity(void) const { return m_capacity - m_last; }
+
+            //* The block will hold at least cap elements; the front gap is kept.
+            void reserve(size_type cap)
+            {
+                if (cap > m_capacity)
+                    rebalance(cap, m_first);
+            }
+
+            //* Room for n push_front without a re-balance.
+            void reserve_front(size_type n) { make_room_front(n); }
+
+            //* Room for n push_back without a re-balance.
+            void reserve_back(size_type n) { make_room_back(n); }
+
+            //* Drops both gaps: capacity() becomes size().
+            void shrink_to_fit(void)
+            {
+                if (size() < m_capacity)
+                    rebalance(size(), 0);
+            }
+
+            //!=== [IV] Modifiers
+            //* Destroys the elements and centres the empty range in the block.
+            void clear(void)
+            {
+                destroy_range(m_first, m_last);
+                m_first = m_last = m_capacity / 2;
+            }
+
+            template <typename... Args>
+            reference emplace_back(Args&&... args)
+            {
+                if (m_last == m_capacity) {
+                    // args may refer to an element, which the re-balance would move.
+                    value_type value(std::forward<Args>(args)...);
+                    make_room_back(1);
+                    alloc_traits::construct(m_alloc, m_storage + m_last, std::move(value));
+                }
+                else {
+                    alloc_traits::construct(m_alloc, m_storage + m_last, std::forward<Args>(args)...);
+                }
+                return m_storage[m_last++];
+            }
+
+            template <typename... Args>
+            reference emplace_front(Args&&... args)
+            {
+                if (m_first == 0) {
+                    value_type value(std::forward<Args>(args)...);
+                    make_room_front(1);
+                    alloc_traits::construct(m_alloc, m_storage + m_first - 1, std::move(value));
+                }
+                else {
+                    alloc_traits::construct(m_alloc, m_storage + m_first - 1, std::forward<Args>(args)...);
+                }
+                return m_storage[--m_first];
+            }
+
+            void push_back(const_reference value) { emplace_back(value); }
+            void push_back(value_type &&value) { emplace_back(std::move(value)); }
+            void push_front(const_reference value) { emplace_front(value); }
+            void push_front(value_type &&value) { emplace_front(std::move(value)); }
+
+            void pop_back(void)
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[devector::pop_back()]: Can not remove an element from an empty devector.");
+                alloc_traits::destroy(m_alloc, m_storage + --m_last);
+            }
+
+            void pop_front(void)
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[devector::pop_front()]: Can not remove an element from an empty devector.");
+                alloc_traits::destroy(m_alloc, m_storage + m_first++);
+            }
+
+            //* Inserts an element built from args before pos, shifting the shorter side. Returns an iterator to it.
+            template <typename... Args>
+            iterator emplace(const_iterator pos, Args&&... args)
+            {
+                size_type at{index_of(pos)};
+                value_type value(std::forward<Args>(args)...);
+                if (at == size()) {
+                    emplace_back(std::move(value));
+                }
+                else if (at == 0) {
+                    emplace_front(std::move(value));
+                }
+                else if (at < size() / 2) {
+                    make_room_front(1);
+                    pointer first{m_storage + m_first};
+                    alloc_traits::construct(m_alloc, first - 1, std::move(*first));
+                    --m_first;
+                    std::move(first + 1, first + at, first);
+                    first[at - 1] = std::move(value);
+                }
+                else {
+                    make_room_back(1);
+                    pointer last{m_storage + m_last};
+                    alloc_traits::construct(m_alloc, last, std::move(last[-1]));
+                    ++m_last;
+                    std::move_backward(m_storage + m_first + at, last - 1, last);
+                    m_storage[m_first + at] = std::move(value);
+                }
+                return iterator(m_storage + m_first + at);
+            }
+
+            template <typename... Args>
+            iterator emplace(iterator pos, Args&&... args) { return emplace(const_iterator(&pos), std::forward<Args>(args)...); }
+
+            iterator insert(const_iterator pos, const_reference value) { return emplace(pos, value); }
+            iterator insert(iterator pos, const_reference value) { return emplace(pos, value); }
+            iterator insert(const_iterator pos, value_type &&value) { return emplace(pos, std::move(value)); }
+            iterator insert(iterator pos, value_type &&value) { return emplace(pos, std::move(value)); }
+
+            //* Removes [first, last), shifting the shorter side. Returns the iterator following them.
+            iterator erase(const_iterator first, const_iterator last)
+            {
+                size_type lo{index_of(first)};
+                size_type hi{index_of(last)};
+                SC_EXPECTS(lo <= hi, std::out_of_range, "[devector::erase()]: range provided is out of container range");
+                size_type n{hi - lo};
+                if (n == 0)
+                    return iterator(m_storage + m_first + lo);
+                if (lo < size() - hi) {
+                    // Fewer elements before the gap: slide them forward.
+                    std::move_backward(m_storage + m_first, m_storage + m_first + lo, m_storage + m_first + hi);
+                    destroy_range(m_first, m_first + n);
+                    m_first += n;
+                }
+                else {
+                    std::move(m_storage + m_first + hi, m_storage + m_last, m_storage + m_first + lo);
+                    destroy_range(m_last - n, m_last);
+                    m_last -= n;
+                }
+                return iterator(m_storage + m_first + lo);
+            }
+
+            iterator erase(iterator first, iterator last) { return erase(const_iterator(&first), const_iterator(&last)); }
+            iterator erase(const_iterator pos)
+            {
+                SC_EXPECTS(index_of(pos) < size(), std::out_of_range, "[devector::erase()]: position provided is out of container range");
+                return erase(pos, pos + 1);
+            }
+
+            iterator erase(iterator pos) { return erase(const_iterator(&pos)); }
+
+            friend void swap(devector &a, devector &b)
+            {
+                using std::swap;
+                swap(a.m_storage, b.m_storage);
+                swap(a.m_capacity, b.m_capacity);
+                swap(a.m_first, b.m_first);
+                swap(a.m_last, b.m_last);
+                swap(a.m_alloc, b.m_alloc);
+            }
+
+            //!=== [V] Element access
+            //* Element pos. Checked according to SC_BOUNDS_CHECK.
+            reference operator[](size_type pos)
+            {
+                SC_EXPECTS(pos < size(), std::out_of_range, "[devector::operator[]]: position provided is out of container range");
+                return m_storage[m_first + pos];
+            }
+
+            const_reference operator[](size_type pos) const
+            {
+                SC_EXPECTS(pos < size(), std::out_of_range, "[devector::operator[]]: position provided is out of container range");
+                return m_storage[m_first + pos];
+            }
+
+            reference at(size_type pos)
+            {
+                if (pos >= size())
+                    throw std::out_of_range("[devector::at(pos)]: position provided is out of container range");
+                return m_storage[m_first + pos];
+            }
+
+            const_reference at(size_type pos) const
+            {
+                if (pos >= size())
+                    throw std::out_of_range("[devector::at(pos)]: position provided is out of container range");
+                return m_storage[m_first + pos];
+            }
+
+            reference front(void)
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[devector::front()]: empty devector.");
+                return m_storage[m_first];
+            }
+
+            const_reference front(void) const
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[devector::front()]: empty devector.");
+                return m_storage[m_first];
+            }
+
+            reference back(void)
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[devector::back()]: empty devector.");
+                return m_storage[m_last - 1];
+            }
+
+            const_reference back(void) const
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[devector::back()]: empty devector.");
+                return m_storage[m_last - 1];
+            }
+
+            //* The first element; the elements are contiguous.
+            pointer data(void) { return m_storage + m_first; }
+            const_pointer data(void) const { return m_storage + m_first; }
+
+            friend bool operator==(const devector &a, const devector &b)
+            {
+                return a.size() == b.size() and std::equal(a.data(), a.data() + a.size(), b.data());
+            }
+
+            friend bool operator!=(const devector &a, const devector &b) { return not (a == b); }
+
+        private:
+            //* Index of pos, which must be in [begin(), end()]. Checked according to SC_BOUNDS_CHECK.
+            size_type index_of(const_iterator pos) const
+            {
+                SC_EXPECTS(m_storage + m_first <= &pos and &pos <= m_storage + m_last, std::out_of_range,
+                           "[devector]: iterator provided is out of container range");
+                return static_cast<size_type>(&pos - (m_storage + m_first));
+            }
+
+            //* Destroys the live elements in [first, last) (block offsets).
+            void destroy_range(size_type first, size_type last)
+            {
+                for ( /*empty*/ ; first < last ; ++first)
+                    alloc_traits::destroy(m_alloc, m_storage + first);
+            }
+
+            //* Destroys every element and gives the block back. Members are left dangling.
+            void release(void)
+            {
+                destroy_range(m_first, m_last);
+                if (m_storage != nullptr)
+                    alloc_traits::deallocate(m_alloc, m_storage, m_capacity);
+            }
+
+            //* The capacity to grow to when required elements must fit.
+            size_type next_capacity(size_type required) const
+            {
+                size_type proposed = growth_policy::grow(m_capacity, required, sizeof(T));
+                return proposed < required ? required : proposed;
+            }
+
+            //* Ensures n free slots after the last element.
+            void make_room_back(size_type n)
+            {
+                if (m_capacity - m_last >= n)
+                    return;
+                size_type needed{size() + n};
+                size_type cap{needed <= m_capacity / 2 ? m_capacity : next_capacity(needed)};
+                rebalance(cap, (cap - needed) / 2);
+            }
+
+            //* Ensures n free slots before the first element.
+            void make_room_front(size_type n)
+            {
+                if (m_first >= n)
+                    return;
+                size_type needed{size() + n};
+                size_type cap{needed <= m_capacity / 2 ? m_capacity : next_capacity(needed)};
+                rebalance(cap, cap - size() - (cap - needed) / 2);
+            }
+
+            //* Moves the elements to [new_first, new_first + size()) of a block of new_cap elements.
+            void rebalance(size_type new_cap, size_type new_first)
+            {
+                rebalance(new_cap, new_first, relocatable{});
+            }
+
+            //* Fast path: one memmove, in place when the capacity does not change.
+            void rebalance(size_type new_cap, size_type new_first, std::true_type)
+            {
+                size_type n{size()};
+                if (new_cap == m_capacity) {
+                    if (n != 0)
+                        std::memmove(static_cast<void *>(m_storage + new_first), m_storage + m_first, n * sizeof(T));
+                }
+                else {
+                    pointer block{new_cap == 0 ? nullptr : alloc_traits::allocate(m_alloc, new_cap)};
+                    if (n != 0)
+                        std::memcpy(static_cast<void *>(block + new_first), m_storage + m_first, n * sizeof(T));
+                    if (m_storage != nullptr)
+                        alloc_traits::deallocate(m_alloc, m_storage, m_capacity);
+                    m_storage = block;
+                    m_capacity = new_cap;
+                }
+                m_first = new_first;
+                m_last = new_first + n;
+            }
+
+            //* Elements are copied instead if their move constructor may throw, so a failure leaves *this intact.
+            void rebalance(size_type new_cap, size_type new_first, std::false_type)
+            {
+                size_type n{size()};
+                pointer block{new_cap == 0 ? nullptr : alloc_traits::allocate(m_alloc, new_cap)};
+                size_type i{0};
+                try {
+                    for ( /*empty*/ ; i < n ; ++i)
+                        alloc_traits::construct(m_alloc, block + new_first + i, std::move_if_noexcept(m_storage[m_first + i]));
+                }
+                catch (...) {
+                    for (size_type j{0} ; j < i ; ++j)
+                        alloc_traits::destroy(m_alloc, block + new_first + j);
+                    if (block != nullptr)
+                        alloc_traits::deallocate(m_alloc, block, new_cap);
+                    throw;
+                }
+                release();
+                m_storage = block;
+                m_capacity = new_cap;
+                m_first = new_first;
+                m_last = new_first + n;
+            }
+
+            pointer m_storage;      //!< The block.
+            size_type m_capacity;   //!< Number of elements the block holds.
+            size_type m_first;      //!< Offset of the first element; the front gap.
+            size_type m_last;       //!< Offset past the last element.
+            allocator_type m_alloc; //!< Allocates the block.
+    };
+
+} // namespace sc.
+#endif
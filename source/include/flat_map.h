@@ -0,0 +1,391 @@
+#ifndef _FLAT_MAP_H_
+#define _FLAT_MAP_H_
+
+#include <algorithm>    // std::stable_sort
+#include <cstddef>      // std::size_t, std::ptrdiff_t
+#include <functional>   // std::less
+#include <initializer_list> // std::initializer_list
+#include <iterator>     // std::random_access_iterator_tag
+#include <stdexcept>    // std::out_of_range
+#include <type_traits>  // std::enable_if, std::is_const
+#include <utility>      // std::pair, std::move, std::forward
+
+#include "vector.h"     // sc::vector
+#include "kernels.h"    // sc::kernels::lower_bound, sc::kernels::upper_bound
+
+/// Sequence container namespace.
+namespace sc {
+    /// Iterator over a flat_map: walks the key and the value arrays side by side.
+    /*!
+     * Dereferencing gives a std::pair<const Key&, V&> built on the fly, not a
+     * reference to a stored pair, since keys and values live in separate arrays.
+     * `it->second = x` and `(*it).first` work as with std::map; binding
+     * `auto &kv = *it` does not (use `auto kv = *it`).
+     *
+     * \tparam Key The key type.
+     * \tparam V The mapped type, const for the const_iterator.
+     */
+    template <typename Key, typename V>
+    class flat_map_iterator
+    {
+        public:
+            using self_type = flat_map_iterator;
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::pair<const Key&, V&>;
+            using reference = value_type;
+            using iterator_category = std::random_access_iterator_tag;
+
+            /// What operator-> points to: a pair of references that lives as long as the expression.
+            struct pointer
+            {
+                reference ref;
+                reference *operator->(void) { return &ref; }
+            };
+
+            flat_map_iterator(void) : m_key{nullptr}, m_value{nullptr} { /* empty */ }
+            flat_map_iterator(const Key *key, V *value) : m_key{key}, m_value{value} { /* empty */ }
+
+            //* An iterator converts to a const_iterator.
+            template <typename W, typename = typename std::enable_if<std::is_const<V>::value and std::is_same<const W, V>::value>::type>
+            flat_map_iterator(const flat_map_iterator<Key, W> &other) : m_key{other.key_ptr()}, m_value{other.value_ptr()} { /* empty */ }
+
+            reference operator*(void) const { return reference(*m_key, *m_value); }
+            pointer operator->(void) const { return pointer{reference(*m_key, *m_value)}; }
+            reference operator[](difference_type n) const { return reference(m_key[n], m_value[n]); }
+
+            self_type &operator++(void) { ++m_key; ++m_value; return *this; }
+            self_type operator++(int) { self_type old{*this}; ++*this; return old; }
+            self_type &operator--(void) { --m_key; --m_value; return *this; }
+            self_type operator--(int) { self_type old{*this}; --*this; return old; }
+            self_type &operator+=(difference_type n) { m_key += n; m_value += n; return *this; }
+            self_type &operator-=(difference_type n) { m_key -= n; m_value -= n; return *this; }
+
+            friend self_type operator+(self_type it, difference_type n) { return it += n; }
+            friend self_type operator+(difference_type n, self_type it) { return it += n; }
+            friend self_type operator-(self_type it, difference_type n) { return it -= n; }
+            friend difference_type operator-(const self_type &a, const self_type &b) { return a.m_key - b.m_key; }
+
+            friend bool operator==(const self_type &a, const self_type &b) { return a.m_key == b.m_key; }
+            friend bool operator!=(const self_type &a, const self_type &b) { return a.m_key != b.m_key; }
+            friend bool operator<(const self_type &a, const self_type &b) { return a.m_key < b.m_key; }
+            friend bool operator>(const self_type &a, const self_type &b) { return a.m_key > b.m_key; }
+            friend bool operator<=(const self_type &a, const self_type &b) { return a.m_key <= b.m_key; }
+            friend bool operator>=(const self_type &a, const self_type &b) { return a.m_key >= b.m_key; }
+
+            const Key *key_ptr(void) const { return m_key; }
+            V *value_ptr(void) const { return m_value; }
+
+        private:
+            const Key *m_key;   //!< The key of the current element.
+            V *m_value;         //!< The value of the current element.
+    };
+
+    /// A sorted map of unique keys, with the keys and the values in two separate sc::vector.
+    /*!
+     * Lookups binary-search the key array only, which is dense (no values in
+     * between) and branch-free (see kernels::lower_bound); the value is then
+     * read at the same index. As with flat_set, single insertions and erasures
+     * shift the elements after them, and the bulk insert(first, last) sorts the
+     * new entries on their own and merges them with the stored ones in one pass.
+     *
+     *     sc::flat_map<std::uint64_t, double> prices;
+     *     prices.insert(batch.begin(), batch.end());
+     *     if (prices.contains(id)) total += prices.at(id);
+     *
+     * Iterators and references are invalidated by every insertion and erasure.
+     *
+     * \tparam Key The type of the keys.
+     * \tparam T The mapped type.
+     * \tparam Compare The strict weak ordering of the keys.
+     * \tparam KeyContainer The sorted keys; any sc::vector.
+     * \tparam MappedContainer The values, in the order of their keys; any sc::vector.
+     */
+    template <typename Key, typename T, typename Compare = std::less<Key>,
+              typename KeyContainer = vector<Key>, typename MappedContainer = vector<T>>
+    class flat_map
+    {
+        //=== Aliases
+        public:
+            using key_type = Key;                                   //!< The key type.
+            using mapped_type = T;                                  //!< The mapped type.
+            using value_type = std::pair<Key, T>;                   //!< What insert() takes.
+            using key_compare = Compare;                            //!< The ordering of the keys.
+            using key_container_type = KeyContainer;                //!< The storage of the keys.
+            using mapped_container_type = MappedContainer;          //!< The storage of the values.
+            using size_type = typename KeyContainer::size_type;     //!< The size type.
+            using iterator = flat_map_iterator<Key, T>;             //!< Iterator over (key, value), in key order.
+            using const_iterator = flat_map_iterator<Key, const T>; //!< Read-only iterator.
+
+        public:
+            //!=== [I] Special members
+            //* An empty map.
+            flat_map(void) : m_comp{} { /* empty */ }
+
+            //* An empty map ordered by comp.
+            explicit flat_map(const Compare &comp) : m_comp{comp} { /* empty */ }
+
+            //* A map with the (key, value) pairs of [first, last); the first of equivalent keys is kept.
+            template <typename InputItr>
+            flat_map(InputItr first, InputItr last, const Compare &comp = Compare()) : m_comp{comp}
+            {
+                insert(first, last);
+            }
+
+            //* A map with the pairs of the list.
+            flat_map(std::initializer_list<value_type> il, const Compare &comp = Compare()) : m_comp{comp}
+            {
+                insert(il.begin(), il.end());
+            }
+
+            //!=== [II] Iterators
+            iterator begin(void) { return iterator(m_keys.data(), m_values.data()); }
+            iterator end(void) { return begin() + static_cast<std::ptrdiff_t>(size()); }
+            const_iterator begin(void) const { return const_iterator(m_keys.data(), m_values.data()); }
+            const_iterator end(void) const { return begin() + static_cast<std::ptrdiff_t>(size()); }
+            const_iterator cbegin(void) const { return begin(); }
+            const_iterator cend(void) const { return end(); }
+
+            //!=== [III] Capacity
+            size_type size(void) const { return m_keys.size(); }
+            bool empty(void) const { return m_keys.empty(); }
+            size_type capacity(void) const { return m_keys.capacity(); }
+
+            //* Makes room for cap entries in both arrays, so that many insertions do not reallocate.
+            void reserve(size_type cap)
+            {
+                m_keys.reserve(cap);
+                m_values.reserve(cap);
+            }
+
+            //* Releases the unused capacity of both arrays.
+            void shrink_to_fit(void)
+            {
+                m_keys.shrink_to_fit();
+                m_values.shrink_to_fit();
+            }
+
+            //!=== [IV] Element access
+            //* The value mapped to key, inserted value-initialized if key is not there.
+            T &operator[](const Key &key) { return try_emplace(key).first->second; }
+            T &operator[](Key &&key) { return try_emplace(std::move(key)).first->second; }
+
+            //* The value mapped to key. Throws std::out_of_range if there is none.
+            T &at(const Key &key)
+            {
+                size_type pos{index_of(key)};
+                if (pos == size())
+                    throw std::out_of_range("[flat_map::at()]: key not found.");
+                return m_values[pos];
+            }
+
+            const T &at(const Key &key) const
+            {
+                size_type pos{index_of(key)};
+                if (pos == size())
+                    throw std::out_of_range("[flat_map::at()]: key not found.");
+                return m_values[pos];
+            }
+
+            //!=== [V] Modifiers
+            void clear(void)
+            {
+                m_keys.clear();
+                m_values.clear();
+            }
+
+            //* Inserts value if its key is not there. Returns where the key is, and whether it was inserted.
+            std::pair<iterator, bool> insert(const value_type &value) { return try_emplace(value.first, value.second); }
+            std::pair<iterator, bool> insert(value_type &&value) { return try_emplace(std::move(value.first), std::move(value.second)); }
+
+            //* Inserts (key, T(args...)) if key is not there; otherwise args are left untouched.
+            template <typename K, typename... Args>
+            std::pair<iterator, bool> try_emplace(K &&key, Args&&... args)
+            {
+                size_type pos{lower_bound_index(key)};
+                if (pos != size() and not m_comp(key, m_keys[pos]))
+                    return std::make_pair(begin() + static_cast<std::ptrdiff_t>(pos), false);
+                insert_at(pos, Key(std::forward<K>(key)), T(std::forward<Args>(args)...));
+                return std::make_pair(begin() + static_cast<std::ptrdiff_t>(pos), true);
+            }
+
+            //* Inserts (key, obj), or assigns obj to the value of key if it is already there.
+            template <typename K, typename M>
+            std::pair<iterator, bool> insert_or_assign(K &&key, M &&obj)
+            {
+                size_type pos{lower_bound_index(key)};
+                if (pos != size() and not m_comp(key, m_keys[pos])) {
+                    m_values[pos] = std::forward<M>(obj);
+                    return std::make_pair(begin() + static_cast<std::ptrdiff_t>(pos), false);
+                }
+                insert_at(pos, Key(std::forward<K>(key)), T(std::forward<M>(obj)));
+                return std::make_pair(begin() + static_cast<std::ptrdiff_t>(pos), true);
+            }
+
+            //* Inserts the (key, value) pairs of [first, last) whose key is not there yet (the first of
+            //* equivalent ones wins). They are sorted on their own, then merged with the stored entries
+            //* in one pass, which is O(n + m log m) instead of the O(n m) of inserting them one by one.
+            template <typename InputItr>
+            void insert(InputItr first, InputItr last)
+            {
+                vector<value_type> batch;
+                for ( /*empty*/ ; first != last ; ++first)
+                    batch.push_back(value_type(*first));
+                merge(batch);
+            }
+
+            void insert(std::initializer_list<value_type> il) { insert(il.begin(), il.end()); }
+
+            //* Removes the entry of key, if any. Returns how many entries were removed (0 or 1).
+            size_type erase(const Key &key)
+            {
+                size_type pos{index_of(key)};
+                if (pos == size())
+                    return 0;
+                erase_at(pos);
+                return 1;
+            }
+
+            //* Removes the entry at pos. Returns the iterator following it.
+            iterator erase(const_iterator pos)
+            {
+                size_type at{static_cast<size_type>(pos - cbegin())};
+                erase_at(at);
+                return begin() + static_cast<std::ptrdiff_t>(at);
+            }
+
+            void swap(flat_map &other)
+            {
+                using std::swap;
+                swap(m_keys, other.m_keys);
+                swap(m_values, other.m_values);
+                swap(m_comp, other.m_comp);
+            }
+
+            //!=== [VI] Lookup
+            //* The entry of key, or end().
+            iterator find(const Key &key) { return begin() + static_cast<std::ptrdiff_t>(index_of(key)); }
+            const_iterator find(const Key &key) const { return begin() + static_cast<std::ptrdiff_t>(index_of(key)); }
+
+            bool contains(const Key &key) const { return index_of(key) != size(); }
+            size_type count(const Key &key) const { return contains(key) ? 1 : 0; }
+
+            //* The first entry whose key is not less than key.
+            iterator lower_bound(const Key &key) { return begin() + static_cast<std::ptrdiff_t>(lower_bound_index(key)); }
+            const_iterator lower_bound(const Key &key) const { return begin() + static_cast<std::ptrdiff_t>(lower_bound_index(key)); }
+
+            //* The first entry whose key is greater than key.
+            iterator upper_bound(const Key &key) { return begin() + static_cast<std::ptrdiff_t>(upper_bound_index(key)); }
+            const_iterator upper_bound(const Key &key) const { return begin() + static_cast<std::ptrdiff_t>(upper_bound_index(key)); }
+
+            //!=== [VII] Observers
+            key_compare key_comp(void) const { return m_comp; }
+
+            //* The sorted keys.
+            const key_container_type &keys(void) const { return m_keys; }
+
+            //* The values, in the order of their keys. They can be changed in place, but not added or removed.
+            mapped_container_type &values(void) { return m_values; }
+            const mapped_container_type &values(void) const { return m_values; }
+
+            friend bool operator==(const flat_map &a, const flat_map &b) { return a.m_keys == b.m_keys and a.m_values == b.m_values; }
+            friend bool operator!=(const flat_map &a, const flat_map &b) { return not (a == b); }
+
+        private:
+            template <typename K>
+            size_type lower_bound_index(const K &key) const
+            {
+                return kernels::lower_bound(m_keys.data(), m_keys.size(), key, m_comp);
+            }
+
+            size_type upper_bound_index(const Key &key) const
+            {
+                return kernels::upper_bound(m_keys.data(), m_keys.size(), key, m_comp);
+            }
+
+            //* Index of the entry of key, or size().
+            size_type index_of(const Key &key) const
+            {
+                size_type pos{lower_bound_index(key)};
+                return pos != size() and not m_comp(key, m_keys[pos]) ? pos : size();
+            }
+
+            //* Inserts the entry in both arrays; if the value can not be inserted, neither is the key.
+            void insert_at(size_type pos, Key &&key, T &&value)
+            {
+                m_keys.insert(m_keys.begin() + static_cast<std::ptrdiff_t>(pos), std::move(key));
+                try {
+                    m_values.insert(m_values.begin() + static_cast<std::ptrdiff_t>(pos), std::move(value));
+                }
+                catch (...) {
+                    m_keys.erase(m_keys.begin() + static_cast<std::ptrdiff_t>(pos));
+                    throw;
+                }
+            }
+
+            void erase_at(size_type pos)
+            {
+                m_keys.erase(m_keys.begin() + static_cast<std::ptrdiff_t>(pos));
+                m_values.erase(m_values.begin() + static_cast<std::ptrdiff_t>(pos));
+            }
+
+            //* Sorts batch by key, drops its repeated keys, and merges it with the stored entries.
+            void merge(vector<value_type> &batch)
+            {
+                if (batch.empty())
+                    return;
+                Compare &comp = m_comp;
+                value_type *b{batch.data()};
+                value_type *b_last{b + batch.size()};
+                std::stable_sort(b, b_last, [&comp](const value_type &x, const value_type &y) { return comp(x.first, y.first); });
+                value_type *b_end{std::unique(b, b_last, [&comp](const value_type &x, const value_type &y) {
+                    return not comp(x.first, y.first) and not comp(y.first, x.first); })};
+
+                size_type n{size()};
+                // Already in order after the stored keys (a table built from sorted data): just append.
+                if (n == 0 or comp(m_keys[n - 1], b->first)) {
+                    reserve(n + static_cast<size_type>(b_end - b));
+                    for ( /*empty*/ ; b != b_end ; ++b) {
+                        m_keys.push_back(std::move(b->first));
+                        m_values.push_back(std::move(b->second));
+                    }
+                    return;
+                }
+
+                KeyContainer keys;
+                MappedContainer values;
+                size_type cap{n + static_cast<size_type>(b_end - b)};
+                keys.reserve(cap > m_keys.capacity() ? cap : m_keys.capacity());
+                values.reserve(cap > m_values.capacity() ? cap : m_values.capacity());
+                size_type a{0};
+                while (a != n and b != b_end) {
+                    if (comp(b->first, m_keys[a])) {
+                        keys.push_back(std::move(b->first));
+                        values.push_back(std::move(b->second));
+                        ++b;
+                        continue;
+                    }
+                    if (not comp(m_keys[a], b->first))
+                        ++b;    // Equivalent keys: the stored entry stays.
+                    keys.push_back(std::move(m_keys[a]));
+                    values.push_back(std::move(m_values[a]));
+                    ++a;
+                }
+                for ( /*empty*/ ; a != n ; ++a) {
+                    keys.push_back(std::move(m_keys[a]));
+                    values.push_back(std::move(m_values[a]));
+                }
+                for ( /*empty*/ ; b != b_end ; ++b) {
+                    keys.push_back(std::move(b->first));
+                    values.push_back(std::move(b->second));
+                }
+                m_keys = std::move(keys);
+                m_values = std::move(values);
+            }
+
+            KeyContainer m_keys;        //!< The keys, sorted by m_comp, without equivalent pairs.
+            MappedContainer m_values;   //!< m_values[i] is the value of m_keys[i].
+            Compare m_comp;             //!< The ordering of the keys.
+    };
+
+} // namespace sc.
+#endif
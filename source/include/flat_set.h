@@ -0,0 +1,217 @@
+#ifndef _FLAT_SET_H_
+#define _FLAT_SET_H_
+
+#include <algorithm>    // std::stable_sort, std::unique
+#include <cstddef>      // std::size_t
+#include <functional>   // std::less
+#include <initializer_list> // std::initializer_list
+#include <utility>      // std::pair, std::move
+
+#include "vector.h"     // sc::vector
+#include "kernels.h"    // sc::kernels::lower_bound, sc::kernels::upper_bound
+
+/// Sequence container namespace.
+namespace sc {
+    /// A sorted set of unique keys, stored contiguously in a sc::vector.
+    /*!
+     * Lookups are binary searches over one array instead of walks through
+     * tree nodes scattered over the heap, and iteration is a linear scan.
+     * Single insertions and erasures shift the elements after them, so the
+     * container suits tables that are built once (or in batches) and then
+     * mostly read. insert(first, last) sorts the new keys on their own and
+     * merges them with the stored ones in a single pass.
+     *
+     * Iterators and references are invalidated by every insertion and erasure.
+     *
+     * \tparam Key The type of the keys.
+     * \tparam Compare The strict weak ordering of the keys.
+     * \tparam KeyContainer The sorted storage; any sc::vector (allocator, growth policy).
+     */
+    template <typename Key, typename Compare = std::less<Key>, typename KeyContainer = vector<Key>>
+    class flat_set
+    {
+        //=== Aliases
+        public:
+            using key_type = Key;                                       //!< The key type.
+            using value_type = Key;                                     //!< The value type.
+            using key_compare = Compare;                                //!< The ordering of the keys.
+            using container_type = KeyContainer;                        //!< The underlying storage.
+            using size_type = typename KeyContainer::size_type;         //!< The size type.
+            using const_iterator = typename KeyContainer::const_iterator; //!< Iterator over the keys, in order.
+            using iterator = const_iterator;                            //!< Keys can not be changed in place.
+
+        public:
+            //!=== [I] Special members
+            //* An empty set.
+            flat_set(void) : m_comp{} { /* empty */ }
+
+            //* An empty set ordered by comp.
+            explicit flat_set(const Compare &comp) : m_comp{comp} { /* empty */ }
+
+            //* A set with the keys of [first, last); the first of equivalent keys is kept.
+            template <typename InputItr>
+            flat_set(InputItr first, InputItr last, const Compare &comp = Compare()) : m_comp{comp}
+            {
+                insert(first, last);
+            }
+
+            //* A set with the keys of the list.
+            flat_set(std::initializer_list<Key> il, const Compare &comp = Compare()) : m_comp{comp}
+            {
+                insert(il.begin(), il.end());
+            }
+
+            //!=== [II] Iterators
+            const_iterator begin(void) const { return m_keys.cbegin(); }
+            const_iterator end(void) const { return m_keys.cend(); }
+            const_iterator cbegin(void) const { return m_keys.cbegin(); }
+            const_iterator cend(void) const { return m_keys.cend(); }
+
+            //!=== [III] Capacity
+            size_type size(void) const { return m_keys.size(); }
+            bool empty(void) const { return m_keys.empty(); }
+            size_type capacity(void) const { return m_keys.capacity(); }
+
+            //* Makes room for cap keys, so that many insertions do not reallocate.
+            void reserve(size_type cap) { m_keys.reserve(cap); }
+
+            //* Releases the unused capacity.
+            void shrink_to_fit(void) { m_keys.shrink_to_fit(); }
+
+            //!=== [IV] Modifiers
+            void clear(void) { m_keys.clear(); }
+
+            //* Inserts key if no equivalent key is there. Returns where it is, and whether it was inserted.
+            std::pair<iterator, bool> insert(const Key &key) { return insert_one(Key(key)); }
+            std::pair<iterator, bool> insert(Key &&key) { return insert_one(std::move(key)); }
+
+            //* Inserts the keys of [first, last) that are not there yet (the first of equivalent ones wins).
+            //* They are appended, sorted on their own and merged with the stored keys in one pass, which is
+            //* O(n + m log m) instead of the O(n m) of inserting them one by one.
+            template <typename InputItr>
+            void insert(InputItr first, InputItr last)
+            {
+                size_type old{m_keys.size()};
+                for ( /*empty*/ ; first != last ; ++first)
+                    m_keys.push_back(*first);
+                merge_tail(old);
+            }
+
+            void insert(std::initializer_list<Key> il) { insert(il.begin(), il.end()); }
+
+            //* Removes the key equivalent to key, if any. Returns how many keys were removed (0 or 1).
+            size_type erase(const Key &key)
+            {
+                size_type pos{lower_bound_index(key)};
+                if (pos == size() or m_comp(key, m_keys[pos]))
+                    return 0;
+                m_keys.erase(begin() + static_cast<std::ptrdiff_t>(pos));
+                return 1;
+            }
+
+            //* Removes the key at pos. Returns the iterator following it.
+            iterator erase(const_iterator pos) { return m_keys.erase(pos); }
+
+            void swap(flat_set &other)
+            {
+                using std::swap;
+                swap(m_keys, other.m_keys);
+                swap(m_comp, other.m_comp);
+            }
+
+            //!=== [V] Lookup
+            //* The key equivalent to key, or end().
+            const_iterator find(const Key &key) const
+            {
+                size_type pos{lower_bound_index(key)};
+                return pos == size() or m_comp(key, m_keys[pos]) ? end() : begin() + static_cast<std::ptrdiff_t>(pos);
+            }
+
+            bool contains(const Key &key) const
+            {
+                size_type pos{lower_bound_index(key)};
+                return pos != size() and not m_comp(key, m_keys[pos]);
+            }
+
+            size_type count(const Key &key) const { return contains(key) ? 1 : 0; }
+
+            //* The first key not less than key.
+            const_iterator lower_bound(const Key &key) const { return begin() + static_cast<std::ptrdiff_t>(lower_bound_index(key)); }
+
+            //* The first key greater than key.
+            const_iterator upper_bound(const Key &key) const
+            {
+                return begin() + static_cast<std::ptrdiff_t>(kernels::upper_bound(m_keys.data(), m_keys.size(), key, m_comp));
+            }
+
+            //!=== [VI] Observers
+            key_compare key_comp(void) const { return m_comp; }
+
+            //* The sorted keys.
+            const container_type &keys(void) const { return m_keys; }
+
+            friend bool operator==(const flat_set &a, const flat_set &b) { return a.m_keys == b.m_keys; }
+            friend bool operator!=(const flat_set &a, const flat_set &b) { return not (a.m_keys == b.m_keys); }
+
+        private:
+            size_type lower_bound_index(const Key &key) const
+            {
+                return kernels::lower_bound(m_keys.data(), m_keys.size(), key, m_comp);
+            }
+
+            std::pair<iterator, bool> insert_one(Key &&key)
+            {
+                size_type pos{lower_bound_index(key)};
+                if (pos != size() and not m_comp(key, m_keys[pos]))
+                    return std::make_pair(begin() + static_cast<std::ptrdiff_t>(pos), false);
+                m_keys.insert(m_keys.begin() + static_cast<std::ptrdiff_t>(pos), std::move(key));
+                return std::make_pair(begin() + static_cast<std::ptrdiff_t>(pos), true);
+            }
+
+            //* The keys in [old, size()) were appended: sorts them and merges them into [0, old).
+            void merge_tail(size_type old)
+            {
+                Key *data{m_keys.data()};
+                Key *mid{data + old};
+                Key *last{data + m_keys.size()};
+                if (mid == last)
+                    return;
+                Compare &comp = m_comp;
+                auto equivalent = [&comp](const Key &a, const Key &b) { return not comp(a, b) and not comp(b, a); };
+                std::stable_sort(mid, last, comp);
+                Key *unique_end{std::unique(mid, last, equivalent)};
+
+                // Already in order after the stored keys (a table built from sorted data): nothing to merge.
+                if (old == 0 or comp(mid[-1], *mid)) {
+                    m_keys.erase(m_keys.begin() + (unique_end - data), m_keys.end());
+                    return;
+                }
+
+                KeyContainer merged;
+                merged.reserve(m_keys.capacity());
+                Key *a{data};
+                Key *b{mid};
+                while (a != mid and b != unique_end) {
+                    if (comp(*a, *b))
+                        merged.push_back(std::move(*a++));
+                    else if (comp(*b, *a))
+                        merged.push_back(std::move(*b++));
+                    else {
+                        // Equivalent keys: the stored one stays.
+                        merged.push_back(std::move(*a++));
+                        ++b;
+                    }
+                }
+                for ( /*empty*/ ; a != mid ; ++a)
+                    merged.push_back(std::move(*a));
+                for ( /*empty*/ ; b != unique_end ; ++b)
+                    merged.push_back(std::move(*b));
+                m_keys = std::move(merged);
+            }
+
+            KeyContainer m_keys;    //!< The keys, sorted by m_comp, without equivalent pairs.
+            Compare m_comp;         //!< The ordering of the keys.
+    };
+
+} // namespace sc.
+#endif
@@ -0,0 +1,71 @@
+#ifndef _GROWTH_POLICY_H_
+#define _GROWTH_POLICY_H_
+
+#include <cstddef>      // std::size_t
+
+/// Sequence container namespace.
+namespace sc {
+    /// Growth policies: how much a container grows when it runs out of room.
+    /*!
+     * A growth policy is any type with a static member function
+     *
+     *     static std::size_t grow(std::size_t capacity, std::size_t required, std::size_t value_size);
+     *
+     * that returns the capacity to move to, given the current capacity, the
+     * minimum capacity the operation needs and sizeof(value_type). The
+     * container never trusts a result smaller than `required`.
+     *
+     * sc::vector takes the policy as its third template parameter, so custom
+     * policies can be plugged per container type:
+     *
+     *     sc::vector<float, std::allocator<float>, sc::growth::one_and_half> v;
+     */
+    namespace growth {
+        /// Multiplies the capacity by Num/Den, or jumps straight to the required capacity if that is larger.
+        template <std::size_t Num, std::size_t Den = 1>
+        struct factor
+        {
+            static_assert(Num > Den, "The growth factor must be greater than one.");
+
+            static std::size_t grow(std::size_t capacity, std::size_t required, std::size_t /* value_size */)
+            {
+                std::size_t next{capacity / Den * Num + capacity % Den * Num / Den};
+                return next > required ? next : required;
+            }
+        };
+
+        /// The classic 2x growth: fewest reallocations, but up to 50% of the buffer may be unused.
+        using doubling = factor<2>;
+
+        /// 1.5x growth: less slack, and the sum of the blocks freed so far can eventually hold the next one,
+        /// so the allocator gets a chance to reuse them.
+        using one_and_half = factor<3, 2>;
+
+        /// Rounds a request of `bytes` up to the size classes of a typical malloc (jemalloc/tcmalloc style):
+        /// multiples of 16 up to 128 bytes, then four classes per power of two.
+        inline std::size_t size_class(std::size_t bytes)
+        {
+            if (bytes <= 128)
+                return (bytes + 15) / 16 * 16;
+            // Highest power of two strictly below bytes.
+            std::size_t base{128};
+            while (base < (bytes - 1) / 2 + 1)
+                base *= 2;
+            std::size_t step{base / 4};
+            return (bytes + step - 1) / step * step;
+        }
+
+        /// 1.5x growth rounded up to the allocator size class, so the slack the allocator
+        /// would add to the block anyway becomes usable capacity.
+        struct size_class_aware
+        {
+            static std::size_t grow(std::size_t capacity, std::size_t required, std::size_t value_size)
+            {
+                std::size_t wanted{one_and_half::grow(capacity, required, value_size)};
+                return size_class(wanted * value_size) / value_size;
+            }
+        };
+    } // namespace growth.
+
+} // namespace sc.
+#endif
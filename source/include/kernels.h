@@ -0,0 +1,556 @@
+#ifndef _KERNELS_H_
+#define _KERNELS_H_
+
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::int32_t, std::int64_t, std::uint32_t, std::uint64_t
+#include <cstring>      // std::memcpy
+#include <stdexcept>    // std::length_error
+#include <type_traits>  // std::conditional, std::is_integral, std::is_signed, std::is_same
+#include <utility>      // std::pair
+
+#include "simd.h"       // SC_TARGET, SC_ALWAYS_INLINE, SC_PREFETCH, sc::simd::active()
+
+/// Sequence container namespace.
+namespace sc {
+    /// Kernels over contiguous ranges of elements (raw pointers, sc::vector::data(), sc::span).
+    /*!
+     * Reductions and searches over arithmetic elements:
+     *
+     *     sc::vector<float> v = ...;
+     *     float total = sc::kernels::sum(v);
+     *     std::size_t at = sc::kernels::find(v, 1.5f);   // v.size() if absent; 1.5 does not compile
+     *
+     * Each kernel takes a (pointer, size) pair or any contiguous container with
+     * data() and size() (sc::vector, sc::small_vector, sc::span, ...). For
+     * float, double and 4- and 8-byte integers the work is done with SSE2,
+     * AVX2 or AVX-512, whichever simd::active() selects; other element types
+     * take the portable scalar loop.
+     *
+     * Integer sums and dot products are accumulated on 64 bits (sum_type) and
+     * wrap around on overflow. Floating-point sums are reassociated, so they may
+     * differ from a sequential loop in the last bits. min/max ignore NaN only as
+     * far as the comparison does: the result is unspecified if the range holds NaN.
+     */
+    namespace kernels {
+        //* The type sum() and dot() return for elements of type T.
+        template <typename T>
+        using sum_type = typename std::conditional<not std::is_integral<T>::value or std::is_same<T, bool>::value, T,
+                         typename std::conditional<std::is_signed<T>::value, long long, unsigned long long>::type>::type;
+
+        namespace detail {
+            /// The canonical lane type the SIMD code handles a T as, or void if T stays scalar.
+            template <typename T, bool = std::is_integral<T>::value and not std::is_same<T, bool>::value>
+            struct lane { using type = void; };
+            template <> struct lane<float, false> { using type = float; };
+            template <> struct lane<double, false> { using type = double; };
+            template <typename T>
+            struct lane<T, true>
+            {
+                using type = typename std::conditional<sizeof(T) == 4, typename std::conditional<std::is_signed<T>::value, std::int32_t, std::uint32_t>::type,
+                             typename std::conditional<sizeof(T) == 8, typename std::conditional<std::is_signed<T>::value, std::int64_t, std::uint64_t>::type,
+                             void>::type>::type;
+            };
+
+            //* Whether the SIMD paths handle T.
+            template <typename T>
+            using vectorized = std::integral_constant<bool, not std::is_same<typename lane<T>::type, void>::value>;
+
+            //!=== Scalar reference versions.
+            template <typename T>
+            sum_type<T> sum_scalar(const T *p, std::size_t n)
+            {
+                // Integers are added as unsigned, so an overflow wraps around instead of being undefined.
+                using acc_t = typename std::conditional<std::is_integral<sum_type<T>>::value, unsigned long long, sum_type<T>>::type;
+                acc_t acc{0};
+                for (std::size_t i{0} ; i < n ; ++i)
+                    acc += static_cast<acc_t>(static_cast<sum_type<T>>(p[i]));
+                return static_cast<sum_type<T>>(acc);
+            }
+
+            template <typename T>
+            sum_type<T> dot_scalar(const T *a, const T *b, std::size_t n)
+            {
+                using acc_t = typename std::conditional<std::is_integral<sum_type<T>>::value, unsigned long long, sum_type<T>>::type;
+                acc_t acc{0};
+                for (std::size_t i{0} ; i < n ; ++i)
+                    acc += static_cast<acc_t>(static_cast<sum_type<T>>(a[i])) * static_cast<acc_t>(static_cast<sum_type<T>>(b[i]));
+                return static_cast<sum_type<T>>(acc);
+            }
+
+            template <typename T>
+            std::pair<T, T> minmax_scalar(const T *p, std::size_t n)
+            {
+                T lo{p[0]}, hi{p[0]};
+                for (std::size_t i{1} ; i < n ; ++i) {
+                    if (p[i] < lo) lo = p[i];
+                    if (hi < p[i]) hi = p[i];
+                }
+                return std::pair<T, T>(lo, hi);
+            }
+
+            template <typename T>
+            std::size_t find_scalar(const T *p, std::size_t n, const T &value)
+            {
+                std::size_t i{0};
+                while (i < n and not (p[i] == value))
+                    ++i;
+                return i;
+            }
+
+            template <typename T>
+            std::size_t count_scalar(const T *p, std::size_t n, const T &value)
+            {
+                std::size_t c{0};
+                for (std::size_t i{0} ; i < n ; ++i)
+                    c += p[i] == value;
+                return c;
+            }
+
+#if SC_SIMD_X86
+            //!=== Vector bodies, written once for a register of W bytes.
+            /// The GCC vector type of W bytes holding lanes of type L.
+            template <typename L, int W> struct vreg;
+#define SC_KERNELS_VREG(L, W) template <> struct vreg<L, W> { typedef L type __attribute__((vector_size(W))); };
+            SC_KERNELS_VREG(float, 16)          SC_KERNELS_VREG(float, 32)          SC_KERNELS_VREG(float, 64)
+            SC_KERNELS_VREG(double, 16)         SC_KERNELS_VREG(double, 32)         SC_KERNELS_VREG(double, 64)
+            SC_KERNELS_VREG(std::int32_t, 8)    SC_KERNELS_VREG(std::int32_t, 16)   SC_KERNELS_VREG(std::int32_t, 32)
+            SC_KERNELS_VREG(std::int32_t, 64)   SC_KERNELS_VREG(std::uint32_t, 8)   SC_KERNELS_VREG(std::uint32_t, 16)
+            SC_KERNELS_VREG(std::uint32_t, 32)  SC_KERNELS_VREG(std::uint32_t, 64)  SC_KERNELS_VREG(std::int64_t, 16)
+            SC_KERNELS_VREG(std::int64_t, 32)   SC_KERNELS_VREG(std::int64_t, 64)   SC_KERNELS_VREG(std::uint64_t, 16)
+            SC_KERNELS_VREG(std::uint64_t, 32)  SC_KERNELS_VREG(std::uint64_t, 64)
+#undef SC_KERNELS_VREG
+
+            //* The integer lanes of the same width as L, as produced by a comparison.
+            template <typename L>
+            using mask_lane = typename std::conditional<sizeof(L) == 4, std::int32_t, std::int64_t>::type;
+
+            //* Sum of floating-point lanes: four independent accumulators hide the latency of the additions.
+            template <int W, typename T, typename L>
+            SC_ALWAYS_INLINE sum_type<T> sum_vec(const T *p, std::size_t n, std::true_type /* floating */)
+            {
+                typedef typename vreg<L, W>::type V;
+                constexpr std::size_t lanes = W / sizeof(L);
+                V a0 = {}, a1 = {}, a2 = {}, a3 = {};
+                std::size_t i{0};
+                for ( /*empty*/ ; i + 4 * lanes <= n ; i += 4 * lanes) {
+                    V x0, x1, x2, x3;
+                    std::memcpy(&x0, p + i, W);
+                    std::memcpy(&x1, p + i + lanes, W);
+                    std::memcpy(&x2, p + i + 2 * lanes, W);
+                    std::memcpy(&x3, p + i + 3 * lanes, W);
+                    a0 += x0; a1 += x1; a2 += x2; a3 += x3;
+                }
+                for ( /*empty*/ ; i + lanes <= n ; i += lanes) {
+                    V x;
+                    std::memcpy(&x, p + i, W);
+                    a0 += x;
+                }
+                a0 = (a0 + a1) + (a2 + a3);
+                L acc{0};
+                for (std::size_t k{0} ; k < lanes ; ++k)
+                    acc += a0[k];
+                return acc + sum_scalar(p + i, n - i);
+            }
+
+            //* Sum of integer lanes, widened to 64 bits (4-byte elements are loaded half a register at a time).
+            template <int W, typename T, typename L>
+            SC_ALWAYS_INLINE sum_type<T> sum_vec(const T *p, std::size_t n, std::false_type /* integral */)
+            {
+                typedef typename vreg<std::uint64_t, W>::type U;
+                typedef typename vreg<L, W * sizeof(L) / 8>::type V;
+                typedef typename vreg<typename std::conditional<std::is_signed<L>::value, std::int64_t, std::uint64_t>::type, W>::type Wide;
+                constexpr std::size_t lanes = W / 8;
+                // SSE2 has no sign extension instruction: widening costs more than it saves.
+                if (W == 16 and sizeof(L) == 4)
+                    return sum_scalar(p, n);
+                U a0 = {}, a1 = {};
+                std::size_t i{0};
+                for ( /*empty*/ ; i + 2 * lanes <= n ; i += 2 * lanes) {
+                    V x0, x1;
+                    std::memcpy(&x0, p + i, sizeof(V));
+                    std::memcpy(&x1, p + i + lanes, sizeof(V));
+                    a0 += (U) __builtin_convertvector(x0, Wide);
+                    a1 += (U) __builtin_convertvector(x1, Wide);
+                }
+                a0 += a1;
+                std::uint64_t acc{0};
+                for (std::size_t k{0} ; k < lanes ; ++k)
+                    acc += a0[k];
+                return static_cast<sum_type<T>>(acc + static_cast<std::uint64_t>(sum_scalar(p + i, n - i)));
+            }
+
+            struct sum_op
+            {
+                template <typename T>
+                static sum_type<T> scalar(const T *p, std::size_t n) { return sum_scalar(p, n); }
+
+                template <int W, typename T>
+                SC_ALWAYS_INLINE static sum_type<T> vec(const T *p, std::size_t n)
+                {
+                    using L = typename lane<T>::type;
+                    return sum_vec<W, T, L>(p, n, std::is_floating_point<L>{});
+                }
+            };
+
+            //* Dot product of floating-point lanes.
+            template <int W, typename T, typename L>
+            SC_ALWAYS_INLINE sum_type<T> dot_vec(const T *a, const T *b, std::size_t n, std::true_type /* floating */)
+            {
+                typedef typename vreg<L, W>::type V;
+                constexpr std::size_t lanes = W / sizeof(L);
+                V a0 = {}, a1 = {};
+                std::size_t i{0};
+                for ( /*empty*/ ; i + 2 * lanes <= n ; i += 2 * lanes) {
+                    V x0, x1, y0, y1;
+                    std::memcpy(&x0, a + i, W);
+                    std::memcpy(&x1, a + i + lanes, W);
+                    std::memcpy(&y0, b + i, W);
+                    std::memcpy(&y1, b + i + lanes, W);
+                    a0 += x0 * y0;
+                    a1 += x1 * y1;
+                }
+                a0 += a1;
+                L acc{0};
+                for (std::size_t k{0} ; k < lanes ; ++k)
+                    acc += a0[k];
+                return acc + dot_scalar(a + i, b + i, n - i);
+            }
+
+            //* Dot product of integer lanes, with 64-bit products and sums.
+            template <int W, typename T, typename L>
+            SC_ALWAYS_INLINE sum_type<T> dot_vec(const T *a, const T *b, std::size_t n, std::false_type /* integral */)
+            {
+                typedef typename vreg<std::uint64_t, W>::type U;
+                typedef typename vreg<L, W * sizeof(L) / 8>::type V;
+                typedef typename vreg<typename std::conditional<std::is_signed<L>::value, std::int64_t, std::uint64_t>::type, W>::type Wide;
+                constexpr std::size_t lanes = W / 8;
+                // Only AVX-512 multiplies 64-bit lanes natively; narrower paths would emulate it.
+                if (W < 64)
+                    return dot_scalar(a, b, n);
+                U acc_v = {};
+                std::size_t i{0};
+                for ( /*empty*/ ; i + lanes <= n ; i += lanes) {
+                    V x, y;
+                    std::memcpy(&x, a + i, sizeof(V));
+                    std::memcpy(&y, b + i, sizeof(V));
+                    acc_v += (U) __builtin_convertvector(x, Wide) * (U) __builtin_convertvector(y, Wide);
+                }
+                std::uint64_t acc{0};
+                for (std::size_t k{0} ; k < lanes ; ++k)
+                    acc += acc_v[k];
+                return static_cast<sum_type<T>>(acc + static_cast<std::uint64_t>(dot_scalar(a + i, b + i, n - i)));
+            }
+
+            struct dot_op
+            {
+                template <typename T>
+                static sum_type<T> scalar(const T *a, const T *b, std::size_t n) { return dot_scalar(a, b, n); }
+
+                template <int W, typename T>
+                SC_ALWAYS_INLINE static sum_type<T> vec(const T *a, const T *b, std::size_t n)
+                {
+                    using L = typename lane<T>::type;
+                    return dot_vec<W, T, L>(a, b, n, std::is_floating_point<L>{});
+                }
+            };
+
+            struct minmax_op
+            {
+                template <typename T>
+                static std::pair<T, T> scalar(const T *p, std::size_t n) { return minmax_scalar(p, n); }
+
+                //* Lane-wise minimum and maximum, folded at the end. Requires n >= 1.
+                template <int W, typename T>
+                SC_ALWAYS_INLINE static std::pair<T, T> vec(const T *p, std::size_t n)
+                {
+                    using L = typename lane<T>::type;
+                    typedef typename vreg<L, W>::type V;
+                    constexpr std::size_t lanes = W / sizeof(L);
+                    if (n < lanes)
+                        return minmax_scalar(p, n);
+                    V lo, hi;
+                    std::memcpy(&lo, p, W);
+                    hi = lo;
+                    std::size_t i{lanes};
+                    for ( /*empty*/ ; i + lanes <= n ; i += lanes) {
+                        V x;
+                        std::memcpy(&x, p + i, W);
+                        lo = x < lo ? x : lo;
+                        hi = hi < x ? x : hi;
+                    }
+                    L l{lo[0]}, h{hi[0]};
+                    for (std::size_t k{1} ; k < lanes ; ++k) {
+                        if (lo[k] < l) l = lo[k];
+                        if (h < hi[k]) h = hi[k];
+                    }
+                    T tl, th;
+                    std::memcpy(&tl, &l, sizeof(T));
+                    std::memcpy(&th, &h, sizeof(T));
+                    for ( /*empty*/ ; i < n ; ++i) {
+                        if (p[i] < tl) tl = p[i];
+                        if (th < p[i]) th = p[i];
+                    }
+                    return std::pair<T, T>(tl, th);
+                }
+            };
+
+            struct find_op
+            {
+                template <typename T>
+                static std::size_t scalar(const T *p, std::size_t n, T value) { return find_scalar(p, n, value); }
+
+                //* Compares a whole register, and only looks at the lanes one by one once one of them matched.
+                template <int W, typename T>
+                SC_ALWAYS_INLINE static std::size_t vec(const T *p, std::size_t n, T value)
+                {
+                    using L = typename lane<T>::type;
+                    typedef typename vreg<L, W>::type V;
+                    typedef typename vreg<std::uint64_t, W>::type U;
+                    constexpr std::size_t lanes = W / sizeof(L);
+                    L v;
+                    std::memcpy(&v, &value, sizeof(L));
+                    V target = V{} + v;
+                    std::size_t i{0};
+                    for ( /*empty*/ ; i + 2 * lanes <= n ; i += 2 * lanes) {
+                        V x0, x1;
+                        std::memcpy(&x0, p + i, W);
+                        std::memcpy(&x1, p + i + lanes, W);
+                        U hit = (U) (x0 == target) | (U) (x1 == target);
+                        std::uint64_t any{0};
+                        for (std::size_t k{0} ; k < W / 8 ; ++k)
+                            any |= hit[k];
+                        if (any != 0)
+                            break;
+                    }
+                    return i + find_scalar(p + i, n - i, value);
+                }
+            };
+
+            struct count_op
+            {
+                template <typename T>
+                static std::size_t scalar(const T *p, std::size_t n, T value) { return count_scalar(p, n, value); }
+
+                //* A match sets a lane of the comparison to -1, so subtracting the comparison counts it.
+                template <int W, typename T>
+                SC_ALWAYS_INLINE static std::size_t vec(const T *p, std::size_t n, T value)
+                {
+                    using L = typename lane<T>::type;
+                    typedef typename vreg<L, W>::type V;
+                    typedef typename vreg<mask_lane<L>, W>::type M;
+                    constexpr std::size_t lanes = W / sizeof(L);
+                    // The lane counters are flushed before a 32-bit lane could overflow.
+                    constexpr std::size_t flush_every = std::size_t{1} << 30;
+                    L v;
+                    std::memcpy(&v, &value, sizeof(L));
+                    V target = V{} + v;
+                    std::size_t total{0};
+                    std::size_t i{0};
+                    while (i + lanes <= n) {
+                        M c = {};
+                        std::size_t stop{n - i > flush_every * lanes ? i + flush_every * lanes : n};
+                        for ( /*empty*/ ; i + lanes <= stop ; i += lanes) {
+                            V x;
+                            std::memcpy(&x, p + i, W);
+                            c -= (M) (x == target);
+                        }
+                        for (std::size_t k{0} ; k < lanes ; ++k)
+                            total += static_cast<std::size_t>(c[k]);
+                    }
+                    return total + count_scalar(p + i, n - i, value);
+                }
+            };
+
+            //!=== Entry points: each instantiates a body for one instruction set.
+            template <typename Op, typename T, typename... Args>
+            SC_TARGET("sse2")
+            auto run_sse2(const T *p, Args... args) -> decltype(Op::scalar(p, args...)) { return Op::template vec<16>(p, args...); }
+
+            template <typename Op, typename T, typename... Args>
+            SC_TARGET("avx2,fma")
+            auto run_avx2(const T *p, Args... args) -> decltype(Op::scalar(p, args...)) { return Op::template vec<32>(p, args...); }
+
+            template <typename Op, typename T, typename... Args>
+            SC_TARGET("avx512f,avx512vl,avx512bw,avx512dq,fma")
+            auto run_avx512(const T *p, Args... args) -> decltype(Op::scalar(p, args...)) { return Op::template vec<64>(p, args...); }
+#else
+            // Without SIMD paths the operations are just their scalar versions.
+            struct sum_op { template <typename T> static sum_type<T> scalar(const T *p, std::size_t n) { return sum_scalar(p, n); } };
+            struct dot_op { template <typename T> static sum_type<T> scalar(const T *a, const T *b, std::size_t n) { return dot_scalar(a, b, n); } };
+            struct minmax_op { template <typename T> static std::pair<T, T> scalar(const T *p, std::size_t n) { return minmax_scalar(p, n); } };
+            struct find_op { template <typename T> static std::size_t scalar(const T *p, std::size_t n, T value) { return find_scalar(p, n, value); } };
+            struct count_op { template <typename T> static std::size_t scalar(const T *p, std::size_t n, T value) { return count_scalar(p, n, value); } };
+#endif
+            //* Vectorized element types: the best path simd::active() allows.
+            template <typename Op, typename T, typename... Args>
+            auto dispatch(std::true_type, const T *p, Args... args) -> decltype(Op::scalar(p, args...))
+            {
+#if SC_SIMD_X86
+                switch (simd::active()) {
+                    case simd::level::avx512: return run_avx512<Op>(p, args...);
+                    case simd::level::avx2:   return run_avx2<Op>(p, args...);
+                    case simd::level::sse2:   return run_sse2<Op>(p, args...);
+                    default: break;
+                }
+#endif
+                return Op::scalar(p, args...);
+            }
+
+            template <typename Op, typename T, typename... Args>
+            auto dispatch(std::false_type, const T *p, Args... args) -> decltype(Op::scalar(p, args...))
+            {
+                return Op::scalar(p, args...);
+            }
+
+            //* Entry point of every kernel.
+            template <typename Op, typename T, typename... Args>
+            auto run(const T *p, Args... args) -> decltype(Op::scalar(p, args...))
+            {
+                return dispatch<Op>(vectorized<T>{}, p, args...);
+            }
+        } // namespace detail.
+
+        //!=== Reductions
+        //* Sum of the n elements at p (0 if n == 0).
+        template <typename T>
+        sum_type<T> sum(const T *p, std::size_t n) { return detail::run<detail::sum_op>(p, n); }
+
+        //* Sum of a[i] * b[i] over the n positions.
+        template <typename T>
+        sum_type<T> dot(const T *a, const T *b, std::size_t n) { return detail::run<detail::dot_op>(a, b, n); }
+
+        //* Smallest and largest of the n elements at p. Throws std::length_error if n == 0.
+        template <typename T>
+        std::pair<T, T> minmax(const T *p, std::size_t n)
+        {
+            if (n == 0)
+                throw std::length_error("[kernels::minmax()]: Can not take the extremes of an empty range.");
+            return detail::run<detail::minmax_op>(p, n);
+        }
+
+        //* Smallest of the n elements at p. Throws std::length_error if n == 0.
+        template <typename T>
+        T min(const T *p, std::size_t n)
+        {
+            if (n == 0)
+                throw std::length_error("[kernels::min()]: Can not take the minimum of an empty range.");
+            return detail::run<detail::minmax_op>(p, n).first;
+        }
+
+        //* Largest of the n elements at p. Throws std::length_error if n == 0.
+        template <typename T>
+        T max(const T *p, std::size_t n)
+        {
+            if (n == 0)
+                throw std::length_error("[kernels::max()]: Can not take the maximum of an empty range.");
+            return detail::run<detail::minmax_op>(p, n).second;
+        }
+
+        //!=== Searches
+        // value must have the element type: a silent conversion would change what is searched
+        // for (2.5 among ints is 2), so find(ints, 2.5) does not compile.
+        //* Index of the first of the n elements at p equal to value, or n if there is none.
+        template <typename T, typename U>
+        std::size_t find(const T *p, std::size_t n, const U &value)
+        {
+            static_assert(std::is_same<T, U>::value, "[kernels::find()]: value must have the element type.");
+            return detail::run<detail::find_op>(p, n, value);
+        }
+
+        //* How many of the n elements at p are equal to value.
+        template <typename T, typename U>
+        std::size_t count(const T *p, std::size_t n, const U &value)
+        {
+            static_assert(std::is_same<T, U>::value, "[kernels::count()]: value must have the element type.");
+            return detail::run<detail::count_op>(p, n, value);
+        }
+
+        //* Whether one of the n elements at p is equal to value.
+        template <typename T, typename U>
+        bool contains(const T *p, std::size_t n, const U &value)
+        {
+            static_assert(std::is_same<T, U>::value, "[kernels::contains()]: value must have the element type.");
+            return find(p, n, value) != n;
+        }
+
+        //!=== Binary searches over sorted ranges
+        //* Index of the first of the n sorted elements at first that is not less than key, or n.
+        //* Branch-free: the halving step is a conditional move, so it never mispredicts, and both
+        //* elements the next step may look at are prefetched while this one is compared.
+        template <typename T, typename U, typename Compare>
+        std::size_t lower_bound(const T *first, std::size_t n, const U &key, Compare comp)
+        {
+            if (n == 0)
+                return 0;
+            const T *base{first};
+            while (n > 1) {
+                std::size_t half{n / 2};
+                SC_PREFETCH(base + (n - half) / 2);
+                SC_PREFETCH(base + half + (n - half) / 2);
+                base = comp(base[half], key) ? base + half : base;
+                n -= half;
+            }
+            return static_cast<std::size_t>(base - first) + (comp(*base, key) ? 1 : 0);
+        }
+
+        //* Index of the first of the n sorted elements at first that is greater than key, or n. Branch-free.
+        template <typename T, typename U, typename Compare>
+        std::size_t upper_bound(const T *first, std::size_t n, const U &key, Compare comp)
+        {
+            if (n == 0)
+                return 0;
+            const T *base{first};
+            while (n > 1) {
+                std::size_t half{n / 2};
+                SC_PREFETCH(base + (n - half) / 2);
+                SC_PREFETCH(base + half + (n - half) / 2);
+                base = comp(key, base[half]) ? base : base + half;
+                n -= half;
+            }
+            return static_cast<std::size_t>(base - first) + (comp(key, *base) ? 0 : 1);
+        }
+
+        //!=== The same kernels over a contiguous container (anything with data() and size()).
+        template <typename C>
+        auto sum(const C &c) -> decltype(sum(c.data(), c.size())) { return sum(c.data(), c.size()); }
+
+        template <typename C>
+        auto min(const C &c) -> decltype(min(c.data(), c.size())) { return min(c.data(), c.size()); }
+
+        template <typename C>
+        auto max(const C &c) -> decltype(max(c.data(), c.size())) { return max(c.data(), c.size()); }
+
+        template <typename C>
+        auto minmax(const C &c) -> decltype(minmax(c.data(), c.size())) { return minmax(c.data(), c.size()); }
+
+        //* Throws std::length_error if the two containers have different sizes.
+        template <typename C1, typename C2>
+        auto dot(const C1 &a, const C2 &b) -> decltype(dot(a.data(), b.data(), a.size()))
+        {
+            if (a.size() != b.size())
+                throw std::length_error("[kernels::dot()]: The ranges have different sizes.");
+            return dot(a.data(), b.data(), a.size());
+        }
+
+        //* Index of the first element equal to value, or c.size() if there is none.
+        template <typename C, typename U>
+        auto find(const C &c, const U &value) -> decltype(find(c.data(), c.size(), value))
+        {
+            return find(c.data(), c.size(), value);
+        }
+
+        template <typename C, typename U>
+        auto count(const C &c, const U &value) -> decltype(count(c.data(), c.size(), value))
+        {
+            return count(c.data(), c.size(), value);
+        }
+
+        template <typename C, typename U>
+        auto contains(const C &c, const U &value) -> decltype(contains(c.data(), c.size(), value))
+        {
+            return contains(c.data(), c.size(), value);
+        }
+    } // namespace kernels.
+
+} // namespace sc.
+#endif
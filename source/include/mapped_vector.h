@@ -0,0 +1,401 @@
+#ifndef _MAPPED_VECTOR_H_
+#define _MAPPED_VECTOR_H_
+
+#include <cstdint>      // std::uint32_t, std::uint64_t
+#include <cstring>      // std::memcmp, std::memcpy
+#include <iterator>     // std::distance
+#include <stdexcept>    // std::out_of_range, std::length_error, std::logic_error, std::runtime_error
+#include <string>       // std::string
+#include <type_traits>  // std::is_trivially_copyable
+
+#include <fcntl.h>      // open
+#include <sys/mman.h>   // mmap, mremap, munmap, msync
+#include <sys/stat.h>   // fstat
+#include <unistd.h>     // close, ftruncate
+
+#include "growth_policy.h" // sc::growth::doubling
+#include "vector.h"     // sc::MyForwardIterator
+#include "checks.h"     // SC_EXPECTS, SC_EXPECTS_NONEMPTY
+
+/// Sequence container namespace.
+namespace sc {
+    /// A vector of trivially copyable elements that lives in a memory-mapped file.
+    /*!
+     * The file starts with a small header (magic, format version, type tag,
+     * element size, size and capacity), followed by the elements laid out
+     * exactly as in memory. Opening an existing file is a single mmap: there is
+     * no parsing, and the pages are read lazily from the page cache, which is
+     * also shared by every process that maps the same file.
+     *
+     * push_back() and reserve() grow the file (ftruncate + mremap). The size
+     * is kept in the mapped header, so the file is always consistent with the
+     * vector once the mapping is flushed (explicitly with flush(), or by the
+     * kernel after the vector is gone).
+     *
+     * A file opened with mode::read_only can be shared between processes;
+     * every modifier then throws std::logic_error.
+     *
+     * \tparam T The type of the elements; it must be trivially copyable.
+     */
+    template <typename T>
+    class mapped_vector
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "mapped_vector stores elements as raw bytes: T must be trivially copyable.");
+
+        //=== Aliases
+        public:
+            using size_type = unsigned long; //!< The size type.
+            using value_type = T;            //!< The value type.
+            using pointer = value_type*;     //!< Pointer to a value stored in the container.
+            using const_pointer = const value_type*; //!< Const pointer to a value stored in the container.
+            using reference = value_type&;   //!< Reference to a value stored in the container.
+            using const_reference = const value_type&; //!< Const reference to a value stored in the container.
+
+            using iterator = MyForwardIterator<value_type>; //!< The iterator, instantiated from a template class.
+            using const_iterator = MyForwardIterator<const value_type>; //!< The const_iterator, instantiated from a template class.
+
+            /// How the file is opened.
+            enum class mode { read_only, read_write };
+
+            //* Version of the file layout written by this class.
+            static constexpr std::uint32_t format_version = 1;
+
+        private:
+            /// The file header. The elements start right after it.
+            struct header
+            {
+                char magic[8];              //!< Always "SCVECTOR".
+                std::uint32_t version;      //!< Layout version, format_version.
+                std::uint32_t header_size;  //!< sizeof(header), offset of the first element.
+                std::uint64_t type_tag;     //!< User tag identifying the element type.
+                std::uint64_t value_size;   //!< sizeof(T) when the file was created.
+                std::uint64_t size;         //!< Number of elements.
+                std::uint64_t capacity;     //!< Number of element slots in the file.
+                char padding[16];           //!< Keeps the elements 64-byte aligned.
+            };
+            static_assert(sizeof(header) == 64, "The header must keep the elements cache-line aligned.");
+            static_assert(alignof(T) <= sizeof(header), "The alignment of T is too strict for mapped_vector.");
+
+        public:
+            //!=== [I] Special members
+            //* Opens the file at path, creating it (empty) if it does not exist and mode is read_write.
+            //* Throws std::runtime_error if the file can not be opened or was written for another element type.
+            explicit mapped_vector(const std::string &path, mode mode_ = mode::read_write, std::uint64_t type_tag = 0)
+                : m_path{path},
+                  m_read_only{mode_ == mode::read_only},
+                  m_fd{-1},
+                  m_base{nullptr},
+                  m_mapped{0}
+            {
+                m_fd = ::open(path.c_str(), m_read_only ? O_RDONLY : (O_RDWR | O_CREAT), 0644);
+                if (m_fd < 0)
+                    throw std::runtime_error("[mapped_vector]: can not open " + path);
+                try {
+                    struct stat st;
+                    if (::fstat(m_fd, &st) != 0)
+                        throw std::runtime_error("[mapped_vector]: can not stat " + path);
+                    if (st.st_size == 0 and not m_read_only)
+                        create(type_tag);
+                    else
+                        open_existing(static_cast<size_type>(st.st_size), type_tag);
+                }
+                catch (...) {
+                    close();
+                    throw;
+                }
+            }
+
+            //* Move constructor. other is left closed, and empty.
+            mapped_vector(mapped_vector &&other) noexcept
+                : m_path{std::move(other.m_path)},
+                  m_read_only{other.m_read_only},
+                  m_fd{other.m_fd},
+                  m_base{other.m_base},
+                  m_mapped{other.m_mapped}
+            {
+                other.m_fd = -1;
+                other.m_base = nullptr;
+                other.m_mapped = 0;
+            }
+
+            mapped_vector(const mapped_vector &) = delete;
+            mapped_vector &operator=(const mapped_vector &) = delete;
+
+            //* Unmaps and closes the file. The kernel writes the dirty pages back.
+            ~mapped_vector(void) { close(); }
+
+            //!=== [II] Iterators
+            //* An iterator pointing to the first item in the list.
+            iterator begin(void) { return iterator(data()); }
+
+            //* A constant iterator pointing to the first item in the list.
+            const_iterator cbegin(void) const { return const_iterator(data()); }
+            const_iterator begin(void) const { return cbegin(); }
+
+            //* An iterator pointing to the position just after the last element of the list.
+            iterator end(void) { return iterator(data() + size()); }
+
+            //* A constant iterator pointing to the position just after the last element of the list.
+            const_iterator cend(void) const { return const_iterator(data() + size()); }
+            const_iterator end(void) const { return cend(); }
+
+            //!=== [III] Capacity
+            //* Check the size of the vector.
+            size_type size(void) const { return m_base == nullptr ? 0 : static_cast<size_type>(head()->size); }
+
+            //* Check the capacity of the vector, that is, how many elements fit in the file.
+            size_type capacity(void) const { return m_base == nullptr ? 0 : static_cast<size_type>(head()->capacity); }
+
+            //* Check if the vector is empty, that is, there are no elements.
+            bool empty(void) const { return size() == 0; }
+
+            //* Check if the file was opened read-only.
+            bool read_only(void) const { return m_read_only; }
+
+            //* The path of the backing file.
+            const std::string &path(void) const { return m_path; }
+
+            //!=== [IV] Modifiers
+            //* Removes all elements. The file keeps its capacity.
+            void clear(void)
+            {
+                check_writable("clear()");
+                head()->size = 0;
+            }
+
+            //* Adds value to the end of the list, growing the file if needed.
+            void push_back(const_reference value)
+            {
+                check_writable("push_back()");
+                size_type n{size()};
+                if (n == capacity()) {
+                    // value may live in the mapping that is about to move.
+                    value_type copy(value);
+                    reserve(growth::doubling::grow(capacity(), n + 1, sizeof(T)));
+                    data()[n] = copy;
+                }
+                else {
+                    data()[n] = value;
+                }
+                head()->size = n + 1;
+            }
+
+            //* Appends the elements of the range [first, last), growing the file once.
+            template <typename InputItr>
+            void append(InputItr first, InputItr last)
+            {
+                check_writable("append()");
+                size_type n{size()};
+                size_type count = std::distance(first, last);
+                if (n + count > capacity())
+                    reserve(growth::doubling::grow(capacity(), n + count, sizeof(T)));
+                pointer dest{data() + n};
+                for ( /*empty*/ ; first != last ; ++first, ++dest)
+                    *dest = *first;
+                head()->size = n + count;
+            }
+
+            //* Removes the object at the end of the list.
+            void pop_back(void)
+            {
+                check_writable("pop_back()");
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[mapped_vector::pop_back()]: Can not remove an element from an empty vector.");
+                head()->size -= 1;
+            }
+
+            //* Grows the file so that it holds cap_ elements, if cap_ > capacity().
+            void reserve(size_type cap_)
+            {
+                check_writable("reserve()");
+                if (cap_ > capacity())
+                    resize_file(cap_);
+            }
+
+            //* Shrinks the file down to the elements in use.
+            void shrink_to_fit(void)
+            {
+                check_writable("shrink_to_fit()");
+                if (size() < capacity())
+                    resize_file(size());
+            }
+
+            //* Schedules the dirty pages to be written to the file, and waits for it if wait is true.
+            void flush(bool wait = true)
+            {
+                if (m_base != nullptr and not m_read_only)
+                    ::msync(m_base, m_mapped, wait ? MS_SYNC : MS_ASYNC);
+            }
+
+            //!=== [V] Element access
+            //* Returns the element at the end of the list, just to read.
+            const_reference back(void) const
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[mapped_vector::back()]: empty vector.");
+                return data()[size() - 1];
+            }
+
+            //* Returns the element at the beginning of the list, just to read.
+            const_reference front(void) const
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[mapped_vector::front()]: empty vector.");
+                return data()[0];
+            }
+
+            //* Returns a reference of the element at the end of the list.
+            reference back(void)
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[mapped_vector::back()]: empty vector.");
+                return data()[size() - 1];
+            }
+
+            //* Returns a reference of the element at the beginning of the list.
+            reference front(void)
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[mapped_vector::front()]: empty vector.");
+                return data()[0];
+            }
+
+            //* Access the element in the position pos, just to read. Checked according to SC_BOUNDS_CHECK.
+            const_reference operator[](size_type pos) const
+            {
+                SC_EXPECTS(pos < size(), std::out_of_range, "[mapped_vector::operator[]]: position provided is out of vector range");
+                return data()[pos];
+            }
+
+            //* Access the element in the position pos, can change the value (read_write mode only).
+            reference operator[](size_type pos)
+            {
+                SC_EXPECTS(pos < size(), std::out_of_range, "[mapped_vector::operator[]]: position provided is out of vector range");
+                return data()[pos];
+            }
+
+            //* Returns the value at the index pos in the vector, with bounds-checking.
+            const_reference at(size_type pos) const
+            {
+                if (pos >= size())
+                    throw std::out_of_range("[mapped_vector::at(pos)]: position provided is out of vector range");
+                return data()[pos];
+            }
+
+            //* Returns the element of the index pos in the vector, with bounds-checking.
+            reference at(size_type pos)
+            {
+                if (pos >= size())
+                    throw std::out_of_range("[mapped_vector::at(pos)]: position provided is out of vector range");
+                return data()[pos];
+            }
+
+            //* Pointer to the first element, inside the mapping; nullptr once moved from. Every non-const
+            //* accessor goes through it, so writable access to a read-only file is checked according to
+            //* SC_BOUNDS_CHECK: read such a file through a const reference.
+            pointer data(void)
+            {
+                SC_EXPECTS(not m_read_only, std::logic_error, "[mapped_vector::data()]: the file was opened read-only, use const access.");
+                return m_base == nullptr ? nullptr : reinterpret_cast<pointer>(m_base + sizeof(header));
+            }
+            const_pointer data(void) const
+            {
+                return m_base == nullptr ? nullptr : reinterpret_cast<const_pointer>(m_base + sizeof(header));
+            }
+
+        private:
+            //* The header, at the beginning of the mapping.
+            header *head(void) { return reinterpret_cast<header*>(m_base); }
+            const header *head(void) const { return reinterpret_cast<const header*>(m_base); }
+
+            //* File size needed for cap elements.
+            static size_type file_size(size_type cap) { return sizeof(header) + cap * sizeof(T); }
+
+            //* Modifiers are refused on read-only files.
+            void check_writable(const char *what) const
+            {
+                if (m_read_only)
+                    throw std::logic_error(std::string{"[mapped_vector::"} + what + "]: the file was opened read-only.");
+            }
+
+            //* Writes a fresh header into an empty file.
+            void create(std::uint64_t type_tag)
+            {
+                if (::ftruncate(m_fd, file_size(0)) != 0)
+                    throw std::runtime_error("[mapped_vector]: can not grow " + m_path);
+                map(file_size(0));
+                header *h{head()};
+                std::memcpy(h->magic, "SCVECTOR", sizeof(h->magic));
+                h->version = format_version;
+                h->header_size = sizeof(header);
+                h->type_tag = type_tag;
+                h->value_size = sizeof(T);
+                h->size = 0;
+                h->capacity = 0;
+            }
+
+            //* Maps an existing file and checks that it holds elements of our type.
+            void open_existing(size_type length, std::uint64_t type_tag)
+            {
+                if (length < sizeof(header))
+                    throw std::runtime_error("[mapped_vector]: " + m_path + " is too small to be a mapped_vector.");
+                map(length);
+                const header *h{head()};
+                if (std::memcmp(h->magic, "SCVECTOR", sizeof(h->magic)) != 0 or h->version != format_version
+                    or h->header_size != sizeof(header))
+                    throw std::runtime_error("[mapped_vector]: " + m_path + " is not a mapped_vector file (or has another version).");
+                if (h->value_size != sizeof(T) or h->type_tag != type_tag)
+                    throw std::runtime_error("[mapped_vector]: " + m_path + " holds another element type.");
+                if (h->size > h->capacity or length < file_size(h->capacity))
+                    throw std::runtime_error("[mapped_vector]: " + m_path + " is truncated.");
+            }
+
+            //* Maps the first length bytes of the file.
+            void map(size_type length)
+            {
+                int prot{m_read_only ? PROT_READ : PROT_READ | PROT_WRITE};
+                void *p = ::mmap(nullptr, length, prot, MAP_SHARED, m_fd, 0);
+                if (p == MAP_FAILED)
+                    throw std::runtime_error("[mapped_vector]: can not map " + m_path);
+                m_base = static_cast<char*>(p);
+                m_mapped = length;
+            }
+
+            //* Resizes the file to new_cap elements and the mapping with it.
+            void resize_file(size_type new_cap)
+            {
+                size_type length{file_size(new_cap)};
+                if (::ftruncate(m_fd, length) != 0)
+                    throw std::runtime_error("[mapped_vector]: can not resize " + m_path);
+#ifdef __linux__
+                void *p = ::mremap(m_base, m_mapped, length, MREMAP_MAYMOVE);
+                if (p == MAP_FAILED)
+                    throw std::runtime_error("[mapped_vector]: can not remap " + m_path);
+                m_base = static_cast<char*>(p);
+                m_mapped = length;
+#else
+                ::munmap(m_base, m_mapped);
+                m_base = nullptr;
+                map(length);
+#endif
+                head()->capacity = new_cap;
+            }
+
+            //* Unmaps and closes the file, if open.
+            void close(void)
+            {
+                if (m_base != nullptr)
+                    ::munmap(m_base, m_mapped);
+                if (m_fd >= 0)
+                    ::close(m_fd);
+                m_base = nullptr;
+                m_fd = -1;
+            }
+
+            std::string m_path;     //!< The backing file.
+            bool m_read_only;       //!< Whether the file was opened read-only.
+            int m_fd;               //!< The open file.
+            char *m_base;           //!< Start of the mapping, where the header is.
+            size_type m_mapped;     //!< Length of the mapping, in bytes.
+    };
+
+    template <typename T>
+    constexpr std::uint32_t mapped_vector<T>::format_version;
+
+} // namespace sc.
+#endif
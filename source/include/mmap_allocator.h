@@ -0,0 +1,146 @@
+#ifndef _MMAP_ALLOCATOR_H_
+#define _MMAP_ALLOCATOR_H_
+
+#include <cstdlib>      // std::malloc, std::realloc, std::free
+#include <cstddef>      // std::size_t
+#include <cstring>      // std::memcpy
+#include <limits>       // std::numeric_limits<T>
+#include <new>          // std::bad_alloc
+
+#include <sys/mman.h>   // mmap, mremap, munmap, madvise
+#include <unistd.h>     // sysconf
+
+/// Sequence container namespace.
+namespace sc {
+    /// An allocator that moves big blocks to anonymous memory mappings (Linux only).
+    /*!
+     * Blocks smaller than Threshold bytes come from malloc. Blocks of Threshold
+     * bytes or more are anonymous mmap regions, and reallocate() resizes them
+     * with mremap(MREMAP_MAYMOVE): the kernel just remaps the pages, so growing
+     * a huge sc::vector of trivially relocatable elements costs a page-table
+     * update instead of a copy, and shrinking gives the pages back to the OS.
+     *
+     *     sc::vector<double, sc::mmap_allocator<double>> v; // 64 MiB threshold
+     *
+     * \tparam T The type of the elements.
+     * \tparam Threshold Size in bytes from which a block is mapped instead of malloc'ed.
+     * \tparam HugePages Whether mapped blocks are advised with MADV_HUGEPAGE (transparent huge pages).
+     */
+    template <typename T, std::size_t Threshold = (std::size_t{64} << 20), bool HugePages = false>
+    class mmap_allocator
+    {
+        public:
+            using value_type = T;            //!< The value type.
+            using size_type = std::size_t;   //!< The size type.
+
+            //* Size in bytes from which a block is mapped instead of malloc'ed.
+            static constexpr size_type threshold = Threshold;
+
+            //* Rebinds the allocator to another element type, keeping the configuration.
+            template <typename U>
+            struct rebind { using other = mmap_allocator<U, Threshold, HugePages>; };
+
+            mmap_allocator(void) = default;
+            template <typename U>
+            mmap_allocator(const mmap_allocator<U, Threshold, HugePages> &) noexcept { /* empty */ }
+
+            //* Returns raw memory for n elements.
+            T *allocate(size_type n)
+            {
+                size_type sz{bytes(n)};
+                return static_cast<T*>(is_mapped(sz) ? map(sz) : checked(std::malloc(sz)));
+            }
+
+            //* Gives back the block of n elements acquired with allocate() or reallocate().
+            void deallocate(T *p, size_type n) noexcept
+            {
+                size_type sz{n * sizeof(T)};
+                if (is_mapped(sz)) munmap(p, page_round(sz));
+                else std::free(p);
+            }
+
+            //* Resizes the block p (holding old_n elements) to new_n elements, keeping the contents bitwise.
+            //* Mapped blocks are remapped by the kernel; nothing is copied unless the block crosses the threshold.
+            T *reallocate(T *p, size_type old_n, size_type new_n)
+            {
+                size_type old_sz{old_n * sizeof(T)};
+                size_type new_sz{bytes(new_n)};
+                if (p == nullptr)
+                    return allocate(new_n);
+                if (not is_mapped(old_sz) and not is_mapped(new_sz))
+                    return static_cast<T*>(checked(std::realloc(p, new_sz)));
+                if (is_mapped(old_sz) and is_mapped(new_sz)) {
+                    void *q = mremap(p, page_round(old_sz), page_round(new_sz), MREMAP_MAYMOVE);
+                    if (q == MAP_FAILED)
+                        throw std::bad_alloc();
+                    advise(q, page_round(new_sz));
+                    return static_cast<T*>(q);
+                }
+                // Crossing the threshold: move the contents between the two kinds of memory.
+                T *q{allocate(new_n)};
+                std::memcpy(q, p, old_sz < new_sz ? old_sz : new_sz);
+                deallocate(p, old_n);
+                return q;
+            }
+
+        private:
+            //* Whether a block of sz bytes lives in a mapping.
+            static bool is_mapped(size_type sz) { return sz >= Threshold; }
+
+            //* Size in bytes of n elements, guarding against overflow.
+            static size_type bytes(size_type n)
+            {
+                if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+                    throw std::bad_alloc();
+                return n * sizeof(T);
+            }
+
+            //* Rounds sz up to a whole number of pages.
+            static size_type page_round(size_type sz)
+            {
+                static const size_type page{static_cast<size_type>(sysconf(_SC_PAGESIZE))};
+                return (sz + page - 1) / page * page;
+            }
+
+            //* A fresh anonymous mapping of at least sz bytes.
+            static void *map(size_type sz)
+            {
+                void *p = mmap(nullptr, page_round(sz), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (p == MAP_FAILED)
+                    throw std::bad_alloc();
+                advise(p, page_round(sz));
+                return p;
+            }
+
+            //* Asks for transparent huge pages on the mapping, if configured. It is only a hint.
+            static void advise(void *p, size_type len)
+            {
+#ifdef MADV_HUGEPAGE
+                if (HugePages)
+                    madvise(p, len, MADV_HUGEPAGE);
+#else
+                (void) p; (void) len;
+#endif
+            }
+
+            //* Turns a null pointer coming from the C heap into an exception.
+            static void *checked(void *p)
+            {
+                if (p == nullptr)
+                    throw std::bad_alloc();
+                return p;
+            }
+    };
+
+    template <typename T, std::size_t Threshold, bool HugePages>
+    constexpr typename mmap_allocator<T, Threshold, HugePages>::size_type mmap_allocator<T, Threshold, HugePages>::threshold;
+
+    //* Every mmap_allocator with the same configuration can free the blocks of another.
+    template <typename T, typename U, std::size_t Threshold, bool HugePages>
+    bool operator==(const mmap_allocator<T, Threshold, HugePages> &, const mmap_allocator<U, Threshold, HugePages> &) { return true; }
+
+    template <typename T, typename U, std::size_t Threshold, bool HugePages>
+    bool operator!=(const mmap_allocator<T, Threshold, HugePages> &, const mmap_allocator<U, Threshold, HugePages> &) { return false; }
+
+} // namespace sc.
+#endif
@@ -0,0 +1,656 @@
+#ifndef _PACKED_INT_VECTOR_H_
+#define _PACKED_INT_VECTOR_H_
+
+#include <cstddef>      // std::size_t, std::ptrdiff_t
+#include <cstdint>      // std::uint64_t
+#include <cstring>      // std::memcpy
+#include <initializer_list> // std::initializer_list
+#include <iterator>     // std::random_access_iterator_tag
+#include <limits>       // std::numeric_limits
+#include <stdexcept>    // std::out_of_range, std::length_error, std::invalid_argument
+#include <type_traits>  // std::is_integral, std::is_unsigned, std::make_signed
+
+#include "simd.h"       // SC_TARGET, SC_ALWAYS_INLINE, sc::simd::active()
+#include "vector.h"     // sc::vector
+#include "checks.h"     // SC_EXPECTS, SC_EXPECTS_NONEMPTY
+
+/// Sequence container namespace.
+namespace sc {
+    /// Bit-level reads and writes shared by the packed integer containers.
+    namespace packed_detail {
+        using word_type = std::uint64_t;
+
+        //* Bits needed to write value; 0 for 0.
+        inline unsigned bits_for(word_type value) { return value == 0 ? 0 : 64 - static_cast<unsigned>(__builtin_clzll(value)); }
+
+        //* The low width bits set, for width in [0, 64].
+        inline word_type low_mask(unsigned width) { return width >= 64 ? ~word_type{0} : (word_type{1} << width) - 1; }
+
+        inline std::size_t words_for(std::size_t bits) { return (bits + 63) / 64; }
+
+        //* The width bits starting at bit of words, which may straddle two words.
+        inline word_type read(const word_type *words, std::size_t bit, unsigned width)
+        {
+            if (width == 0)
+                return 0;
+            std::size_t w{bit / 64};
+            unsigned off{static_cast<unsigned>(bit % 64)};
+            word_type value{words[w] >> off};
+            if (off + width > 64)
+                value |= words[w + 1] << (64 - off);
+            return value & low_mask(width);
+        }
+
+        //* Overwrites the width bits starting at bit of words with value (< 2^width).
+        inline void write(word_type *words, std::size_t bit, unsigned width, word_type value)
+        {
+            if (width == 0)
+                return;
+            std::size_t w{bit / 64};
+            unsigned off{static_cast<unsigned>(bit % 64)};
+            word_type mask{low_mask(width)};
+            words[w] = (words[w] & ~(mask << off)) | (value << off);
+            if (off + width > 64)
+                words[w + 1] = (words[w + 1] & ~(mask >> (64 - off))) | (value >> (64 - off));
+        }
+
+        //!=== Delta blocks
+        // A block holds 128 deltas in 4 interleaved lanes: delta k lives in lane k % 4, at row
+        // k / 4, and word i of a lane is word 4 * i + lane of the block. Every lane has the same
+        // bit layout, so one vector shift decodes 4 consecutive deltas.
+        const std::size_t block_size{128};
+        const std::size_t lanes{4};
+
+        //* Words of a block of deltas of width bits: 4 lanes of 32 deltas, each lane rounded up to a word.
+        inline std::size_t block_words(unsigned width) { return lanes * words_for(32 * width); }
+
+        inline word_type read_delta(const word_type *block, unsigned width, std::size_t k)
+        {
+            if (width == 0)
+                return 0;
+            std::size_t bit{(k / lanes) * width};
+            std::size_t w{bit / 64};
+            unsigned off{static_cast<unsigned>(bit % 64)};
+            word_type value{block[w * lanes + k % lanes] >> off};
+            if (off + width > 64)
+                value |= block[(w + 1) * lanes + k % lanes] << (64 - off);
+            return value & low_mask(width);
+        }
+
+        //* Stores delta k of a zero-initialized block.
+        inline void write_delta(word_type *block, unsigned width, std::size_t k, word_type value)
+        {
+            if (width == 0)
+                return;
+            std::size_t bit{(k / lanes) * width};
+            std::size_t w{bit / 64};
+            unsigned off{static_cast<unsigned>(bit % 64)};
+            block[w * lanes + k % lanes] |= value << off;
+            if (off + width > 64)
+                block[(w + 1) * lanes + k % lanes] |= value >> (64 - off);
+        }
+
+        //* Scalar reference: out[k] = base + sum of (step + delta j) for j <= k, for the n first deltas.
+        template <typename T>
+        void decode_scalar(const word_type *block, unsigned width, word_type base, word_type step, T *out, std::size_t n)
+        {
+            word_type acc{base};
+            for (std::size_t k{0} ; k < n ; ++k) {
+                acc += step + read_delta(block, width, k);
+                out[k] = static_cast<T>(acc);
+            }
+        }
+
+#if SC_SIMD_X86
+        typedef word_type u64x4 __attribute__((vector_size(32)));
+
+        //* Unpacks a row (4 deltas) per vector shift into a buffer, then runs the sum over it.
+        template <typename T>
+        SC_ALWAYS_INLINE void decode_vec(const word_type *block, unsigned width, word_type base, word_type step, T *out, std::size_t n)
+        {
+            word_type acc{base};
+            if (width == 0) {
+                for (std::size_t k{0} ; k < n ; ++k)
+                    out[k] = static_cast<T>(acc += step);
+                return;
+            }
+            const word_type mask{low_mask(width)};
+            u64x4 deltas[block_size / lanes];
+            std::size_t rows{(n + lanes - 1) / lanes};
+            std::size_t bit{0};
+            for (std::size_t r{0} ; r < rows ; ++r, bit += width) {
+                std::size_t w{bit / 64};
+                unsigned off{static_cast<unsigned>(bit % 64)};
+                u64x4 lo;
+                std::memcpy(&lo, block + w * lanes, sizeof lo);
+                u64x4 row{lo >> off};
+                if (off + width > 64) {
+                    u64x4 hi;
+                    std::memcpy(&hi, block + (w + 1) * lanes, sizeof hi);
+                    row |= hi << (64 - off);
+                }
+                deltas[r] = (row & mask) + step;
+            }
+            const word_type *d{reinterpret_cast<const word_type *>(deltas)};
+            for (std::size_t k{0} ; k < n ; ++k)
+                out[k] = static_cast<T>(acc += d[k]);
+        }
+
+        template <typename T>
+        SC_TARGET("sse2")
+        void decode_sse2(const word_type *block, unsigned width, word_type base, word_type step, T *out, std::size_t n)
+        {
+            decode_vec(block, width, base, step, out, n);
+        }
+
+        template <typename T>
+        SC_TARGET("avx2")
+        void decode_avx2(const word_type *block, unsigned width, word_type base, word_type step, T *out, std::size_t n)
+        {
+            decode_vec(block, width, base, step, out, n);
+        }
+
+        template <typename T>
+        SC_TARGET("avx512f,avx512vl")
+        void decode_avx512(const word_type *block, unsigned width, word_type base, word_type step, T *out, std::size_t n)
+        {
+            decode_vec(block, width, base, step, out, n);
+        }
+#endif
+
+        //* Decodes the n first values of a block with the best path simd::active() allows.
+        template <typename T>
+        void decode(const word_type *block, unsigned width, word_type base, word_type step, T *out, std::size_t n)
+        {
+#if SC_SIMD_X86
+            switch (simd::active()) {
+                case simd::level::avx512: return decode_avx512(block, width, base, step, out, n);
+                case simd::level::avx2:   return decode_avx2(block, width, base, step, out, n);
+                case simd::level::sse2:   return decode_sse2(block, width, base, step, out, n);
+                default: break;
+            }
+#endif
+            decode_scalar(block, width, base, step, out, n);
+        }
+    } // namespace packed_detail.
+
+    /// Unsigned integers packed with as many bits each as the largest of them needs.
+    /*!
+     * A sc::vector<std::uint64_t> of IDs below one million spends 44 of every
+     * 64 bits on zeros. packed_int_vector stores every element on width()
+     * bits, back to back in 64-bit words, and widens all of them (in place,
+     * from the back) when push_back() or set() brings a value that does not
+     * fit. Widening is O(n), and happens at most once per bit of T.
+     *
+     *     sc::packed_int_vector<std::uint32_t> counts;
+     *     counts.push_back(3);                 // width() == 2
+     *     counts.push_back(1000);              // width() == 10, the 3 is repacked
+     *     std::uint32_t c = counts[1];         // a shift and a mask, O(1)
+     *
+     * Elements are read by value; there is no reference to an element, so
+     * writes go through set(). The bits past size() are always zero.
+     * For sorted or slowly varying data, sc::delta_packed_vector is smaller.
+     *
+     * \tparam T An unsigned integer type, of at most 64 bits.
+     */
+    template <typename T = std::uint64_t>
+    class packed_int_vector
+    {
+        static_assert(std::is_integral<T>::value and std::is_unsigned<T>::value and sizeof(T) <= 8,
+                      "[packed_int_vector]: The elements must be unsigned integers of at most 64 bits.");
+
+        //=== Aliases
+        public:
+            using size_type = unsigned long;    //!< The size type.
+            using value_type = T;               //!< The value type.
+            using word_type = std::uint64_t;    //!< The storage unit.
+            static constexpr unsigned max_width = std::numeric_limits<T>::digits; //!< Bits of T.
+
+            /// Read-only random access iterator; dereferencing decodes the element.
+            class const_iterator
+            {
+                public:
+                    using difference_type = std::ptrdiff_t;
+                    using value_type = T;
+                    using reference = T;
+                    using pointer = void;
+                    using iterator_category = std::random_access_iterator_tag;
+
+                    const_iterator(const packed_int_vector *vec = nullptr, size_type pos = 0) : m_vec{vec}, m_pos{pos} { /* empty */ }
+
+                    T operator*(void) const { return (*m_vec)[m_pos]; }
+                    T operator[](difference_type n) const { return (*m_vec)[m_pos + n]; }
+
+                    const_iterator &operator++(void) { ++m_pos; return *this; }
+                    const_iterator operator++(int) { const_iterator old{*this}; ++m_pos; return old; }
+                    const_iterator &operator--(void) { --m_pos; return *this; }
+                    const_iterator operator--(int) { const_iterator old{*this}; --m_pos; return old; }
+                    const_iterator &operator+=(difference_type n) { m_pos += n; return *this; }
+                    const_iterator &operator-=(difference_type n) { m_pos -= n; return *this; }
+
+                    friend const_iterator operator+(const_iterator it, difference_type n) { return it += n; }
+                    friend const_iterator operator+(difference_type n, const_iterator it) { return it += n; }
+                    friend const_iterator operator-(const_iterator it, difference_type n) { return it -= n; }
+                    friend difference_type operator-(const const_iterator &a, const const_iterator &b)
+                    {
+                        return static_cast<difference_type>(a.m_pos) - static_cast<difference_type>(b.m_pos);
+                    }
+
+                    friend bool operator==(const const_iterator &a, const const_iterator &b) { return a.m_pos == b.m_pos; }
+                    friend bool operator!=(const const_iterator &a, const const_iterator &b) { return a.m_pos != b.m_pos; }
+                    friend bool operator<(const const_iterator &a, const const_iterator &b) { return a.m_pos < b.m_pos; }
+                    friend bool operator>(const const_iterator &a, const const_iterator &b) { return a.m_pos > b.m_pos; }
+                    friend bool operator<=(const const_iterator &a, const const_iterator &b) { return a.m_pos <= b.m_pos; }
+                    friend bool operator>=(const const_iterator &a, const const_iterator &b) { return a.m_pos >= b.m_pos; }
+
+                private:
+                    const packed_int_vector *m_vec; //!< The elements iterated over.
+                    size_type m_pos;                //!< The current element.
+            };
+
+            using iterator = const_iterator;    //!< Elements are written with set().
+
+        public:
+            //!=== [I] Special members
+            //* An empty vector, without memory. Its width grows with the values pushed.
+            packed_int_vector(void) : m_size{0}, m_width{0} { /* empty */ }
+
+            //* An empty vector whose elements take width bits from the start.
+            explicit packed_int_vector(unsigned width) : m_size{0}, m_width{width}
+            {
+                if (width > max_width)
+                    throw std::invalid_argument("[packed_int_vector(width)]: The width is larger than the value type.");
+            }
+
+            //* The values of the list, packed on the width of the largest one.
+            packed_int_vector(std::initializer_list<T> il) : m_size{0}, m_width{0} { assign(il.begin(), il.size()); }
+
+            //* A packed copy of values.
+            template <typename A, typename G>
+            explicit packed_int_vector(const vector<T, A, G> &values) : m_size{0}, m_width{0} { assign(values.data(), values.size()); }
+
+            //!=== [II] Iterators
+            const_iterator begin(void) const { return const_iterator(this, 0); }
+            const_iterator end(void) const { return const_iterator(this, m_size); }
+            const_iterator cbegin(void) const { return begin(); }
+            const_iterator cend(void) const { return end(); }
+
+            //!=== [III] Capacity
+            size_type size(void) const { return m_size; }
+            bool empty(void) const { return m_size == 0; }
+
+            //* Bits each element takes.
+            unsigned width(void) const { return m_width; }
+
+            //* Bytes of memory held for the elements.
+            size_type bytes(void) const { return m_words.capacity() * sizeof(word_type); }
+
+            //* Makes room for count elements of the current width.
+            void reserve(size_type count) { m_words.reserve(packed_detail::words_for(count * m_width)); }
+
+            void shrink_to_fit(void) { m_words.shrink_to_fit(); }
+
+            //!=== [IV] Modifiers
+            //* Removes every element; the width is kept.
+            void clear(void)
+            {
+                m_words.clear();
+                m_size = 0;
+            }
+
+            //* Appends value, widening every element first if it does not fit.
+            void push_back(T value)
+            {
+                widen(packed_detail::bits_for(value));
+                ++m_size;
+                fit_words();
+                packed_detail::write(m_words.data(), (m_size - 1) * m_width, m_width, value);
+            }
+
+            //* Removes the last element.
+            void pop_back(void)
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[packed_int_vector::pop_back()]: Can not remove an element from an empty vector.");
+                --m_size;
+                packed_detail::write(m_words.data(), m_size * m_width, m_width, 0);
+                fit_words();
+            }
+
+            //* Changes the number of elements to count; new elements are set to value.
+            void resize(size_type count, T value = 0)
+            {
+                while (m_size > count)
+                    pop_back();
+                if (m_size < count) {
+                    widen(packed_detail::bits_for(value));
+                    reserve(count);
+                    while (m_size < count)
+                        push_back(value);
+                }
+            }
+
+            //* Sets the element at pos to value, widening every element first if it does not fit.
+            //* Checked according to SC_BOUNDS_CHECK.
+            void set(size_type pos, T value)
+            {
+                SC_EXPECTS(pos < m_size, std::out_of_range, "[packed_int_vector::set()]: position provided is out of vector range");
+                widen(packed_detail::bits_for(value));
+                packed_detail::write(m_words.data(), pos * m_width, m_width, value);
+            }
+
+            friend void swap(packed_int_vector &a, packed_int_vector &b)
+            {
+                using std::swap;
+                swap(a.m_words, b.m_words);
+                swap(a.m_size, b.m_size);
+                swap(a.m_width, b.m_width);
+            }
+
+            //!=== [V] Element access
+            //* The element at pos. Checked according to SC_BOUNDS_CHECK.
+            T operator[](size_type pos) const
+            {
+                SC_EXPECTS(pos < m_size, std::out_of_range, "[packed_int_vector::operator[]]: position provided is out of vector range");
+                return static_cast<T>(packed_detail::read(m_words.data(), pos * m_width, m_width));
+            }
+
+            //* The element at pos, with bounds-checking.
+            T at(size_type pos) const
+            {
+                if (pos >= m_size)
+                    throw std::out_of_range("[packed_int_vector::at(pos)]: position provided is out of vector range");
+                return (*this)[pos];
+            }
+
+            //* The first element. Checked according to SC_EMPTY_CHECK.
+            T front(void) const
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[packed_int_vector::front()]: empty vector.");
+                return (*this)[0];
+            }
+
+            //* The last element. Checked according to SC_EMPTY_CHECK.
+            T back(void) const
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[packed_int_vector::back()]: empty vector.");
+                return (*this)[m_size - 1];
+            }
+
+            //* Writes the count elements from first on to out.
+            void decode(size_type first, size_type count, T *out) const
+            {
+                std::size_t bit{first * m_width};
+                for (size_type i{0} ; i < count ; ++i, bit += m_width)
+                    out[i] = static_cast<T>(packed_detail::read(m_words.data(), bit, m_width));
+            }
+
+            //* The elements, unpacked.
+            vector<T> to_vector(void) const
+            {
+                vector<T> out;
+                out.assign(m_size, T{0});
+                decode(0, m_size, out.data());
+                return out;
+            }
+
+            //* The words holding the elements, element i on bits [i * width(), (i + 1) * width()).
+            const word_type *data(void) const { return m_words.data(); }
+
+            friend bool operator==(const packed_int_vector &a, const packed_int_vector &b)
+            {
+                if (a.m_size != b.m_size)
+                    return false;
+                if (a.m_width == b.m_width)
+                    return a.m_words == b.m_words;
+                for (size_type i{0} ; i < a.m_size ; ++i)
+                    if (a[i] != b[i])
+                        return false;
+                return true;
+            }
+
+            friend bool operator!=(const packed_int_vector &a, const packed_int_vector &b) { return not (a == b); }
+
+        private:
+            //* Packs the count values at values, on the width of the largest.
+            void assign(const T *values, size_type count)
+            {
+                word_type all{0};
+                for (size_type i{0} ; i < count ; ++i)
+                    all |= values[i];
+                m_width = packed_detail::bits_for(all);
+                m_words.clear();
+                m_size = count;
+                reserve(count);
+                fit_words();
+                for (size_type i{0} ; i < count ; ++i)
+                    packed_detail::write(m_words.data(), i * m_width, m_width, values[i]);
+            }
+
+            //* Makes m_words exactly as long as m_size elements need; new words are zero.
+            void fit_words(void)
+            {
+                size_type words{packed_detail::words_for(m_size * m_width)};
+                while (m_words.size() < words)
+                    m_words.push_back(0);
+                while (m_words.size() > words)
+                    m_words.pop_back();
+            }
+
+            //* Repacks every element on width bits, if that is wider than now.
+            void widen(unsigned width)
+            {
+                if (width <= m_width)
+                    return;
+                unsigned old{m_width};
+                m_width = width;
+                fit_words();
+                // Back to front: element i moves up to bit i * width, past the old bits of every element before it.
+                for (size_type i{m_size} ; i-- > 0 ; /*empty*/)
+                    packed_detail::write(m_words.data(), i * width, width, packed_detail::read(m_words.data(), i * old, old));
+            }
+
+            vector<word_type> m_words;  //!< The elements, m_width bits each; the bits past the last one are 0.
+            size_type m_size;           //!< Number of elements.
+            unsigned m_width;           //!< Bits per element.
+    };
+
+    template <typename T>
+    constexpr unsigned packed_int_vector<T>::max_width;
+
+    /// A read-only, block-delta encoded copy of a sequence of unsigned integers.
+    /*!
+     * Sorted IDs, timestamps and other slowly varying sequences need few bits
+     * once stored as differences. delta_packed_vector splits the values into
+     * blocks of 128, and for each block keeps the first value, the smallest
+     * difference between neighbours (the step) and, for every element, how
+     * much its difference exceeds the step, on as many bits as the largest
+     * excess needs. A sequence of consecutive IDs takes 0 bits per element; a
+     * decreasing or unsorted block still decodes exactly, on up to 64 bits.
+     *
+     *     sc::vector<std::uint32_t> ids = ...;     // sorted
+     *     sc::delta_packed_vector<std::uint32_t> packed(ids);
+     *     std::uint32_t id = packed[i];            // O(i % 128)
+     *     packed.for_each_block([&](const std::uint32_t *values, std::size_t n) { ... });
+     *
+     * Scans go through for_each_block(), decode() or to_vector(), which
+     * unpack 4 differences per step with SSE2, AVX2 or AVX-512, whichever
+     * simd::active() selects. Each block costs 32 bytes of header.
+     *
+     * \tparam T An unsigned integer type, of at most 64 bits.
+     */
+    template <typename T = std::uint64_t>
+    class delta_packed_vector
+    {
+        static_assert(std::is_integral<T>::value and std::is_unsigned<T>::value and sizeof(T) <= 8,
+                      "[delta_packed_vector]: The elements must be unsigned integers of at most 64 bits.");
+
+        //=== Aliases
+        public:
+            using size_type = unsigned long;    //!< The size type.
+            using value_type = T;               //!< The value type.
+            using word_type = std::uint64_t;    //!< The storage unit.
+            static constexpr size_type block_size = packed_detail::block_size; //!< Elements per block.
+
+        public:
+            //!=== [I] Special members
+            //* An empty sequence.
+            delta_packed_vector(void) : m_size{0} { /* empty */ }
+
+            //* Encodes the count values at values.
+            delta_packed_vector(const T *values, size_type count) : m_size{0} { encode(values, count); }
+
+            //* Encodes values.
+            template <typename A, typename G>
+            explicit delta_packed_vector(const vector<T, A, G> &values) : m_size{0} { encode(values.data(), values.size()); }
+
+            //!=== [II] Capacity
+            size_type size(void) const { return m_size; }
+            bool empty(void) const { return m_size == 0; }
+            size_type block_count(void) const { return m_blocks.size(); }
+
+            //* Bytes of memory held: the packed differences and the block headers.
+            size_type bytes(void) const
+            {
+                return m_words.capacity() * sizeof(word_type) + m_blocks.capacity() * sizeof(block);
+            }
+
+            //!=== [III] Element access
+            //* The element at pos, adding up the differences before it in its block. Checked according to SC_BOUNDS_CHECK.
+            T operator[](size_type pos) const
+            {
+                SC_EXPECTS(pos < m_size, std::out_of_range, "[delta_packed_vector::operator[]]: position provided is out of vector range");
+                const block &b{m_blocks[pos / block_size]};
+                size_type k{pos % block_size};
+                word_type acc{b.base + (k + 1) * b.step};
+                for (size_type j{0} ; j <= k ; ++j)
+                    acc += packed_detail::read_delta(m_words.data() + b.offset, b.width, j);
+                return static_cast<T>(acc);
+            }
+
+            //* The element at pos, with bounds-checking.
+            T at(size_type pos) const
+            {
+                if (pos >= m_size)
+                    throw std::out_of_range("[delta_packed_vector::at(pos)]: position provided is out of vector range");
+                return (*this)[pos];
+            }
+
+            //* The first element. Checked according to SC_EMPTY_CHECK.
+            T front(void) const
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[delta_packed_vector::front()]: empty vector.");
+                return (*this)[0];
+            }
+
+            //* The last element. Checked according to SC_EMPTY_CHECK.
+            T back(void) const
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[delta_packed_vector::back()]: empty vector.");
+                return (*this)[m_size - 1];
+            }
+
+            //* Writes the elements of block b (block_size of them, fewer in the last block) to out.
+            void decode_block(size_type b, T *out) const
+            {
+                const block &h{m_blocks[b]};
+                packed_detail::decode(m_words.data() + h.offset, h.width, h.base, h.step, out, block_length(b));
+            }
+
+            //* Writes every element to out, which has room for size() of them.
+            void decode(T *out) const
+            {
+                for (size_type b{0} ; b < m_blocks.size() ; ++b)
+                    decode_block(b, out + b * block_size);
+            }
+
+            //* Calls f(values, count) on each block in turn, decoded into a buffer on the stack.
+            template <typename F>
+            void for_each_block(F f) const
+            {
+                T buffer[block_size];
+                for (size_type b{0} ; b < m_blocks.size() ; ++b) {
+                    decode_block(b, buffer);
+                    f(static_cast<const T *>(buffer), static_cast<std::size_t>(block_length(b)));
+                }
+            }
+
+            //* The elements, decoded.
+            vector<T> to_vector(void) const
+            {
+                vector<T> out;
+                out.assign(m_size, T{0});
+                decode(out.data());
+                return out;
+            }
+
+            friend bool operator==(const delta_packed_vector &a, const delta_packed_vector &b)
+            {
+                if (a.m_size != b.m_size)
+                    return false;
+                T x[block_size], y[block_size];
+                for (size_type i{0} ; i < a.m_blocks.size() ; ++i) {
+                    a.decode_block(i, x);
+                    b.decode_block(i, y);
+                    if (std::memcmp(x, y, a.block_length(i) * sizeof(T)) != 0)
+                        return false;
+                }
+                return true;
+            }
+
+            friend bool operator!=(const delta_packed_vector &a, const delta_packed_vector &b) { return not (a == b); }
+
+        private:
+            //* Where a block starts in m_words and how to rebuild its values.
+            struct block
+            {
+                word_type base;     //!< The first value minus step.
+                word_type step;     //!< The smallest difference between neighbours, added to every delta.
+                size_type offset;   //!< First word of the block in m_words.
+                unsigned width;     //!< Bits per delta.
+            };
+
+            size_type block_length(size_type b) const { return b + 1 < m_blocks.size() ? block_size : m_size - b * block_size; }
+
+            void encode(const T *values, size_type count)
+            {
+                using signed_type = typename std::make_signed<T>::type;
+                m_size = count;
+                m_blocks.reserve((count + block_size - 1) / block_size);
+                for (size_type first{0} ; first < count ; first += block_size) {
+                    const T *p{values + first};
+                    size_type n{count - first < block_size ? count - first : block_size};
+                    // The differences wrap around modulo 2^bits(T); the step is the smallest as a signed value.
+                    T step{0};
+                    for (size_type k{1} ; k < n ; ++k) {
+                        T d{static_cast<T>(p[k] - p[k - 1])};
+                        if (k == 1 or static_cast<signed_type>(d) < static_cast<signed_type>(step))
+                            step = d;
+                    }
+                    word_type all{0};
+                    for (size_type k{1} ; k < n ; ++k)
+                        all |= static_cast<T>(static_cast<T>(p[k] - p[k - 1]) - step);
+                    unsigned width{packed_detail::bits_for(all)};
+
+                    size_type offset{m_words.size()};
+                    for (size_type i{0} ; i < packed_detail::block_words(width) ; ++i)
+                        m_words.push_back(0);
+                    // Delta 0 is 0: the first value is base + step.
+                    for (size_type k{1} ; k < n ; ++k)
+                        packed_detail::write_delta(m_words.data() + offset, width, k,
+                                                   static_cast<T>(static_cast<T>(p[k] - p[k - 1]) - step));
+                    m_blocks.push_back(block{static_cast<T>(p[0] - step), step, offset, width});
+                }
+                // Read-only from here on: give back what the growth left over.
+                m_words.shrink_to_fit();
+            }
+
+            vector<block> m_blocks;     //!< One header per block of block_size elements.
+            vector<word_type> m_words;  //!< The deltas of every block, back to back.
+            size_type m_size;           //!< Number of elements.
+    };
+
+    template <typename T>
+    constexpr typename delta_packed_vector<T>::size_type delta_packed_vector<T>::block_size;
+
+} // namespace sc.
+#endif
@@ -0,0 +1,264 @@
+#ifndef _PARALLEL_H_
+#define _PARALLEL_H_
+
+#include <algorithm>    // std::for_each, std::transform, std::fill, std::copy
+#include <cstddef>      // std::size_t, std::ptrdiff_t
+#include <functional>   // std::plus
+#include <iterator>     // std::iterator_traits
+#include <stdexcept>    // std::length_error
+#include <type_traits>  // std::enable_if, std::remove_cv
+#include <utility>      // std::declval
+#include <vector>       // std::vector
+
+#include "thread_pool.h" // sc::thread_pool
+
+/// Sequence container namespace.
+namespace sc {
+    /// Parallel versions of the linear algorithms, run on a sc::thread_pool.
+    /*!
+     * Each algorithm takes either an iterator range (pointers, sc::vector
+     * iterators, any iterator with + and -) or a contiguous container with
+     * data() and size(), splits it into chunks and hands the chunks to the
+     * threads of the pool:
+     *
+     *     sc::vector<double> v(100000000);
+     *     sc::parallel::fill(v, 1.0);
+     *     double total = sc::parallel::reduce(v, 0.0);
+     *
+     *     sc::thread_pool pool(8);
+     *     sc::parallel::for_each(v, [](double &x) { x *= 2; }, sc::parallel::options(pool, 1 << 16));
+     *
+     * Without options the shared thread_pool::global() is used and the grain
+     * is chosen from the size of the range: chunks of at least 32 KiB, so the
+     * per-task cost stays negligible, and about 8 chunks per thread, so a slow
+     * thread does not hold up the others. The functions must be safe to call
+     * concurrently on different elements. reduce() and inclusive_scan() combine
+     * the chunks in order, so op only has to be associative, not commutative.
+     */
+    namespace parallel {
+        /// Which pool runs an algorithm, and how many elements each task gets (0 = automatic).
+        struct options
+        {
+            thread_pool *pool;  //!< The threads to run on.
+            std::size_t grain;  //!< Elements per chunk; 0 picks it from the size of the range.
+
+            options(void) : pool{&thread_pool::global()}, grain{0} { /* empty */ }
+            explicit options(std::size_t grain_) : pool{&thread_pool::global()}, grain{grain_} { /* empty */ }
+            explicit options(thread_pool &pool_, std::size_t grain_ = 0) : pool{&pool_}, grain{grain_} { /* empty */ }
+        };
+
+        namespace detail {
+            /// Whether It can be dereferenced and incremented, to tell ranges from containers.
+            template <typename It, typename = void>
+            struct is_iterator : std::false_type {};
+
+            template <typename It>
+            struct is_iterator<It, decltype(void(*std::declval<It&>()), void(++std::declval<It&>()))> : std::true_type {};
+
+            template <typename It, typename R = void>
+            using if_iterator = typename std::enable_if<is_iterator<It>::value, R>::type;
+
+            template <typename C, typename R = void>
+            using if_container = typename std::enable_if<not is_iterator<C>::value, R>::type;
+
+            template <typename It>
+            using value_of = typename std::remove_cv<typename std::iterator_traits<It>::value_type>::type;
+
+            //* The chunk size for n elements of element_size bytes each.
+            inline std::size_t grain_for(const options &opt, std::size_t n, std::size_t element_size)
+            {
+                if (opt.grain != 0)
+                    return opt.grain;
+                std::size_t threads{opt.pool->size()};
+                if (threads == 1)
+                    return n == 0 ? 1 : n;
+                std::size_t min_grain{(32 * 1024) / element_size + 1};
+                std::size_t balanced{n / (8 * threads) + 1};
+                return balanced > min_grain ? balanced : min_grain;
+            }
+
+            //* Throws std::length_error if the destination is shorter than the source.
+            inline void check_sizes(std::size_t source, std::size_t destination, const char *msg)
+            {
+                if (destination < source)
+                    throw std::length_error(msg);
+            }
+        } // namespace detail.
+
+        //!=== Iterator ranges
+        //* Calls f on every element of [first, last).
+        template <typename It, typename F>
+        detail::if_iterator<It> for_each(It first, It last, F f, const options &opt = options())
+        {
+            std::size_t n = static_cast<std::size_t>(last - first);
+            opt.pool->run_chunks(n, detail::grain_for(opt, n, sizeof(detail::value_of<It>)),
+                [&](std::size_t lo, std::size_t hi) { std::for_each(first + lo, first + hi, f); });
+        }
+
+        //* Writes op(x) for every x of [first, last) to the range starting at d_first. Returns the end of the output.
+        template <typename It, typename Out, typename Op>
+        detail::if_iterator<It, Out> transform(It first, It last, Out d_first, Op op, const options &opt = options())
+        {
+            std::size_t n = static_cast<std::size_t>(last - first);
+            opt.pool->run_chunks(n, detail::grain_for(opt, n, sizeof(detail::value_of<It>)),
+                [&](std::size_t lo, std::size_t hi) { std::transform(first + lo, first + hi, d_first + lo, op); });
+            return d_first + n;
+        }
+
+        //* Assigns value to every element of [first, last).
+        template <typename It, typename T>
+        detail::if_iterator<It> fill(It first, It last, const T &value, const options &opt = options())
+        {
+            std::size_t n = static_cast<std::size_t>(last - first);
+            opt.pool->run_chunks(n, detail::grain_for(opt, n, sizeof(detail::value_of<It>)),
+                [&](std::size_t lo, std::size_t hi) { std::fill(first + lo, first + hi, value); });
+        }
+
+        //* Copies [first, last) to the range starting at d_first, which must not overlap it. Returns the end of the output.
+        template <typename It, typename Out>
+        detail::if_iterator<It, Out> copy(It first, It last, Out d_first, const options &opt = options())
+        {
+            std::size_t n = static_cast<std::size_t>(last - first);
+            opt.pool->run_chunks(n, detail::grain_for(opt, n, sizeof(detail::value_of<It>)),
+                [&](std::size_t lo, std::size_t hi) { std::copy(first + lo, first + hi, d_first + lo); });
+            return d_first + n;
+        }
+
+        //* Folds [first, last) with op, starting from init. Each chunk is folded on its own thread, then
+        //* the partial results are folded in order, so op must be associative.
+        template <typename It, typename T, typename Op>
+        detail::if_iterator<It, T> reduce(It first, It last, T init, Op op, const options &opt = options())
+        {
+            std::size_t n = static_cast<std::size_t>(last - first);
+            if (n == 0)
+                return init;
+            std::size_t grain{detail::grain_for(opt, n, sizeof(detail::value_of<It>))};
+            std::vector<T> partial((n - 1) / grain + 1, init);
+            opt.pool->run_chunks(n, grain, [&](std::size_t lo, std::size_t hi) {
+                It it{first + lo};
+                T acc = *it;
+                for (std::size_t i{lo + 1} ; i < hi ; ++i)
+                    acc = op(acc, *++it);
+                partial[lo / grain] = acc;
+            });
+            for (const T &p : partial)
+                init = op(init, p);
+            return init;
+        }
+
+        //* Sum of [first, last), plus init.
+        template <typename It, typename T>
+        detail::if_iterator<It, T> reduce(It first, It last, T init, const options &opt = options())
+        {
+            return reduce(first, last, init, std::plus<T>(), opt);
+        }
+
+        //* Writes the running fold of [first, last) with op to the range starting at d_first (d_first may be first).
+        //* Two passes over the chunks: their totals are folded first, then each chunk is scanned from the total
+        //* of the chunks before it. Returns the end of the output.
+        template <typename It, typename Out, typename Op>
+        detail::if_iterator<It, Out> inclusive_scan(It first, It last, Out d_first, Op op, const options &opt = options())
+        {
+            using T = detail::value_of<It>;
+            std::size_t n = static_cast<std::size_t>(last - first);
+            if (n == 0)
+                return d_first;
+            std::size_t grain{detail::grain_for(opt, n, sizeof(T))};
+            std::size_t chunks{(n - 1) / grain + 1};
+            if (chunks == 1) {
+                T acc = *first;
+                *d_first = acc;
+                for (std::size_t i{1} ; i < n ; ++i)
+                    *(d_first + i) = acc = op(acc, *(first + i));
+                return d_first + n;
+            }
+
+            // [1] Total of every chunk but the last one.
+            std::vector<T> carry;
+            carry.reserve(chunks);
+            for (std::size_t k{0} ; k < chunks ; ++k)
+                carry.push_back(*first);
+            opt.pool->run_chunks((chunks - 1) * grain, grain,
+                [&](std::size_t lo, std::size_t hi) {
+                    T acc = *(first + lo);
+                    for (std::size_t i{lo + 1} ; i < hi ; ++i)
+                        acc = op(acc, *(first + i));
+                    carry[lo / grain + 1] = acc;
+                });
+            // [2] carry[k] becomes the total of the chunks before chunk k.
+            for (std::size_t k{2} ; k < chunks ; ++k)
+                carry[k] = op(carry[k - 1], carry[k]);
+            // [3] Scan each chunk, starting from its carry.
+            opt.pool->run_chunks(n, grain, [&](std::size_t lo, std::size_t hi) {
+                T acc = lo == 0 ? *first : op(carry[lo / grain], *(first + lo));
+                *(d_first + lo) = acc;
+                for (std::size_t i{lo + 1} ; i < hi ; ++i)
+                    *(d_first + i) = acc = op(acc, *(first + i));
+            });
+            return d_first + n;
+        }
+
+        //* Running sum of [first, last), written to the range starting at d_first.
+        template <typename It, typename Out>
+        detail::if_iterator<It, Out> inclusive_scan(It first, It last, Out d_first, const options &opt = options())
+        {
+            return inclusive_scan(first, last, d_first, std::plus<detail::value_of<It>>(), opt);
+        }
+
+        //!=== Contiguous containers
+        template <typename C, typename F>
+        detail::if_container<C> for_each(C &c, F f, const options &opt = options())
+        {
+            for_each(c.data(), c.data() + c.size(), f, opt);
+        }
+
+        template <typename C, typename T>
+        detail::if_container<C> fill(C &c, const T &value, const options &opt = options())
+        {
+            fill(c.data(), c.data() + c.size(), value, opt);
+        }
+
+        template <typename C, typename T, typename Op>
+        detail::if_container<C, T> reduce(const C &c, T init, Op op, const options &opt = options())
+        {
+            return reduce(c.data(), c.data() + c.size(), init, op, opt);
+        }
+
+        template <typename C, typename T>
+        detail::if_container<C, T> reduce(const C &c, T init, const options &opt = options())
+        {
+            return reduce(c.data(), c.data() + c.size(), init, opt);
+        }
+
+        //* The containers are not resized: out must already hold in.size() elements, else std::length_error is thrown.
+        template <typename C1, typename C2, typename Op>
+        detail::if_container<C1> transform(const C1 &in, C2 &out, Op op, const options &opt = options())
+        {
+            detail::check_sizes(in.size(), out.size(), "[parallel::transform()]: The output is shorter than the input.");
+            transform(in.data(), in.data() + in.size(), out.data(), op, opt);
+        }
+
+        template <typename C1, typename C2>
+        detail::if_container<C1> copy(const C1 &in, C2 &out, const options &opt = options())
+        {
+            detail::check_sizes(in.size(), out.size(), "[parallel::copy()]: The output is shorter than the input.");
+            copy(in.data(), in.data() + in.size(), out.data(), opt);
+        }
+
+        template <typename C1, typename C2, typename Op>
+        detail::if_container<C1> inclusive_scan(const C1 &in, C2 &out, Op op, const options &opt = options())
+        {
+            detail::check_sizes(in.size(), out.size(), "[parallel::inclusive_scan()]: The output is shorter than the input.");
+            inclusive_scan(in.data(), in.data() + in.size(), out.data(), op, opt);
+        }
+
+        template <typename C1, typename C2>
+        detail::if_container<C1> inclusive_scan(const C1 &in, C2 &out, const options &opt = options())
+        {
+            detail::check_sizes(in.size(), out.size(), "[parallel::inclusive_scan()]: The output is shorter than the input.");
+            inclusive_scan(in.data(), in.data() + in.size(), out.data(), opt);
+        }
+    } // namespace parallel.
+
+} // namespace sc.
+#endif
@@ -0,0 +1,276 @@
+#ifndef _RECYCLING_ALLOCATOR_H_
+#define _RECYCLING_ALLOCATOR_H_
+
+#include <cstdint>      // std::uint64_t
+#include <cstdlib>      // std::malloc, std::free
+#include <cstddef>      // std::size_t, std::max_align_t
+#include <limits>       // std::numeric_limits<T>
+#include <new>          // std::bad_alloc
+
+/// Sequence container namespace.
+namespace sc {
+    /// A per-thread cache of freed memory blocks, bucketed by size class.
+    /*!
+     * Blocks are rounded up to a power of two between min_block and max_block
+     * bytes. A freed block goes to the free list of its size class in the
+     * calling thread, and the next request of that class in that thread takes
+     * it back without calling malloc. Blocks larger than max_block bypass the
+     * pool, and each class retains at most max_blocks_per_class blocks.
+     *
+     * The pool of a thread is released when the thread exits; trim() gives the
+     * retained memory back earlier, e.g. from a periodic task in a long-running
+     * service. Blocks freed in a thread whose pool is already gone (objects of
+     * static storage, or thread_local ones built before the pool) go straight
+     * back to free().
+     */
+    class recycling_pool
+    {
+        public:
+            /// Counters of a pool, to tune or monitor it.
+            struct statistics
+            {
+                std::uint64_t hits;             //!< Requests served from a free list.
+                std::uint64_t misses;           //!< Requests that went to malloc.
+                std::size_t retained_bytes;     //!< Bytes currently held in the free lists.
+                std::size_t retained_blocks;    //!< Blocks currently held in the free lists.
+
+                //* Fraction of the requests served from a free list.
+                double hit_rate(void) const
+                {
+                    return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+                }
+            };
+
+            static constexpr std::size_t min_block = 64;                    //!< Smallest size class, in bytes.
+            static constexpr std::size_t max_block = std::size_t{1} << 22;  //!< Largest size class (4 MiB).
+            static constexpr std::size_t max_blocks_per_class = 32;         //!< Retention limit of each free list.
+
+            //* The pool of the calling thread. Must not be called once local_alive() is false.
+            static recycling_pool &local(void)
+            {
+                static thread_local recycling_pool pool{local_tag{}};
+                return pool;
+            }
+
+            //* Whether the pool of the calling thread is usable: false once it has been destroyed at
+            //* thread exit (in the main thread, before the objects of static storage are).
+            static bool local_alive(void) noexcept { return not local_destroyed(); }
+
+            //* Constructs the pool of the calling thread now, if it is still alive. Anything built after
+            //* it is then destroyed before it.
+            static void prepare_local(void) noexcept
+            {
+                if (local_alive())
+                    local();
+            }
+
+            //* allocate() on the pool of the calling thread, or a plain malloc() once it is destroyed.
+            static void *allocate_local(std::size_t bytes)
+            {
+                if (local_alive())
+                    return local().allocate(bytes);
+                // Keep the size of the class: the block may end up in the free list of another thread.
+                void *p = std::malloc(block_size(bytes));
+                if (p == nullptr)
+                    throw std::bad_alloc();
+                return p;
+            }
+
+            //* deallocate() on the pool of the calling thread, or a plain free() once it is destroyed.
+            static void deallocate_local(void *p, std::size_t bytes) noexcept
+            {
+                if (local_alive())
+                    local().deallocate(p, bytes);
+                else
+                    std::free(p);
+            }
+
+            recycling_pool(void) : m_hits{0}, m_misses{0}, m_retained_bytes{0}, m_local{false}
+            {
+                for (std::size_t c{0} ; c < n_classes ; ++c) {
+                    m_free[c] = nullptr;
+                    m_count[c] = 0;
+                }
+            }
+
+            recycling_pool(const recycling_pool &) = delete;
+            recycling_pool &operator=(const recycling_pool &) = delete;
+
+            //* Releases every retained block.
+            ~recycling_pool(void)
+            {
+                trim();
+                if (m_local)
+                    local_destroyed() = true;
+            }
+
+            //* Returns a block of at least bytes bytes.
+            void *allocate(std::size_t bytes)
+            {
+                std::size_t c{class_of(bytes)};
+                if (c < n_classes and m_free[c] != nullptr) {
+                    node *block{m_free[c]};
+                    m_free[c] = block->next;
+                    m_count[c]--;
+                    m_retained_bytes -= class_size(c);
+                    m_hits++;
+                    return block;
+                }
+                m_misses++;
+                void *p = std::malloc(block_size(bytes));
+                if (p == nullptr)
+                    throw std::bad_alloc();
+                return p;
+            }
+
+            //* Takes back a block of bytes bytes obtained from allocate() (in this thread or another).
+            void deallocate(void *p, std::size_t bytes) noexcept
+            {
+                if (p == nullptr)
+                    return;
+                std::size_t c{class_of(bytes)};
+                if (c >= n_classes or m_count[c] == max_blocks_per_class) {
+                    std::free(p);
+                    return;
+                }
+                node *block{static_cast<node*>(p)};
+                block->next = m_free[c];
+                m_free[c] = block;
+                m_count[c]++;
+                m_retained_bytes += class_size(c);
+            }
+
+            //* Gives every retained block back to malloc. Returns how many bytes were released.
+            std::size_t trim(void) noexcept
+            {
+                std::size_t released{m_retained_bytes};
+                for (std::size_t c{0} ; c < n_classes ; ++c) {
+                    while (m_free[c] != nullptr) {
+                        node *next{m_free[c]->next};
+                        std::free(m_free[c]);
+                        m_free[c] = next;
+                    }
+                    m_count[c] = 0;
+                }
+                m_retained_bytes = 0;
+                return released;
+            }
+
+            //* Current counters of this pool.
+            statistics stats(void) const
+            {
+                std::size_t blocks{0};
+                for (std::size_t c{0} ; c < n_classes ; ++c)
+                    blocks += m_count[c];
+                return statistics{m_hits, m_misses, m_retained_bytes, blocks};
+            }
+
+            //* Zeroes the hit/miss counters.
+            void reset_stats(void) { m_hits = m_misses = 0; }
+
+        private:
+            /// A free block, linked through its own first bytes.
+            struct node { node *next; };
+
+            /// Selects the constructor of the pool returned by local().
+            struct local_tag {};
+
+            explicit recycling_pool(local_tag) : recycling_pool() { m_local = true; }
+
+            //* Set when the pool of the calling thread is destroyed. A trivial thread_local, so it
+            //* stays readable until the thread is gone.
+            static bool &local_destroyed(void) noexcept
+            {
+                static thread_local bool destroyed{false};
+                return destroyed;
+            }
+
+            //* Number of size classes: min_block, 2*min_block, ..., max_block.
+            static constexpr std::size_t n_classes = 17;
+            static_assert((min_block << (n_classes - 1)) == max_block, "The size classes must go from min_block to max_block.");
+
+            //* Size class of a request of bytes bytes; n_classes if it is too big to be pooled.
+            static std::size_t class_of(std::size_t bytes)
+            {
+                std::size_t c{0};
+                std::size_t size{min_block};
+                while (size < bytes and c < n_classes) {
+                    size *= 2;
+                    c++;
+                }
+                return c;
+            }
+
+            //* Size in bytes of the blocks of class c.
+            static std::size_t class_size(std::size_t c) { return min_block << c; }
+
+            //* Bytes actually allocated for a request of bytes bytes.
+            static std::size_t block_size(std::size_t bytes)
+            {
+                std::size_t c{class_of(bytes)};
+                return c < n_classes ? class_size(c) : bytes;
+            }
+
+            node *m_free[n_classes];            //!< One free list per size class.
+            std::size_t m_count[n_classes];     //!< Length of each free list.
+            std::uint64_t m_hits;               //!< Requests served from a free list.
+            std::uint64_t m_misses;             //!< Requests that went to malloc.
+            std::size_t m_retained_bytes;       //!< Bytes held in the free lists.
+            bool m_local;                       //!< Whether this is the pool of a thread, see local().
+    };
+
+    /// An allocator that recycles freed blocks through the recycling_pool of the calling thread.
+    /*!
+     * Opt in per container, for short-lived vectors created and destroyed at a
+     * high rate:
+     *
+     *     sc::vector<int, sc::recycling_allocator<int>> tmp;
+     *
+     * A new vector, or a growth step, then usually gets a warm block from the
+     * free list instead of calling malloc. Constructing the allocator constructs
+     * the pool of the thread, so the pool outlives the containers of that thread.
+     *
+     * \tparam T The type of the elements.
+     */
+    template <typename T>
+    class recycling_allocator
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "malloc() can not honor the alignment of T.");
+
+        public:
+            using value_type = T;            //!< The value type.
+            using size_type = std::size_t;   //!< The size type.
+
+            //* Rebinds the allocator to another element type.
+            template <typename U>
+            struct rebind { using other = recycling_allocator<U>; };
+
+            recycling_allocator(void) noexcept { recycling_pool::prepare_local(); }
+            recycling_allocator(const recycling_allocator &) noexcept { recycling_pool::prepare_local(); }
+            template <typename U>
+            recycling_allocator(const recycling_allocator<U> &) noexcept { recycling_pool::prepare_local(); }
+
+            //* Returns raw memory for n elements, recycled if possible.
+            T *allocate(size_type n)
+            {
+                if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+                    throw std::bad_alloc();
+                return static_cast<T*>(recycling_pool::allocate_local(n * sizeof(T)));
+            }
+
+            //* Hands the block of n elements over to the free lists of the calling thread.
+            void deallocate(T *p, size_type n) noexcept
+            {
+                recycling_pool::deallocate_local(p, n * sizeof(T));
+            }
+    };
+
+    //* Every recycling_allocator can free the blocks of another.
+    template <typename T, typename U>
+    bool operator==(const recycling_allocator<T> &, const recycling_allocator<U> &) { return true; }
+
+    template <typename T, typename U>
+    bool operator!=(const recycling_allocator<T> &, const recycling_allocator<U> &) { return false; }
+
+} // namespace sc.
+#endif
@@ -0,0 +1,431 @@
+#ifndef _SEGMENTED_VECTOR_H_
+#define _SEGMENTED_VECTOR_H_
+
+#include <algorithm>    // std::equal
+#include <cstddef>      // std::size_t, std::ptrdiff_t
+#include <initializer_list> // std::initializer_list
+#include <iterator>     // std::random_access_iterator_tag
+#include <memory>       // std::allocator, std::allocator_traits
+#include <stdexcept>    // std::out_of_range, std::length_error
+#include <type_traits>  // std::conditional
+#include <utility>      // std::move, std::forward, std::swap
+
+#include "vector.h"     // sc::vector, sc::select_allocator
+#include "span.h"       // sc::span
+#include "checks.h"     // SC_EXPECTS, SC_EXPECTS_NONEMPTY
+
+/// Sequence container namespace.
+namespace sc {
+    /// Geometry of the growing chunks shared by segmented_vector and concurrent_vector.
+    namespace segmented_detail {
+        //* The largest power of two not greater than n (n > 0).
+        constexpr unsigned long floor_pow2(unsigned long n, unsigned long p = 1)
+        {
+            return p * 2 > n ? p : floor_pow2(n, p * 2);
+        }
+
+        //* Chunks of B, B, 2B, 4B, ... elements (B a power of two): index of the chunk holding
+        //* element pos, which is 0 below B, then 1 + the highest set bit of pos / B.
+        inline unsigned long chunk_of(unsigned long pos, unsigned long first_chunk)
+        {
+            unsigned long high{pos / first_chunk};
+            if (high == 0)
+                return 0;
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned long>(64 - __builtin_clzll(static_cast<unsigned long long>(high)));
+#else
+            unsigned long k{0};
+            for ( /*empty*/ ; high != 0 ; high >>= 1)
+                ++k;
+            return k;
+#endif
+        }
+
+        //* Index of the first element of chunk k; also the capacity of chunks [0, k).
+        inline unsigned long chunk_start(unsigned long k, unsigned long first_chunk)
+        {
+            return k == 0 ? 0 : first_chunk << (k - 1);
+        }
+
+        //* Number of elements in chunk k.
+        inline unsigned long chunk_size(unsigned long k, unsigned long first_chunk)
+        {
+            return k == 0 ? first_chunk : first_chunk << (k - 1);
+        }
+    } // namespace segmented_detail.
+
+    /// A sequence stored in chunks that never move: growing allocates a new chunk instead of relocating.
+    /*!
+     * sc::vector moves every element when it outgrows its block, which
+     * invalidates all pointers, references and iterators into it and costs a
+     * copy spike proportional to the size. segmented_vector keeps its elements
+     * in chunks of geometrically growing size (B, B, 2B, 4B, ... elements, B a
+     * power of two): push_back only ever constructs one element, sometimes in
+     * a freshly allocated chunk, so references to elements stay valid until
+     * those elements are removed.
+     *
+     * The chunk holding element i follows from the position of the highest
+     * set bit of i / B, so indexing is O(1): a shift, a count-leading-zeros and
+     * a lookup in the chunk directory. Iterators walk a chunk with a plain
+     * pointer increment, and for_each_chunk() hands each chunk to a loop as a
+     * contiguous span.
+     *
+     * \tparam T The type of the elements.
+     * \tparam Allocator The allocator of the chunks (or a recipe such as sc::aligned<64>).
+     */
+    template <typename T, typename Allocator = std::allocator<T>>
+    class segmented_vector
+    {
+        //=== Aliases
+        public:
+            using size_type = unsigned long;        //!< The size type.
+            using value_type = T;                   //!< The value type.
+            using allocator_type = typename select_allocator<T, Allocator>::type; //!< The allocator type.
+            using pointer = value_type*;            //!< Pointer to a value stored in the container.
+            using const_pointer = const value_type*; //!< Const pointer to a value stored in the container.
+            using reference = value_type&;          //!< Reference to a value stored in the container.
+            using const_reference = const value_type&; //!< Const reference to a value stored in the container.
+
+            //* Elements in each of the first two chunks: about 512 bytes' worth, rounded down to a power of two.
+            static constexpr size_type first_chunk = segmented_detail::floor_pow2(sizeof(T) >= 512 ? 1 : 512 / sizeof(T));
+
+            /// Random-access iterator that walks each chunk with a pointer; Vec is segmented_vector or const segmented_vector.
+            template <typename Vec, typename Ptr>
+            class chunk_iterator
+            {
+                public:
+                    using difference_type = std::ptrdiff_t;
+                    using value_type = T;
+                    using pointer = Ptr;
+                    using reference = decltype(*Ptr());
+                    using iterator_category = std::random_access_iterator_tag;
+
+                    chunk_iterator(Vec *vec = nullptr, size_type pos = 0) : m_vec{vec}, m_pos{pos} { seek(); }
+
+                    //* An iterator converts to a const_iterator.
+                    operator chunk_iterator<const segmented_vector, const_pointer>(void) const
+                    {
+                        return chunk_iterator<const segmented_vector, const_pointer>(m_vec, m_pos);
+                    }
+
+                    reference operator*(void) const { return *m_ptr; }
+                    pointer operator->(void) const { return m_ptr; }
+                    reference operator[](difference_type n) const { return (*m_vec)[m_pos + n]; }
+
+                    chunk_iterator &operator++(void)
+                    {
+                        ++m_pos;
+                        if (++m_ptr == m_last)
+                            seek();
+                        return *this;
+                    }
+                    chunk_iterator operator++(int) { chunk_iterator old{*this}; ++*this; return old; }
+                    chunk_iterator &operator--(void) { --m_pos; seek(); return *this; }
+                    chunk_iterator operator--(int) { chunk_iterator old{*this}; --*this; return old; }
+                    chunk_iterator &operator+=(difference_type n) { m_pos += n; seek(); return *this; }
+                    chunk_iterator &operator-=(difference_type n) { m_pos -= n; seek(); return *this; }
+
+                    friend chunk_iterator operator+(chunk_iterator it, difference_type n) { return it += n; }
+                    friend chunk_iterator operator+(difference_type n, chunk_iterator it) { return it += n; }
+                    friend chunk_iterator operator-(chunk_iterator it, difference_type n) { return it -= n; }
+                    friend difference_type operator-(const chunk_iterator &a, const chunk_iterator &b)
+                    {
+                        return static_cast<difference_type>(a.m_pos) - static_cast<difference_type>(b.m_pos);
+                    }
+
+                    friend bool operator==(const chunk_iterator &a, const chunk_iterator &b) { return a.m_pos == b.m_pos; }
+                    friend bool operator!=(const chunk_iterator &a, const chunk_iterator &b) { return a.m_pos != b.m_pos; }
+                    friend bool operator<(const chunk_iterator &a, const chunk_iterator &b) { return a.m_pos < b.m_pos; }
+                    friend bool operator>(const chunk_iterator &a, const chunk_iterator &b) { return a.m_pos > b.m_pos; }
+                    friend bool operator<=(const chunk_iterator &a, const chunk_iterator &b) { return a.m_pos <= b.m_pos; }
+                    friend bool operator>=(const chunk_iterator &a, const chunk_iterator &b) { return a.m_pos >= b.m_pos; }
+
+                private:
+                    //* Points m_ptr at element m_pos, and m_last at the end of its chunk (null past the last chunk).
+                    void seek(void)
+                    {
+                        m_ptr = m_last = nullptr;
+                        if (m_vec == nullptr or m_pos >= m_vec->capacity())
+                            return;
+                        size_type k{chunk_of(m_pos)};
+                        m_ptr = m_vec->m_chunks[k] + (m_pos - chunk_start(k));
+                        m_last = m_vec->m_chunks[k] + chunk_size(k);
+                    }
+
+                    Vec *m_vec;         //!< The elements iterated over.
+                    size_type m_pos;    //!< Index of the current element.
+                    Ptr m_ptr;          //!< The current element.
+                    Ptr m_last;         //!< End of the chunk holding it.
+            };
+
+            using iterator = chunk_iterator<segmented_vector, pointer>;                    //!< Iterator with write access.
+            using const_iterator = chunk_iterator<const segmented_vector, const_pointer>;  //!< Read-only iterator.
+
+        private:
+            using alloc_traits = std::allocator_traits<allocator_type>; //!< Uniform interface to the allocator.
+
+        public:
+            //!=== [I] Special members
+            //* An empty container, without memory.
+            segmented_vector(void) : m_size{0}, m_alloc{} { /* empty */ }
+
+            //* An empty container that allocates its chunks from alloc.
+            explicit segmented_vector(const allocator_type &alloc) : m_size{0}, m_alloc{alloc} { /* empty */ }
+
+            //* count copies of value.
+            segmented_vector(size_type count, const T &value, const allocator_type &alloc = allocator_type())
+                : m_size{0}, m_alloc{alloc}
+            {
+                reserve(count);
+                for (size_type i{0} ; i < count ; ++i)
+                    push_back(value);
+            }
+
+            segmented_vector(std::initializer_list<T> il, const allocator_type &alloc = allocator_type())
+                : m_size{0}, m_alloc{alloc}
+            {
+                reserve(il.size());
+                for (const T &value : il)
+                    push_back(value);
+            }
+
+            segmented_vector(const segmented_vector &other)
+                : m_size{0}, m_alloc{alloc_traits::select_on_container_copy_construction(other.m_alloc)}
+            {
+                reserve(other.size());
+                for (const T &value : other)
+                    push_back(value);
+            }
+
+            //* Takes the chunks of other, so pointers into them stay valid.
+            segmented_vector(segmented_vector &&other)
+                : m_chunks{std::move(other.m_chunks)}, m_size{other.m_size}, m_alloc{std::move(other.m_alloc)}
+            {
+                other.m_chunks.clear();
+                other.m_size = 0;
+            }
+
+            ~segmented_vector(void) { release(); }
+
+            segmented_vector &operator=(segmented_vector other)
+            {
+                swap(*this, other);
+                return *this;
+            }
+
+            allocator_type get_allocator(void) const { return m_alloc; }
+
+            //!=== [II] Iterators
+            iterator begin(void) { return iterator(this, 0); }
+            iterator end(void) { return iterator(this, m_size); }
+            const_iterator begin(void) const { return const_iterator(this, 0); }
+            const_iterator end(void) const { return const_iterator(this, m_size); }
+            const_iterator cbegin(void) const { return begin(); }
+            const_iterator cend(void) const { return end(); }
+
+            //* Calls f(span<T>) once per chunk with elements, in order. Each span is contiguous.
+            template <typename F>
+            void for_each_chunk(F f) { for_each_chunk(*this, f); }
+
+            template <typename F>
+            void for_each_chunk(F f) const { for_each_chunk(*this, f); }
+
+            //!=== [III] Capacity
+            size_type size(void) const { return m_size; }
+            bool empty(void) const { return m_size == 0; }
+
+            //* Number of elements the allocated chunks hold.
+            size_type capacity(void) const { return chunk_start(m_chunks.size()); }
+
+            //* Number of allocated chunks.
+            size_type chunk_count(void) const { return m_chunks.size(); }
+
+            //* Allocates chunks until cap elements fit. Never moves an element.
+            void reserve(size_type cap)
+            {
+                while (capacity() < cap)
+                    add_chunk();
+            }
+
+            //* Frees the chunks past the last element.
+            void shrink_to_fit(void)
+            {
+                while (not m_chunks.empty() and chunk_start(m_chunks.size() - 1) >= m_size) {
+                    size_type k{m_chunks.size() - 1};
+                    alloc_traits::deallocate(m_alloc, m_chunks[k], chunk_size(k));
+                    m_chunks.pop_back();
+                }
+                m_chunks.shrink_to_fit();
+            }
+
+            //!=== [IV] Modifiers
+            //* Destroys the elements; the chunks are kept for reuse.
+            void clear(void)
+            {
+                while (m_size > 0)
+                    pop_back();
+            }
+
+            //* Constructs an element at the end, in a new chunk if the last one is full.
+            template <typename... Args>
+            reference emplace_back(Args&&... args)
+            {
+                if (m_size == capacity())
+                    add_chunk();
+                pointer at{address(m_size)};
+                alloc_traits::construct(m_alloc, at, std::forward<Args>(args)...);
+                ++m_size;
+                return *at;
+            }
+
+            void push_back(const T &value) { emplace_back(value); }
+            void push_back(T &&value) { emplace_back(std::move(value)); }
+
+            void pop_back(void)
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[segmented_vector::pop_back()]: Can not remove an element from an empty container.");
+                --m_size;
+                alloc_traits::destroy(m_alloc, address(m_size));
+            }
+
+            //* Grows with value-initialized elements, or shrinks from the end.
+            void resize(size_type count)
+            {
+                reserve(count);
+                while (m_size > count)
+                    pop_back();
+                while (m_size < count)
+                    emplace_back();
+            }
+
+            void resize(size_type count, const T &value)
+            {
+                reserve(count);
+                while (m_size > count)
+                    pop_back();
+                while (m_size < count)
+                    push_back(value);
+            }
+
+            friend void swap(segmented_vector &a, segmented_vector &b)
+            {
+                using std::swap;
+                swap(a.m_chunks, b.m_chunks);
+                swap(a.m_size, b.m_size);
+                swap(a.m_alloc, b.m_alloc);
+            }
+
+            //!=== [V] Element access
+            //* Element pos, in O(1). Checked according to SC_BOUNDS_CHECK.
+            reference operator[](size_type pos)
+            {
+                SC_EXPECTS(pos < m_size, std::out_of_range, "[segmented_vector::operator[]]: position provided is out of container range");
+                return *address(pos);
+            }
+
+            const_reference operator[](size_type pos) const
+            {
+                SC_EXPECTS(pos < m_size, std::out_of_range, "[segmented_vector::operator[]]: position provided is out of container range");
+                return *address(pos);
+            }
+
+            reference at(size_type pos)
+            {
+                if (pos >= m_size)
+                    throw std::out_of_range("[segmented_vector::at(pos)]: position provided is out of container range");
+                return *address(pos);
+            }
+
+            const_reference at(size_type pos) const
+            {
+                if (pos >= m_size)
+                    throw std::out_of_range("[segmented_vector::at(pos)]: position provided is out of container range");
+                return *address(pos);
+            }
+
+            //* The first and the last element. Checked according to SC_EMPTY_CHECK.
+            reference front(void)
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[segmented_vector::front()]: empty container.");
+                return *address(0);
+            }
+
+            const_reference front(void) const
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[segmented_vector::front()]: empty container.");
+                return *address(0);
+            }
+
+            reference back(void)
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[segmented_vector::back()]: empty container.");
+                return *address(m_size - 1);
+            }
+
+            const_reference back(void) const
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[segmented_vector::back()]: empty container.");
+                return *address(m_size - 1);
+            }
+
+            friend bool operator==(const segmented_vector &a, const segmented_vector &b)
+            {
+                return a.size() == b.size() and std::equal(a.begin(), a.end(), b.begin());
+            }
+
+            friend bool operator!=(const segmented_vector &a, const segmented_vector &b) { return not (a == b); }
+
+        private:
+            //!=== Chunk arithmetic
+            static size_type chunk_of(size_type pos) { return segmented_detail::chunk_of(pos, first_chunk); }
+            static size_type chunk_start(size_type k) { return segmented_detail::chunk_start(k, first_chunk); }
+            static size_type chunk_size(size_type k) { return segmented_detail::chunk_size(k, first_chunk); }
+
+            pointer address(size_type pos) const
+            {
+                size_type k{chunk_of(pos)};
+                return m_chunks[k] + (pos - chunk_start(k));
+            }
+
+            void add_chunk(void)
+            {
+                size_type k{m_chunks.size()};
+                pointer chunk{alloc_traits::allocate(m_alloc, chunk_size(k))};
+                try {
+                    m_chunks.push_back(chunk);
+                }
+                catch (...) {
+                    alloc_traits::deallocate(m_alloc, chunk, chunk_size(k));
+                    throw;
+                }
+            }
+
+            template <typename Self, typename F>
+            static void for_each_chunk(Self &self, F f)
+            {
+                using element = typename std::conditional<std::is_const<Self>::value, const T, T>::type;
+                for (size_type k{0} ; k < self.m_chunks.size() and chunk_start(k) < self.m_size ; ++k) {
+                    size_type end{chunk_start(k) + chunk_size(k)};
+                    size_type n{(end < self.m_size ? end : self.m_size) - chunk_start(k)};
+                    f(span<element>(self.m_chunks[k], n));
+                }
+            }
+
+            void release(void)
+            {
+                clear();
+                for (size_type k{0} ; k < m_chunks.size() ; ++k)
+                    alloc_traits::deallocate(m_alloc, m_chunks[k], chunk_size(k));
+                m_chunks.clear();
+            }
+
+            vector<pointer> m_chunks;   //!< The chunk directory: chunk k holds chunk_size(k) elements.
+            size_type m_size;           //!< Number of elements, stored in order across the chunks.
+            allocator_type m_alloc;     //!< Allocates the chunks.
+    };
+
+    template <typename T, typename Allocator>
+    constexpr typename segmented_vector<T, Allocator>::size_type segmented_vector<T, Allocator>::first_chunk;
+
+} // namespace sc.
+#endif
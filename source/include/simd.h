@@ -0,0 +1,115 @@
+#ifndef _SIMD_H_
+#define _SIMD_H_
+
+#include <atomic>       // std::atomic<T>
+#include <cstdlib>      // std::getenv
+#include <cstring>      // std::strcmp
+
+// x86 kernels are compiled per function with the target attribute, so the rest of
+// the program keeps the baseline ISA and the best path is picked at run time.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SC_SIMD_X86 1
+#include <immintrin.h>
+#define SC_TARGET(features) __attribute__((target(features)))
+#else
+#define SC_SIMD_X86 0
+#define SC_TARGET(features)
+#endif
+
+// Kernel bodies written once with GCC vector extensions are forced inline into each
+// SC_TARGET entry point, where they are compiled with that entry point's instruction set.
+#if defined(__GNUC__) || defined(__clang__)
+#define SC_ALWAYS_INLINE __attribute__((always_inline)) inline
+#else
+#define SC_ALWAYS_INLINE inline
+#endif
+
+// Hints the cache to fetch the line holding address, on compilers that can.
+#if defined(__GNUC__) || defined(__clang__)
+#define SC_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define SC_PREFETCH(address)
+#endif
+
+/// Sequence container namespace.
+namespace sc {
+    /// Run-time selection of the instruction set used by the vectorized kernels.
+    /*!
+     * The kernels (see compact.h, compare.h and kernels.h) come in a portable
+     * scalar version plus SSE2, AVX2 and AVX-512 versions on x86. The best
+     * level supported by the CPU and the OS is detected once, through CPUID.
+     * It can be capped with the environment variable SC_SIMD (scalar, sse2,
+     * avx2 or avx512) or with simd::set_max_level(), to compare the paths or
+     * to work around a bad frequency licence on a given machine.
+     */
+    namespace simd {
+        /// Instruction set levels, in increasing order.
+        enum class level { scalar = 0, sse2 = 1, avx2 = 2, avx512 = 3 };
+
+        //* Best level supported by this CPU and OS.
+        inline level detect(void)
+        {
+#if SC_SIMD_X86
+            __builtin_cpu_init();
+            // Each level requires every feature its kernels are compiled with (see the SC_TARGET lists):
+            // a kernel built with FMA or BMI would raise SIGILL on a core that has AVX2 without them.
+            bool avx2{__builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma") and
+                      __builtin_cpu_supports("bmi") and __builtin_cpu_supports("bmi2") and __builtin_cpu_supports("popcnt")};
+            // avx512: foundation plus the VL/BW/DQ subsets that every AVX-512 core since Skylake-X has.
+            if (avx2 and __builtin_cpu_supports("avx512f") and __builtin_cpu_supports("avx512vl") and
+                __builtin_cpu_supports("avx512bw") and __builtin_cpu_supports("avx512dq"))
+                return level::avx512;
+            if (avx2)
+                return level::avx2;
+            if (__builtin_cpu_supports("sse2"))
+                return level::sse2;
+#endif
+            return level::scalar;
+        }
+
+        namespace detail {
+            //* The level named by a value of SC_SIMD, or fallback if it names none.
+            inline level parse(const char *name, level fallback)
+            {
+                if (name == nullptr) return fallback;
+                if (std::strcmp(name, "scalar") == 0) return level::scalar;
+                if (std::strcmp(name, "sse2") == 0) return level::sse2;
+                if (std::strcmp(name, "avx2") == 0) return level::avx2;
+                if (std::strcmp(name, "avx512") == 0) return level::avx512;
+                return fallback;
+            }
+
+            //* The level from the SC_SIMD environment variable, or the detected one.
+            inline int initial_level(void)
+            {
+                level best{detect()};
+                level wanted{parse(std::getenv("SC_SIMD"), best)};
+                return static_cast<int>(wanted < best ? wanted : best);
+            }
+
+            //* The level in use, shared by every translation unit.
+            inline std::atomic<int> &current(void)
+            {
+                static std::atomic<int> value{initial_level()};
+                return value;
+            }
+        } // namespace detail.
+
+        //* The level the kernels dispatch to.
+        inline level active(void)
+        {
+            return static_cast<level>(detail::current().load(std::memory_order_relaxed));
+        }
+
+        //* Caps the level the kernels dispatch to (it never goes above detect()). Returns the level in use.
+        inline level set_max_level(level cap)
+        {
+            level best{detect()};
+            level use{cap < best ? cap : best};
+            detail::current().store(static_cast<int>(use), std::memory_order_relaxed);
+            return use;
+        }
+    } // namespace simd.
+
+} // namespace sc.
+#endif
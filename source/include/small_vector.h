@@ -0,0 +1,597 @@
+#ifndef _SMALL_VECTOR_H_
+#define _SMALL_VECTOR_H_
+
+#include <algorithm>    // std::move, std::max
+#include <cstring>      // std::memcpy, std::memmove
+#include <initializer_list> // std::initializer_list
+#include <iterator>     // std::distance, std::make_move_iterator
+#include <memory>       // std::allocator
+#include <stdexcept>    // std::out_of_range, std::length_error
+#include <type_traits>  // std::aligned_storage, std::integral_constant, std::enable_if
+#include <utility>      // std::move, std::forward, std::move_if_noexcept
+
+#include "vector.h"     // sc::MyForwardIterator, sc::is_trivially_relocatable
+#include "checks.h"     // SC_EXPECTS, SC_EXPECTS_NONEMPTY
+
+/// Sequence container namespace.
+namespace sc {
+    /// The part of sc::small_vector that does not depend on the inline capacity.
+    /*!
+     * Functions that need to modify a small vector (push_back, insert, erase...)
+     * can take a `small_vector_base<T>&` and accept a small_vector<T, N> for
+     * any N. Functions that only need the elements should rather take a
+     * sc::span<T>, which also accepts a sc::vector.
+     *
+     * The storage area is either the inline buffer owned by the derived
+     * small_vector or, once the size goes past the inline capacity, a buffer
+     * on the heap. Only the slots in [0, size()) hold live objects.
+     *
+     * \tparam T The type of the elements.
+     */
+    template <typename T>
+    class small_vector_base
+    {
+        //=== Aliases
+        public:
+            using size_type = unsigned long; //!< The size type.
+            using value_type = T;            //!< The value type.
+            using pointer = value_type*;     //!< Pointer to a value stored in the container.
+            using const_pointer = const value_type*; //!< Const pointer to a value stored in the container.
+            using reference = value_type&;   //!< Reference to a value stored in the container.
+            using const_reference = const value_type&; //!< Const reference to a value stored in the container.
+
+            using iterator = MyForwardIterator<value_type>; //!< The iterator, instantiated from a template class.
+            using const_iterator = MyForwardIterator<const value_type>; //!< The const_iterator, instantiated from a template class.
+
+        private:
+            using allocator_type = std::allocator<T>; //!< Where the spilled storage comes from.
+            using alloc_traits = std::allocator_traits<allocator_type>; //!< Uniform interface to the allocator.
+            //* Elements may be moved around with memcpy/memmove.
+            using relocatable = std::integral_constant<bool, is_trivially_relocatable<T>::value>;
+
+        public:
+            //!=== [I] Special members
+            // Copies and moves are done by small_vector, which knows where the inline buffer is.
+            small_vector_base(const small_vector_base &) = delete;
+
+            //* Replaces the contents with a copy of the contents of other.
+            small_vector_base &operator=(const small_vector_base &other)
+            {
+                if (this != &other)
+                    assign_range(other.m_storage, other.m_end);
+                return *this;
+            }
+
+            //* Replaces the contents with those of other. A spilled buffer changes hands, inline elements are moved one by one.
+            small_vector_base &operator=(small_vector_base &&other)
+            {
+                if (this == &other)
+                    return *this;
+                if (not other.is_inline()) {
+                    release();
+                    m_storage = other.m_storage;
+                    m_end = other.m_end;
+                    m_capacity = other.m_capacity;
+                    other.reset();
+                }
+                else {
+                    assign_range(std::make_move_iterator(other.m_storage), other.m_end);
+                    other.clear();
+                }
+                return *this;
+            }
+
+            //* Replaces the contents with those identified by initializer list ilist.
+            small_vector_base &operator=(std::initializer_list<T> il)
+            {
+                assign_range(il.begin(), il.size());
+                return *this;
+            }
+
+            //!=== [II] Iterators
+            //* An iterator pointing to the first item in the list.
+            iterator begin(void) { return iterator(m_storage); }
+
+            //* A constant iterator pointing to the first item in the list.
+            const_iterator cbegin(void) const { return const_iterator(m_storage); }
+            const_iterator begin(void) const { return cbegin(); }
+
+            //* An iterator pointing to the position just after the last element of the list.
+            iterator end(void) { return iterator(m_storage + m_end); }
+
+            //* A constant iterator pointing to the position just after the last element of the list.
+            const_iterator cend(void) const { return const_iterator(m_storage + m_end); }
+            const_iterator end(void) const { return cend(); }
+
+            //!=== [III] Capacity
+            //* Check the size of the vector.
+            size_type size(void) const { return m_end; }
+
+            //* Check the capacity of the vector.
+            size_type capacity(void) const { return m_capacity; }
+
+            //* Check if the vector is empty, that is, there are no elements.
+            bool empty(void) const { return m_end == 0; }
+
+            //* Check if the elements still live in the inline buffer, that is, no heap memory is in use.
+            bool is_inline(void) const { return m_storage == m_inline; }
+
+            //!=== [IV] Modifiers
+            //* Removes all elements from the container. The capacity is left unchanged.
+            void clear(void)
+            {
+                destroy_range(0, m_end);
+                m_end = 0;
+            }
+
+            //* Adds value to the end of the list.
+            void push_back(const_reference value) { emplace_back(value); }
+
+            //* Adds value to the end of the list, moving it into the vector.
+            void push_back(value_type &&value) { emplace_back(std::move(value)); }
+
+            //* Constructs a new element in place at the end of the list from args.
+            template <typename... Args>
+            void emplace_back(Args&&... args)
+            {
+                if (m_end == m_capacity) {
+                    // args may live in the storage that grow() releases.
+                    value_type value(std::forward<Args>(args)...);
+                    grow(m_end + 1);
+                    alloc_traits::construct(m_alloc, m_storage + m_end, std::move(value));
+                }
+                else {
+                    alloc_traits::construct(m_alloc, m_storage + m_end, std::forward<Args>(args)...);
+                }
+                m_end++;
+            }
+
+            //* Removes the object at the end of the list.
+            void pop_back(void)
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[small_vector::pop_back()]: Can not remove an element from an empty vector.");
+                m_end--;
+                alloc_traits::destroy(m_alloc, m_storage + m_end);
+            }
+
+            //* Inserts value before pos.
+            iterator insert(const_iterator pos_, const_reference value_)
+            {
+                // value_ may be one of our elements, which the shift would overwrite.
+                value_type value(value_);
+                return insert(pos_, std::move(value));
+            }
+
+            //* Inserts value before pos, moving it into the vector.
+            iterator insert(const_iterator pos_, value_type &&value_)
+            {
+                return insert_range(index_of(pos_), std::make_move_iterator(&value_), 1);
+            }
+
+            //* Inserts the elements of the range [first, last) before pos.
+            template <typename InputItr,
+                      typename = typename std::enable_if<not std::is_integral<InputItr>::value>::type>
+            iterator insert(const_iterator pos_, InputItr first_, InputItr last_)
+            {
+                return insert_range(index_of(pos_), first_, std::distance(first_, last_));
+            }
+
+            //* Inserts the elements of the initializer list before pos.
+            iterator insert(const_iterator pos_, const std::initializer_list<value_type> &ilist_)
+            {
+                return insert_range(index_of(pos_), ilist_.begin(), ilist_.size());
+            }
+
+            // The iterator overloads just forward to the const_iterator ones.
+            iterator insert(iterator pos_, const_reference value_) { return insert(const_iterator(&pos_), value_); }
+            iterator insert(iterator pos_, value_type &&value_) { return insert(const_iterator(&pos_), std::move(value_)); }
+            template <typename InputItr,
+                      typename = typename std::enable_if<not std::is_integral<InputItr>::value>::type>
+            iterator insert(iterator pos_, InputItr first_, InputItr last_) { return insert(const_iterator(&pos_), first_, last_); }
+            iterator insert(iterator pos_, const std::initializer_list<value_type> &ilist_) { return insert(const_iterator(&pos_), ilist_); }
+
+            //* The storage will have a capacity equal to cap_ if cap_ > capacity().
+            void reserve(size_type cap_)
+            {
+                if (cap_ > m_capacity)
+                    relocate_to(allocate(cap_), cap_);
+            }
+
+            //* Requests the removal of unused capacity. Moves the elements back inline if they fit.
+            void shrink_to_fit(void)
+            {
+                if (is_inline() or m_end == m_capacity)
+                    return;
+                if (m_end <= m_inline_capacity)
+                    relocate_to(m_inline, m_inline_capacity);
+                else
+                    relocate_to(allocate(m_end), m_end);
+            }
+
+            //* Replaces the content of the vector with count copies of value.
+            void assign(size_type count_, const_reference value_)
+            {
+                value_type value(value_);
+                clear();
+                reserve(count_);
+                for ( /*empty*/ ; m_end < count_ ; ++m_end)
+                    alloc_traits::construct(m_alloc, m_storage + m_end, value);
+            }
+
+            //* Replaces the content of the vector with copy of the initializer list.
+            void assign(const std::initializer_list<T> &il) { assign_range(il.begin(), il.size()); }
+
+            //* Replaces the content of the vector with copy of a range.
+            template <typename InputItr,
+                      typename = typename std::enable_if<not std::is_integral<InputItr>::value>::type>
+            void assign(InputItr first, InputItr last) { assign_range(first, std::distance(first, last)); }
+
+            //* Removes the elements in the range [first, last).
+            iterator erase(const_iterator first, const_iterator last)
+            {
+                size_type position{index_of(first)};
+                SC_EXPECTS(&first <= &last and &last <= m_storage + m_end, std::out_of_range,
+                           "[small_vector::erase()]: range provided is out of vector range");
+                return erase_range(position, &last - m_storage);
+            }
+
+            //* Removes the element at pos.
+            iterator erase(const_iterator pos)
+            {
+                size_type position{index_of(pos)};
+                SC_EXPECTS(position < m_end, std::out_of_range, "[small_vector::erase()]: position provided is out of vector range");
+                return erase_range(position, position + 1);
+            }
+
+            iterator erase(iterator first, iterator last) { return erase(const_iterator(&first), const_iterator(&last)); }
+            iterator erase(iterator pos) { return erase(const_iterator(&pos)); }
+
+            //!=== [V] Element access
+            //* Returns the element at the end of the list, just to read.
+            const_reference back(void) const
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[small_vector::back()]: empty vector.");
+                return m_storage[m_end - 1];
+            }
+
+            //* Returns the element at the beginning of the list, just to read.
+            const_reference front(void) const
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[small_vector::front()]: empty vector.");
+                return m_storage[0];
+            }
+
+            //* Returns a reference of the element at the end of the list.
+            reference back(void)
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[small_vector::back()]: empty vector.");
+                return m_storage[m_end - 1];
+            }
+
+            //* Returns a reference of the element at the beginning of the list.
+            reference front(void)
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[small_vector::front()]: empty vector.");
+                return m_storage[0];
+            }
+
+            //* Access the element in the position pos, just to read. Checked according to SC_BOUNDS_CHECK.
+            const_reference operator[](size_type pos) const
+            {
+                SC_EXPECTS(pos < m_end, std::out_of_range, "[small_vector::operator[]]: position provided is out of vector range");
+                return m_storage[pos];
+            }
+
+            //* Access the element in the position pos, can change the value.
+            reference operator[](size_type pos)
+            {
+                SC_EXPECTS(pos < m_end, std::out_of_range, "[small_vector::operator[]]: position provided is out of vector range");
+                return m_storage[pos];
+            }
+
+            //* Returns the value at the index pos in the vector, with bounds-checking.
+            const_reference at(size_type pos) const
+            {
+                if (pos >= m_end)
+                    throw std::out_of_range("[small_vector::at(pos)]: position provided is out of vector range");
+                return m_storage[pos];
+            }
+
+            //* Returns the element of the index pos in the vector, with bounds-checking.
+            reference at(size_type pos)
+            {
+                if (pos >= m_end)
+                    throw std::out_of_range("[small_vector::at(pos)]: position provided is out of vector range");
+                return m_storage[pos];
+            }
+
+            //* Pointer to the first element.
+            pointer data(void) { return m_storage; }
+            const_pointer data(void) const { return m_storage; }
+
+        protected:
+            //* Starts empty, on the inline buffer provided by the derived class.
+            small_vector_base(pointer inline_storage, size_type inline_capacity)
+                : m_end{0},
+                  m_capacity{inline_capacity},
+                  m_storage{inline_storage},
+                  m_inline{inline_storage},
+                  m_inline_capacity{inline_capacity}
+            { /* empty */ }
+
+            //* Destroys the elements and releases the heap buffer, if any.
+            ~small_vector_base(void) { release(); }
+
+            //* Copy-constructs count elements read from first. Used by the derived constructors.
+            template <typename FwdItr>
+            void assign_range(FwdItr first, size_type count)
+            {
+                clear();
+                reserve(count);
+                for ( /*empty*/ ; m_end < count ; ++m_end, ++first)
+                    alloc_traits::construct(m_alloc, m_storage + m_end, *first);
+            }
+
+        private:
+            //* Raw heap memory for n elements.
+            pointer allocate(size_type n) { return alloc_traits::allocate(m_alloc, n); }
+
+            //* Destroys the live elements in [first, last).
+            void destroy_range(size_type first, size_type last)
+            {
+                for ( /*empty*/ ; first < last ; ++first)
+                    alloc_traits::destroy(m_alloc, m_storage + first);
+            }
+
+            //* Destroys every element and frees the heap buffer. Members are left dangling.
+            void release(void)
+            {
+                destroy_range(0, m_end);
+                if (not is_inline())
+                    alloc_traits::deallocate(m_alloc, m_storage, m_capacity);
+            }
+
+            //* Goes back to the empty inline buffer, forgetting the current storage.
+            void reset(void)
+            {
+                m_storage = m_inline;
+                m_end = 0;
+                m_capacity = m_inline_capacity;
+            }
+
+            //* Makes room for at least min_cap elements, doubling the capacity.
+            void grow(size_type min_cap)
+            {
+                reserve(std::max(min_cap, 2 * m_capacity));
+            }
+
+            //* Moves the elements into new_storage, which may be the inline buffer, and frees the old heap buffer.
+            void relocate_to(pointer new_storage, size_type new_cap)
+            {
+                try {
+                    relocate_elements(new_storage, relocatable{});
+                }
+                catch (...) {
+                    if (new_storage != m_inline)
+                        alloc_traits::deallocate(m_alloc, new_storage, new_cap);
+                    throw;
+                }
+                if (not is_inline())
+                    alloc_traits::deallocate(m_alloc, m_storage, m_capacity);
+                m_storage = new_storage;
+                m_capacity = new_cap;
+            }
+
+            //* Fast path: a single memcpy.
+            void relocate_elements(pointer new_storage, std::true_type)
+            {
+                if (m_end != 0)
+                    std::memcpy(new_storage, m_storage, m_end * sizeof(T));
+            }
+
+            //* Elements are copied instead if their move constructor may throw, so a failure leaves *this intact.
+            void relocate_elements(pointer new_storage, std::false_type)
+            {
+                size_type i{0};
+                try {
+                    for ( /*empty*/ ; i < m_end ; ++i)
+                        alloc_traits::construct(m_alloc, new_storage + i, std::move_if_noexcept(m_storage[i]));
+                }
+                catch (...) {
+                    for (size_type j{0} ; j < i ; ++j)
+                        alloc_traits::destroy(m_alloc, new_storage + j);
+                    throw;
+                }
+                destroy_range(0, m_end);
+            }
+
+            //* Inserts count elements read from first at index position.
+            template <typename FwdItr>
+            iterator insert_range(size_type position, FwdItr first, size_type count)
+            {
+                if (m_end + count > m_capacity)
+                    grow(m_end + count);
+                insert_range(position, first, count, relocatable{});
+                m_end += count;
+                return iterator(m_storage + position);
+            }
+
+            //* Fast path: the tail is slid up with a single memmove and the elements are built on the raw gap.
+            template <typename FwdItr>
+            void insert_range(size_type position, FwdItr first, size_type count, std::true_type)
+            {
+                std::memmove(m_storage + position + count, m_storage + position, (m_end - position) * sizeof(T));
+                for (size_type i{position} ; i < position + count ; ++i, ++first)
+                    alloc_traits::construct(m_alloc, m_storage + i, *first);
+            }
+
+            template <typename FwdItr>
+            void insert_range(size_type position, FwdItr first, size_type count, std::false_type)
+            {
+                // Shift the tail back to front; slots past the old end are raw memory.
+                for (size_type i{m_end} ; i > position ; --i) {
+                    size_type src{i - 1};
+                    size_type dst{src + count};
+                    if (dst >= m_end) alloc_traits::construct(m_alloc, m_storage + dst, std::move(m_storage[src]));
+                    else m_storage[dst] = std::move(m_storage[src]);
+                }
+                for (size_type i{position} ; i < position + count ; ++i, ++first) {
+                    if (i < m_end) m_storage[i] = *first;
+                    else alloc_traits::construct(m_alloc, m_storage + i, *first);
+                }
+            }
+
+            //* Index of pos, which must be in [begin(), end()]. Checked according to SC_BOUNDS_CHECK.
+            size_type index_of(const_iterator pos) const
+            {
+                SC_EXPECTS(m_storage <= &pos and &pos <= m_storage + m_end, std::out_of_range,
+                           "[small_vector]: iterator provided is out of vector range");
+                return static_cast<size_type>(&pos - m_storage);
+            }
+
+            //* Removes the elements in [first, last), shifting the tail down.
+            iterator erase_range(size_type first, size_type last)
+            {
+                if (first != last) {
+                    erase_range(first, last, relocatable{});
+                    m_end -= last - first;
+                }
+                return iterator(m_storage + first);
+            }
+
+            //* Fast path: the tail is slid down over the erased slots with a single memmove.
+            void erase_range(size_type first, size_type last, std::true_type)
+            {
+                destroy_range(first, last);
+                std::memmove(m_storage + first, m_storage + last, (m_end - last) * sizeof(T));
+            }
+
+            void erase_range(size_type first, size_type last, std::false_type)
+            {
+                std::move(m_storage + last, m_storage + m_end, m_storage + first);
+                destroy_range(m_end - (last - first), m_end);
+            }
+
+            size_type m_end;                //!< The list's current size (or index past-last valid element).
+            size_type m_capacity;           //!< The list's storage capacity.
+            T *m_storage;                   //!< The list's data storage area: the inline buffer or the heap.
+            T *m_inline;                    //!< The inline buffer of the derived small_vector.
+            size_type m_inline_capacity;    //!< How many elements fit in the inline buffer.
+            allocator_type m_alloc;         //!< Where the spilled storage comes from.
+    };
+
+    /// A vector that keeps its first N elements inside the object itself.
+    /*!
+     * sc::small_vector has the interface of sc::vector but only touches the heap
+     * when its size goes past N. For containers that are usually short, this
+     * saves the allocation and the pointer chase of a regular vector.
+     *
+     * It converts to small_vector_base<T>& (to be modified regardless of N)
+     * and to sc::span<T> (to be read like a sc::vector).
+     *
+     * \tparam T The type of the elements.
+     * \tparam N How many elements are kept inline.
+     */
+    template <typename T, unsigned long N>
+    class small_vector : public small_vector_base<T>
+    {
+        static_assert(N > 0, "small_vector needs room for at least one inline element.");
+
+        private:
+            using base = small_vector_base<T>; //!< The part that does not depend on N.
+
+        public:
+            using size_type = typename base::size_type; //!< The size type.
+
+            //* Number of elements kept inline.
+            static constexpr size_type inline_capacity = N;
+
+            //!=== [I] Special members
+            //* Creates an empty vector, with room for N elements inline.
+            small_vector(void) : base(inline_buffer(), N) { /* empty */ }
+
+            //* Creates a vector with count value-initialized elements.
+            explicit small_vector(size_type count) : base(inline_buffer(), N)
+            {
+                this->reserve(count);
+                for (size_type i{0} ; i < count ; ++i)
+                    this->emplace_back();
+            }
+
+            //* Creates a vector with the contents of a range [first, last).
+            template <typename InputItr,
+                      typename = typename std::enable_if<not std::is_integral<InputItr>::value>::type>
+            small_vector(InputItr first, InputItr last) : base(inline_buffer(), N)
+            {
+                this->assign(first, last);
+            }
+
+            //* Creates a vector from an initializer list.
+            small_vector(std::initializer_list<T> il) : base(inline_buffer(), N)
+            {
+                this->assign_range(il.begin(), il.size());
+            }
+
+            //* Copy constructor.
+            small_vector(const small_vector &other) : base(inline_buffer(), N)
+            {
+                this->assign_range(other.data(), other.size());
+            }
+
+            //* Copies a small vector with a different inline capacity.
+            small_vector(const base &other) : base(inline_buffer(), N)
+            {
+                this->assign_range(other.data(), other.size());
+            }
+
+            //* Move constructor. Steals a spilled buffer, moves inline elements one by one.
+            small_vector(small_vector &&other) : base(inline_buffer(), N)
+            {
+                base::operator=(std::move(other));
+            }
+
+            //* Moves from a small vector with a different inline capacity.
+            small_vector(base &&other) : base(inline_buffer(), N)
+            {
+                base::operator=(std::move(other));
+            }
+
+            small_vector &operator=(const small_vector &other) { base::operator=(other); return *this; }
+            small_vector &operator=(const base &other) { base::operator=(other); return *this; }
+            small_vector &operator=(small_vector &&other) { base::operator=(std::move(other)); return *this; }
+            small_vector &operator=(base &&other) { base::operator=(std::move(other)); return *this; }
+            small_vector &operator=(std::initializer_list<T> il) { base::operator=(il); return *this; }
+
+        private:
+            //* The inline buffer, seen as an array of T.
+            T *inline_buffer(void) { return reinterpret_cast<T*>(&m_buffer); }
+
+            //* Raw, suitably aligned memory for N elements.
+            typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type m_buffer;
+    };
+
+    template <typename T, unsigned long N>
+    constexpr typename small_vector<T, N>::size_type small_vector<T, N>::inline_capacity;
+
+    //!=== [VI] Operators
+    //* Checks if the contents of lhs and rhs are equal, whatever their inline capacities.
+    template <typename T>
+    bool operator==(const small_vector_base<T> &lhs, const small_vector_base<T> &rhs)
+    {
+        if (lhs.size() != rhs.size())
+            return false;
+        for (auto i{0ul} ; i < lhs.size() ; i++)
+            if (lhs[i] != rhs[i])
+                return false;
+        return true;
+    }
+
+    //* The negation of the above operation, the opposite result.
+    template <typename T>
+    bool operator!=(const small_vector_base<T> &lhs, const small_vector_base<T> &rhs)
+    {
+        return not (lhs == rhs);
+    }
+
+} // namespace sc.
+#endif
@@ -0,0 +1,177 @@
+#ifndef _SNAPSHOT_H_
+#define _SNAPSHOT_H_
+
+#include <atomic>       // std::atomic_load, std::atomic_store, std::atomic_exchange (shared_ptr overloads)
+#include <memory>       // std::shared_ptr, std::allocator_traits
+#include <stdexcept>    // std::out_of_range, std::length_error
+#include <utility>      // std::move
+
+#include "compare.h"    // sc::kernels::equal
+
+/// Sequence container namespace.
+namespace sc {
+    template <typename T, typename Allocator, typename GrowthPolicy>
+    class vector;
+
+    /// The buffer of a sc::vector, once handed over to its snapshots.
+    namespace snapshot_detail {
+        template <typename T, typename Allocator>
+        struct block
+        {
+            using alloc_traits = std::allocator_traits<Allocator>;
+
+            block(T *storage_, unsigned long size_, unsigned long capacity_, const Allocator &alloc_)
+                : storage{storage_}, size{size_}, capacity{capacity_}, alloc{alloc_} { /* empty */ }
+
+            block(const block &) = delete;
+            block &operator=(const block &) = delete;
+
+            //* The last snapshot frees the buffer, unless the vector took it back (storage is then null).
+            ~block(void)
+            {
+                if (storage == nullptr)
+                    return;
+                for (unsigned long i{0} ; i < size ; ++i)
+                    alloc_traits::destroy(alloc, storage + i);
+                alloc_traits::deallocate(alloc, storage, capacity);
+            }
+
+            T *storage;             //!< The elements, shared with the vector until it changes.
+            unsigned long size;     //!< Number of elements.
+            unsigned long capacity; //!< Size of the buffer, to give it back.
+            Allocator alloc;        //!< Allocated the buffer.
+        };
+    } // namespace snapshot_detail.
+
+    /// An immutable view of the contents a sc::vector had when vector::snapshot() was called.
+    /*!
+     * Taking a snapshot copies nothing: the vector hands its buffer over to a
+     * reference-counted block and keeps reading it. The next operation that
+     * may change the vector (or hand out a mutable reference into it) checks
+     * whether a snapshot still holds the buffer; if one does, the vector goes
+     * on with a private copy, and if none does it takes the buffer back.
+     * Copying a snapshot is one atomic increment.
+     *
+     * Snapshots are safe to read from any thread, and to copy and destroy
+     * concurrently; see sc::atomic_snapshot to publish one to readers.
+     */
+    template <typename T, typename Allocator>
+    class vector_snapshot
+    {
+        //=== Aliases
+        public:
+            using size_type = unsigned long;                //!< The size type.
+            using value_type = T;                           //!< The value type.
+            using const_reference = const value_type&;      //!< The elements are read-only.
+            using const_pointer = const value_type*;        //!< Pointer to an element.
+            using const_iterator = const value_type*;       //!< The elements are contiguous.
+            using iterator = const_iterator;                //!< Snapshots can not be changed.
+
+        public:
+            //* An empty snapshot.
+            vector_snapshot(void) = default;
+
+            //!=== Iterators
+            const_iterator begin(void) const { return data(); }
+            const_iterator end(void) const { return data() + size(); }
+            const_iterator cbegin(void) const { return begin(); }
+            const_iterator cend(void) const { return end(); }
+
+            //!=== Capacity
+            size_type size(void) const { return m_block ? m_block->size : 0; }
+            bool empty(void) const { return size() == 0; }
+
+            //* Number of snapshots (and vectors) sharing these elements. Approximate under concurrency.
+            long use_count(void) const { return m_block.use_count(); }
+
+            //!=== Element access
+            const_pointer data(void) const { return m_block ? m_block->storage : nullptr; }
+            const_reference operator[](size_type pos) const { return data()[pos]; }
+
+            const_reference at(size_type pos) const
+            {
+                if (pos >= size())
+                    throw std::out_of_range("[vector_snapshot::at(pos)]: position provided is out of snapshot range");
+                return data()[pos];
+            }
+
+            const_reference front(void) const
+            {
+                if (empty())
+                    throw std::length_error("[vector_snapshot::front()]: empty snapshot.");
+                return data()[0];
+            }
+
+            const_reference back(void) const
+            {
+                if (empty())
+                    throw std::length_error("[vector_snapshot::back()]: empty snapshot.");
+                return data()[size() - 1];
+            }
+
+            friend bool operator==(const vector_snapshot &a, const vector_snapshot &b)
+            {
+                return a.size() == b.size() and (a.m_block == b.m_block or kernels::equal(a.data(), b.data(), a.size()));
+            }
+
+            friend bool operator!=(const vector_snapshot &a, const vector_snapshot &b) { return not (a == b); }
+
+        private:
+            template <typename U, typename A, typename G> friend class vector;
+            template <typename U, typename A> friend class atomic_snapshot;
+
+            using block_type = snapshot_detail::block<T, Allocator>;
+
+            explicit vector_snapshot(std::shared_ptr<const block_type> block) : m_block{std::move(block)} { /* empty */ }
+
+            std::shared_ptr<const block_type> m_block;  //!< The shared elements; null when empty.
+    };
+
+    /// A slot that one thread publishes snapshots into and any number of threads read from.
+    /*!
+     *     sc::atomic_snapshot<route> current;
+     *     // Writer, after changing the table:
+     *     current.store(routes.snapshot());
+     *     // Readers, at any time:
+     *     auto table = current.load();      // O(1), never blocks on the writer's copy
+     *
+     * load() and store() are the standard atomic operations on std::shared_ptr:
+     * a reader never waits for a copy of the elements, only for the pointer
+     * exchange itself, which the standard library makes lock-free where the
+     * platform allows and guards with a short internal lock elsewhere.
+     */
+    template <typename T, typename Allocator = std::allocator<T>>
+    class atomic_snapshot
+    {
+        public:
+            using snapshot_type = vector_snapshot<T, Allocator>; //!< What is published.
+
+            //* Publishes an empty snapshot.
+            atomic_snapshot(void) = default;
+
+            explicit atomic_snapshot(snapshot_type snapshot) : m_block{std::move(snapshot.m_block)} { /* empty */ }
+
+            atomic_snapshot(const atomic_snapshot &) = delete;
+            atomic_snapshot &operator=(const atomic_snapshot &) = delete;
+
+            //* The snapshot published last.
+            snapshot_type load(void) const { return snapshot_type(std::atomic_load(&m_block)); }
+
+            //* Publishes snapshot; readers that loaded the previous one keep it alive as long as they hold it.
+            void store(snapshot_type snapshot) { std::atomic_store(&m_block, std::move(snapshot.m_block)); }
+
+            //* Publishes snapshot and returns the previous one.
+            snapshot_type exchange(snapshot_type snapshot)
+            {
+                return snapshot_type(std::atomic_exchange(&m_block, std::move(snapshot.m_block)));
+            }
+
+            //* Whether load() and store() are lock-free on this platform.
+            bool is_lock_free(void) const { return std::atomic_is_lock_free(&m_block); }
+
+        private:
+            std::shared_ptr<const snapshot_detail::block<T, Allocator>> m_block; //!< The published elements.
+    };
+
+} // namespace sc.
+#endif
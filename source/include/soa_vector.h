@@ -0,0 +1,400 @@
+#ifndef _SOA_VECTOR_H_
+#define _SOA_VECTOR_H_
+
+#include <cstddef>      // std::size_t, std::ptrdiff_t
+#include <iterator>     // std::random_access_iterator_tag
+#include <stdexcept>    // std::out_of_range, std::length_error
+#include <tuple>        // std::tuple, std::get, std::tuple_element
+#include <type_traits>  // std::enable_if, std::integral_constant, std::decay
+#include <utility>      // std::forward
+
+#include "vector.h"     // sc::vector
+#include "span.h"       // sc::span
+#include "checks.h"     // SC_EXPECTS, SC_EXPECTS_NONEMPTY
+
+/// Sequence container namespace.
+namespace sc {
+    /// Compile-time integer sequences (std::index_sequence is C++14), to expand an operation over every column.
+    namespace soa_detail {
+        template <std::size_t... I>
+        struct index_sequence {};
+
+        template <std::size_t N, std::size_t... I>
+        struct make_index_sequence_impl : make_index_sequence_impl<N - 1, N - 1, I...> {};
+
+        template <std::size_t... I>
+        struct make_index_sequence_impl<0, I...> { using type = index_sequence<I...>; };
+
+        //* index_sequence<0, 1, ..., N-1>.
+        template <std::size_t N>
+        using make_index_sequence = typename make_index_sequence_impl<N>::type;
+
+        //* Whether Us... are one value per column of Ts... (and not a single tuple of all of them).
+        template <typename Tuple, typename... Us>
+        struct is_field_pack : std::integral_constant<bool, sizeof...(Us) == std::tuple_size<Tuple>::value> {};
+
+        template <typename Tuple, typename U>
+        struct is_field_pack<Tuple, U>
+            : std::integral_constant<bool, std::tuple_size<Tuple>::value == 1 and
+                                           not std::is_same<typename std::decay<U>::type, Tuple>::value> {};
+
+        //* Evaluates its arguments (a pack expansion) for their side effects, left to right.
+        struct expand
+        {
+            template <typename... Args>
+            expand(Args&&...) { /* empty */ }
+        };
+
+        //* Counts one more step done (as a call: ++done repeated in expand{} makes GCC warn).
+        template <typename Count>
+        int bump(Count &done) { ++done; return 0; }
+
+        //* Lowers least to value, if value is smaller.
+        template <typename Size>
+        int lower(Size &least, Size value)
+        {
+            if (value < least)
+                least = value;
+            return 0;
+        }
+    } // namespace soa_detail.
+
+    /// A sequence of records stored as a structure of arrays: one sc::vector per field.
+    /*!
+     * A sc::vector<Particle> interleaves the fields, so a pass over the x
+     * coordinates drags the whole structs through the cache. soa_vector<float,
+     * float, float, int> keeps every field in its own contiguous array: a pass
+     * over one column reads only that column, at full memory bandwidth, and
+     * the loop over a column() span auto-vectorizes.
+     *
+     *     sc::soa_vector<float, float, int> particles;   // x, v, id
+     *     particles.push_back(0.f, 1.f, 42);
+     *     sc::span<float> x = particles.column<0>();
+     *     sc::span<const float> v = particles.column<1>();
+     *     for (std::size_t i = 0 ; i < x.size() ; ++i) x[i] += v[i] * dt;
+     *
+     * Insertions and erasures apply to all the columns together; the columns
+     * are plain sc::vector, so they grow with its growth policy and storage
+     * code. operator[] and the zip iterators give a std::tuple of references
+     * to the fields of one record.
+     *
+     * \tparam Ts The types of the fields, one column each.
+     */
+    template <typename... Ts>
+    class soa_vector
+    {
+        static_assert(sizeof...(Ts) > 0, "[soa_vector]: Needs at least one column.");
+
+        //=== Aliases
+        public:
+            using size_type = unsigned long;                //!< The size type.
+            using value_type = std::tuple<Ts...>;           //!< A record, by value.
+            using reference = std::tuple<Ts&...>;           //!< References to the fields of a record.
+            using const_reference = std::tuple<const Ts&...>; //!< Read-only references to the fields of a record.
+
+            //* The type of column I.
+            template <std::size_t I>
+            using column_type = typename std::tuple_element<I, std::tuple<Ts...>>::type;
+
+            static constexpr std::size_t columns = sizeof...(Ts); //!< Number of columns.
+
+            /// Random-access iterator over the records; Soa is soa_vector or const soa_vector.
+            template <typename Soa, typename Ref>
+            class zip_iterator
+            {
+                public:
+                    using difference_type = std::ptrdiff_t;
+                    using value_type = std::tuple<Ts...>;
+                    using reference = Ref;
+                    using pointer = void;
+                    using iterator_category = std::random_access_iterator_tag;
+
+                    zip_iterator(Soa *soa = nullptr, size_type pos = 0) : m_soa{soa}, m_pos{pos} { /* empty */ }
+
+                    //* An iterator converts to a const_iterator.
+                    operator zip_iterator<const soa_vector, const_reference>(void) const
+                    {
+                        return zip_iterator<const soa_vector, const_reference>(m_soa, m_pos);
+                    }
+
+                    Ref operator*(void) const { return (*m_soa)[m_pos]; }
+                    Ref operator[](difference_type n) const { return (*m_soa)[m_pos + n]; }
+
+                    zip_iterator &operator++(void) { ++m_pos; return *this; }
+                    zip_iterator operator++(int) { zip_iterator old{*this}; ++m_pos; return old; }
+                    zip_iterator &operator--(void) { --m_pos; return *this; }
+                    zip_iterator operator--(int) { zip_iterator old{*this}; --m_pos; return old; }
+                    zip_iterator &operator+=(difference_type n) { m_pos += n; return *this; }
+                    zip_iterator &operator-=(difference_type n) { m_pos -= n; return *this; }
+
+                    friend zip_iterator operator+(zip_iterator it, difference_type n) { return it += n; }
+                    friend zip_iterator operator+(difference_type n, zip_iterator it) { return it += n; }
+                    friend zip_iterator operator-(zip_iterator it, difference_type n) { return it -= n; }
+                    friend difference_type operator-(const zip_iterator &a, const zip_iterator &b)
+                    {
+                        return static_cast<difference_type>(a.m_pos) - static_cast<difference_type>(b.m_pos);
+                    }
+
+                    friend bool operator==(const zip_iterator &a, const zip_iterator &b) { return a.m_pos == b.m_pos; }
+                    friend bool operator!=(const zip_iterator &a, const zip_iterator &b) { return a.m_pos != b.m_pos; }
+                    friend bool operator<(const zip_iterator &a, const zip_iterator &b) { return a.m_pos < b.m_pos; }
+                    friend bool operator>(const zip_iterator &a, const zip_iterator &b) { return a.m_pos > b.m_pos; }
+                    friend bool operator<=(const zip_iterator &a, const zip_iterator &b) { return a.m_pos <= b.m_pos; }
+                    friend bool operator>=(const zip_iterator &a, const zip_iterator &b) { return a.m_pos >= b.m_pos; }
+
+                    //* Index of the record.
+                    size_type index(void) const { return m_pos; }
+
+                private:
+                    Soa *m_soa;         //!< The records iterated over.
+                    size_type m_pos;    //!< The current record.
+            };
+
+            using iterator = zip_iterator<soa_vector, reference>;                 //!< Iterator with write access.
+            using const_iterator = zip_iterator<const soa_vector, const_reference>; //!< Read-only iterator.
+
+        private:
+            using indices = soa_detail::make_index_sequence<sizeof...(Ts)>;
+
+        public:
+            //!=== [I] Special members
+            //* An empty container, without memory.
+            soa_vector(void) = default;
+
+            //!=== [II] Iterators
+            iterator begin(void) { return iterator(this, 0); }
+            iterator end(void) { return iterator(this, size()); }
+            const_iterator begin(void) const { return const_iterator(this, 0); }
+            const_iterator end(void) const { return const_iterator(this, size()); }
+            const_iterator cbegin(void) const { return begin(); }
+            const_iterator cend(void) const { return end(); }
+
+            //!=== [III] Capacity
+            //* Number of records.
+            size_type size(void) const { return std::get<0>(m_columns).size(); }
+
+            //* Number of records that fit without reallocating any column.
+            size_type capacity(void) const { return capacity(indices{}); }
+
+            bool empty(void) const { return size() == 0; }
+
+            //* Makes room for cap records in every column.
+            void reserve(size_type cap) { reserve(cap, indices{}); }
+
+            void shrink_to_fit(void) { shrink_to_fit(indices{}); }
+
+            //!=== [IV] Modifiers
+            void clear(void) { clear(indices{}); }
+
+            //* Appends a record, one value per column. If a column throws, the others are rolled back.
+            template <typename... Us,
+                      typename = typename std::enable_if<soa_detail::is_field_pack<value_type, Us...>::value>::type>
+            void push_back(Us&&... values)
+            {
+                size_type pos{size()};
+                std::size_t done{0};
+                try {
+                    push_back(indices{}, done, std::forward<Us>(values)...);
+                }
+                catch (...) {
+                    truncate(indices{}, done, pos);
+                    throw;
+                }
+            }
+
+            //* Appends a record given as a tuple.
+            void push_back(const value_type &record) { push_tuple(record, indices{}); }
+            void push_back(value_type &&record) { move_tuple(record, indices{}); }
+
+            //* Removes the last record.
+            void pop_back(void)
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[soa_vector::pop_back()]: Can not remove a record from an empty container.");
+                pop_back(indices{});
+            }
+
+            //* Inserts a record before pos, one value per column. Returns an iterator to it.
+            //* If a column throws, the others are rolled back.
+            template <typename... Us>
+            iterator insert(const_iterator pos, Us&&... values)
+            {
+                static_assert(sizeof...(Us) == sizeof...(Ts), "[soa_vector::insert()]: Needs one value per column.");
+                size_type at{pos.index()};
+                SC_EXPECTS(at <= size(), std::out_of_range, "[soa_vector::insert()]: position provided is out of container range");
+                std::size_t done{0};
+                try {
+                    insert(indices{}, at, done, std::forward<Us>(values)...);
+                }
+                catch (...) {
+                    erase_from(indices{}, done, at, at + 1);
+                    throw;
+                }
+                return iterator(this, at);
+            }
+
+            //* Removes the records in [first, last). Returns the iterator following them.
+            iterator erase(const_iterator first, const_iterator last)
+            {
+                SC_EXPECTS(first.index() <= last.index() and last.index() <= size(), std::out_of_range,
+                           "[soa_vector::erase()]: range provided is out of container range");
+                erase_from(indices{}, sizeof...(Ts), first.index(), last.index());
+                return iterator(this, first.index());
+            }
+
+            //* Removes the record at pos. Returns the iterator following it.
+            iterator erase(const_iterator pos)
+            {
+                SC_EXPECTS(pos.index() < size(), std::out_of_range, "[soa_vector::erase()]: position provided is out of container range");
+                return erase(pos, pos + 1);
+            }
+
+            friend void swap(soa_vector &a, soa_vector &b)
+            {
+                using std::swap;
+                swap(a.m_columns, b.m_columns);
+            }
+
+            //!=== [V] Element access
+            //* References to the fields of record pos. Checked according to SC_BOUNDS_CHECK.
+            reference operator[](size_type pos)
+            {
+                SC_EXPECTS(pos < size(), std::out_of_range, "[soa_vector::operator[]]: position provided is out of container range");
+                return record<reference>(*this, pos, indices{});
+            }
+
+            const_reference operator[](size_type pos) const
+            {
+                SC_EXPECTS(pos < size(), std::out_of_range, "[soa_vector::operator[]]: position provided is out of container range");
+                return record<const_reference>(*this, pos, indices{});
+            }
+
+            //* References to the fields of record pos, with bounds-checking.
+            reference at(size_type pos)
+            {
+                if (pos >= size())
+                    throw std::out_of_range("[soa_vector::at(pos)]: position provided is out of container range");
+                return (*this)[pos];
+            }
+
+            const_reference at(size_type pos) const
+            {
+                if (pos >= size())
+                    throw std::out_of_range("[soa_vector::at(pos)]: position provided is out of container range");
+                return (*this)[pos];
+            }
+
+            //* Field I of record pos.
+            template <std::size_t I>
+            column_type<I> &get(size_type pos) { return std::get<I>(m_columns)[pos]; }
+
+            template <std::size_t I>
+            const column_type<I> &get(size_type pos) const { return std::get<I>(m_columns)[pos]; }
+
+            //* Column I, as a contiguous view. Invalidated when the container reallocates.
+            template <std::size_t I>
+            span<column_type<I>> column(void) { return span<column_type<I>>(std::get<I>(m_columns).data(), size()); }
+
+            template <std::size_t I>
+            span<const column_type<I>> column(void) const
+            {
+                return span<const column_type<I>>(std::get<I>(m_columns).data(), size());
+            }
+
+            //* The first element of column I.
+            template <std::size_t I>
+            column_type<I> *data(void) { return std::get<I>(m_columns).data(); }
+
+            template <std::size_t I>
+            const column_type<I> *data(void) const { return std::get<I>(m_columns).data(); }
+
+        private:
+            //!=== Operations over every column
+            template <typename Ref, typename Self, std::size_t... I>
+            static Ref record(Self &self, size_type pos, soa_detail::index_sequence<I...>)
+            {
+                return Ref(std::get<I>(self.m_columns)[pos]...);
+            }
+
+            template <std::size_t... I>
+            size_type capacity(soa_detail::index_sequence<I...>) const
+            {
+                size_type cap{std::get<0>(m_columns).capacity()};
+                soa_detail::expand{soa_detail::lower(cap, std::get<I>(m_columns).capacity())...};
+                return cap;
+            }
+
+            template <std::size_t... I>
+            void reserve(size_type cap, soa_detail::index_sequence<I...>)
+            {
+                soa_detail::expand{(std::get<I>(m_columns).reserve(cap), 0)...};
+            }
+
+            template <std::size_t... I>
+            void shrink_to_fit(soa_detail::index_sequence<I...>)
+            {
+                soa_detail::expand{(std::get<I>(m_columns).shrink_to_fit(), 0)...};
+            }
+
+            template <std::size_t... I>
+            void clear(soa_detail::index_sequence<I...>)
+            {
+                soa_detail::expand{(std::get<I>(m_columns).clear(), 0)...};
+            }
+
+            template <std::size_t... I>
+            void pop_back(soa_detail::index_sequence<I...>)
+            {
+                soa_detail::expand{(std::get<I>(m_columns).pop_back(), 0)...};
+            }
+
+            //* Appends to the columns in order, counting in done those that succeeded.
+            template <std::size_t... I, typename... Us>
+            void push_back(soa_detail::index_sequence<I...>, std::size_t &done, Us&&... values)
+            {
+                soa_detail::expand{(std::get<I>(m_columns).push_back(std::forward<Us>(values)), soa_detail::bump(done))...};
+            }
+
+            template <std::size_t... I>
+            void push_tuple(const value_type &record, soa_detail::index_sequence<I...>)
+            {
+                push_back(std::get<I>(record)...);
+            }
+
+            template <std::size_t... I>
+            void move_tuple(value_type &record, soa_detail::index_sequence<I...>)
+            {
+                push_back(std::move(std::get<I>(record))...);
+            }
+
+            //* Removes the records from pos on in the first done columns.
+            template <std::size_t... I>
+            void truncate(soa_detail::index_sequence<I...>, std::size_t done, size_type pos)
+            {
+                soa_detail::expand{(I < done ? (std::get<I>(m_columns).erase(
+                    std::get<I>(m_columns).begin() + static_cast<std::ptrdiff_t>(pos), std::get<I>(m_columns).end()), 0) : 0)...};
+            }
+
+            template <std::size_t... I, typename... Us>
+            void insert(soa_detail::index_sequence<I...>, size_type at, std::size_t &done, Us&&... values)
+            {
+                soa_detail::expand{(std::get<I>(m_columns).insert(
+                    std::get<I>(m_columns).begin() + static_cast<std::ptrdiff_t>(at), column_type<I>(std::forward<Us>(values))), soa_detail::bump(done))...};
+            }
+
+            //* Removes the records [first, last) from the first done columns.
+            template <std::size_t... I>
+            void erase_from(soa_detail::index_sequence<I...>, std::size_t done, size_type first, size_type last)
+            {
+                soa_detail::expand{(I < done ? (std::get<I>(m_columns).erase(
+                    std::get<I>(m_columns).begin() + static_cast<std::ptrdiff_t>(first),
+                    std::get<I>(m_columns).begin() + static_cast<std::ptrdiff_t>(last)), 0) : 0)...};
+            }
+
+            std::tuple<vector<Ts>...> m_columns;    //!< One array per field, all of the same size.
+    };
+
+    template <typename... Ts>
+    constexpr std::size_t soa_vector<Ts...>::columns;
+
+} // namespace sc.
+#endif
@@ -0,0 +1,348 @@
+#ifndef _SORT_H_
+#define _SORT_H_
+
+#include <algorithm>    // std::sort, std::stable_sort, std::move
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t
+#include <cstring>      // std::memcpy
+#include <functional>   // std::less
+#include <memory>       // std::allocator
+#include <new>          // placement new
+#include <type_traits>  // std::is_arithmetic, std::is_floating_point, std::is_signed, std::decay
+#include <utility>      // std::move
+#include <vector>       // std::vector
+
+#include "parallel.h"   // sc::parallel::options, sc::thread_pool
+
+/// Sequence container namespace.
+namespace sc {
+    /// Sorting of contiguous ranges (raw pointers, sc::vector, sc::small_vector, sc::span).
+    /*!
+     * Two algorithms:
+     *
+     *  - radix_sort(): a stable LSD radix sort, 8 or 11 bits of the key per
+     *    pass, for integer and floating-point keys. The key is the element itself or
+     *    comes from a key extractor, as in radix_sort(pairs, [](const P &p) { return p.first; }).
+     *    Passes where every key has the same digit are skipped, so small keys
+     *    in wide types cost only the passes they need. Floating-point keys
+     *    sort as by <, with -0.0 before +0.0 and NaNs at the ends.
+     *  - sort(range, comp): for any strict weak ordering. Each thread of the
+     *    pool sorts a run with std::sort, then the runs are merged pairwise;
+     *    every merge round is split over all the threads along merge-path
+     *    boundaries, so the last merges keep them all busy too.
+     *
+     * sort(range) without a comparator picks the radix sort for arithmetic
+     * elements and the merge sort with < for everything else.
+     *
+     *     sc::vector<std::uint64_t> v = ...;
+     *     sc::sort(v);
+     *     sc::sort(records, [](const R &a, const R &b) { return a.name < b.name; });
+     *
+     * Both use a scratch buffer of the size of the range. Elements are moved,
+     * never copied; their moves and comparisons must not throw.
+     */
+    namespace sorting {
+        namespace detail {
+            /// Uninitialized scratch space for n elements. The elements are constructed by the first pass
+            /// that writes them all, after which live is set and the destructor destroys them.
+            template <typename T>
+            struct scratch
+            {
+                T *data;
+                std::size_t size;
+                bool live;
+
+                explicit scratch(std::size_t n) : data{std::allocator<T>().allocate(n)}, size{n}, live{false} { /* empty */ }
+                scratch(const scratch &) = delete;
+                scratch &operator=(const scratch &) = delete;
+                ~scratch(void)
+                {
+                    if (live)
+                        for (std::size_t i{0} ; i < size ; ++i)
+                            data[i].~T();
+                    std::allocator<T>().deallocate(data, size);
+                }
+            };
+
+            //* Writes value to at, constructing it (raw scratch) or assigning it (live storage).
+            template <typename T>
+            void put(T *at, T &value, std::true_type) { ::new (static_cast<void*>(at)) T(std::move(value)); }
+
+            template <typename T>
+            void put(T *at, T &value, std::false_type) { *at = std::move(value); }
+
+            //!=== Radix sort
+            template <std::size_t N> struct unsigned_of;
+            template <> struct unsigned_of<1> { using type = std::uint8_t; };
+            template <> struct unsigned_of<2> { using type = std::uint16_t; };
+            template <> struct unsigned_of<4> { using type = std::uint32_t; };
+            template <> struct unsigned_of<8> { using type = std::uint64_t; };
+
+            //* How a key maps to bits: 0 = unsigned integer, 1 = signed integer, 2 = floating point.
+            template <typename K>
+            struct key_kind : std::integral_constant<int,
+                std::is_floating_point<K>::value ? 2 : std::is_signed<K>::value ? 1 : 0> {};
+
+            //* Unsigned bits that sort in the same order as the key.
+            template <typename K, typename U = typename unsigned_of<sizeof(K)>::type>
+            U key_bits(K key, std::integral_constant<int, 0>) { return static_cast<U>(key); }
+
+            template <typename K, typename U = typename unsigned_of<sizeof(K)>::type>
+            U key_bits(K key, std::integral_constant<int, 1>)
+            {
+                // Flipping the sign bit puts the negative numbers first, in order.
+                return static_cast<U>(static_cast<U>(key) ^ (U{1} << (8 * sizeof(K) - 1)));
+            }
+
+            template <typename K, typename U = typename unsigned_of<sizeof(K)>::type>
+            U key_bits(K key, std::integral_constant<int, 2>)
+            {
+                // Negative numbers: flip everything, so larger magnitudes come first. Positive ones: set the sign bit.
+                U bits;
+                std::memcpy(&bits, &key, sizeof(K));
+                const U sign{static_cast<U>(U{1} << (8 * sizeof(K) - 1))};
+                return (bits & sign) ? static_cast<U>(~bits) : static_cast<U>(bits | sign);
+            }
+
+            template <typename K>
+            typename unsigned_of<sizeof(K)>::type key_bits(K key) { return key_bits(key, key_kind<K>{}); }
+
+            //* Bits of the key sorted by each pass. 11-bit digits cost about as much per pass as bytes
+            //* (the 2048 buckets still fit in L1), and they take 3 passes instead of 4 for 32-bit keys
+            //* and 6 instead of 8 for 64-bit keys.
+            template <typename K>
+            struct digit_bits : std::integral_constant<unsigned, sizeof(K) >= 4 ? 11 : 8> {};
+
+            //* One counting-sort pass on the digit at bit shift of the keys, from src to dst.
+            template <typename T, typename Key, typename Construct>
+            void scatter(T *src, T *dst, std::size_t n, Key &key, unsigned shift, std::size_t mask,
+                         std::size_t *offset, Construct construct)
+            {
+                for (std::size_t i{0} ; i < n ; ++i) {
+                    std::size_t digit = static_cast<std::size_t>(key_bits(key(src[i])) >> shift) & mask;
+                    put(dst + offset[digit]++, src[i], construct);
+                }
+            }
+
+            //* Below this size, a comparison sort on the keys is faster than the passes over the histograms.
+            constexpr std::size_t radix_threshold{256};
+
+            template <typename T, typename Key>
+            void radix_sort(T *first, T *last, Key key)
+            {
+                using K = typename std::decay<decltype(key(*first))>::type;
+                static_assert(std::is_arithmetic<K>::value and sizeof(K) <= 8,
+                              "[sc::radix_sort()]: The key must be an integer or a floating-point number of at most 64 bits.");
+                constexpr unsigned bits{digit_bits<K>::value};
+                constexpr unsigned passes{(8 * sizeof(K) + bits - 1) / bits};
+                constexpr std::size_t buckets{std::size_t{1} << bits};
+                constexpr std::size_t mask{buckets - 1};
+                const std::size_t n = static_cast<std::size_t>(last - first);
+                if (n < radix_threshold) {
+                    std::stable_sort(first, last, [&key](const T &a, const T &b) { return key_bits(key(a)) < key_bits(key(b)); });
+                    return;
+                }
+
+                // All the histograms in a single read pass.
+                std::vector<std::size_t> count(passes * buckets, 0);
+                for (T *it{first} ; it != last ; ++it) {
+                    auto k = key_bits(key(*it));
+                    for (unsigned d{0} ; d < passes ; ++d)
+                        ++count[d * buckets + (static_cast<std::size_t>(k >> (d * bits)) & mask)];
+                }
+
+                scratch<T> buffer(n);
+                T *src{first};
+                T *dst{buffer.data};
+                const auto first_key = key_bits(key(*first));
+                for (unsigned d{0} ; d < passes ; ++d) {
+                    std::size_t *offset{&count[d * buckets]};
+                    if (offset[static_cast<std::size_t>(first_key >> (d * bits)) & mask] == n)
+                        continue;   // Every key has this digit: the pass would not move anything.
+                    std::size_t sum{0};
+                    for (std::size_t b{0} ; b < buckets ; ++b) {
+                        std::size_t c{offset[b]};
+                        offset[b] = sum;
+                        sum += c;
+                    }
+                    if (dst == buffer.data and not buffer.live) {
+                        scatter(src, dst, n, key, d * bits, mask, offset, std::true_type{});
+                        buffer.live = true;
+                    }
+                    else
+                        scatter(src, dst, n, key, d * bits, mask, offset, std::false_type{});
+                    std::swap(src, dst);
+                }
+                if (src != first)
+                    std::move(src, src + n, first);
+            }
+
+            //!=== Merge sort
+            //* Number of elements taken from a in the first k elements of the stable merge of a[0, m) and b[0, nb).
+            template <typename T, typename Comp>
+            std::size_t co_rank(std::size_t k, const T *a, std::size_t m, const T *b, std::size_t nb, Comp &comp)
+            {
+                std::size_t lo{k > nb ? k - nb : 0};
+                std::size_t hi{k < m ? k : m};
+                while (lo < hi) {
+                    std::size_t i{lo + (hi - lo) / 2};
+                    // a[i] goes before b[k-i-1] (ties included, for stability): more of a is needed.
+                    if (not comp(b[k - i - 1], a[i]))
+                        lo = i + 1;
+                    else
+                        hi = i;
+                }
+                return lo;
+            }
+
+            //* Where the pair of runs holding output position pos starts, and the sizes of its two runs.
+            inline std::size_t pair_of(std::size_t pos, std::size_t n, std::size_t width, std::size_t &m, std::size_t &nb)
+            {
+                std::size_t p{pos - pos % (2 * width)};
+                m = p < n ? (width < n - p ? width : n - p) : 0;
+                nb = p < n ? (2 * width < n - p ? 2 * width : n - p) - m : 0;
+                return p;
+            }
+
+            //* Writes the part [lo, hi) of the output of a merge round: runs of width elements of src are merged
+            //* pairwise into dst. The part may span several pairs, or only a piece of one. split_lo and split_hi
+            //* are the co-ranks of lo and hi in their pairs, found before any element was moved.
+            template <typename T, typename Comp, typename Construct>
+            void merge_part(T *src, T *dst, std::size_t n, std::size_t width, std::size_t lo, std::size_t hi,
+                            std::size_t split_lo, std::size_t split_hi, Comp &comp, Construct construct)
+            {
+                std::size_t m, nb;
+                for (std::size_t p{pair_of(lo, n, width, m, nb)} ; p < hi ; p = pair_of(p + 2 * width, n, width, m, nb)) {
+                    T *a{src + p};
+                    T *b{a + m};
+                    std::size_t out_lo{(lo > p ? lo : p) - p};
+                    std::size_t out_hi{(hi < p + m + nb ? hi : p + m + nb) - p};
+                    std::size_t i{lo > p ? split_lo : 0};
+                    std::size_t j{out_lo - i};
+                    std::size_t i_end{hi < p + m + nb ? split_hi : m};
+                    std::size_t j_end{out_hi - i_end};
+                    T *out{dst + p + out_lo};
+                    while (i < i_end and j < j_end) {
+                        if (comp(b[j], a[i]))
+                            put(out++, b[j++], construct);
+                        else
+                            put(out++, a[i++], construct);
+                    }
+                    while (i < i_end)
+                        put(out++, a[i++], construct);
+                    while (j < j_end)
+                        put(out++, b[j++], construct);
+                }
+            }
+
+            //* Below this size a range is not worth splitting over threads.
+            constexpr std::size_t merge_min_run{1 << 14};
+
+            template <typename T, typename Comp>
+            void merge_sort(T *first, T *last, Comp comp, const parallel::options &opt)
+            {
+                const std::size_t n = static_cast<std::size_t>(last - first);
+                const std::size_t threads{opt.pool->size()};
+                std::size_t run{opt.grain != 0 ? opt.grain : (n + threads - 1) / threads};
+                if (run < merge_min_run and opt.grain == 0)
+                    run = merge_min_run;
+                if (run >= n) {
+                    std::sort(first, last, comp);
+                    return;
+                }
+
+                // [1] Sort runs of the range, one per thread.
+                opt.pool->run_chunks(n, run, [&](std::size_t lo, std::size_t hi) { std::sort(first + lo, first + hi, comp); });
+
+                // [2] Merge pairs of runs, then pairs of those, ... each round split into pieces of the output.
+                std::size_t piece{opt.grain != 0 ? opt.grain : n / (4 * threads) + 1};
+                if (piece < merge_min_run and opt.grain == 0)
+                    piece = merge_min_run;
+                scratch<T> buffer(n);
+                T *src{first};
+                T *dst{buffer.data};
+                std::vector<std::size_t> split((n - 1) / piece + 2);
+                for (std::size_t width{run} ; width < n ; width *= 2) {
+                    // The merge moves elements out of src, so every piece boundary is located first.
+                    for (std::size_t k{0} ; k < split.size() ; ++k) {
+                        std::size_t pos{k * piece < n ? k * piece : n};
+                        std::size_t m, nb;
+                        std::size_t p{pair_of(pos, n, width, m, nb)};
+                        split[k] = p < n ? co_rank(pos - p, src + p, m, src + p + m, nb, comp) : 0;
+                    }
+                    auto merge = [&](std::size_t lo, std::size_t hi) {
+                        std::size_t k{lo / piece};
+                        if (dst == buffer.data and not buffer.live)
+                            merge_part(src, dst, n, width, lo, hi, split[k], split[k + 1], comp, std::true_type{});
+                        else
+                            merge_part(src, dst, n, width, lo, hi, split[k], split[k + 1], comp, std::false_type{});
+                    };
+                    opt.pool->run_chunks(n, piece, merge);
+                    if (dst == buffer.data)
+                        buffer.live = true;
+                    std::swap(src, dst);
+                }
+                if (src != first)
+                    parallel::copy(std::make_move_iterator(src), std::make_move_iterator(src + n), first, opt);
+            }
+
+            //* sort() without a comparator: radix for numbers, merge sort with < for the rest.
+            template <typename T>
+            void sort(T *first, T *last, std::true_type) { radix_sort(first, last, [](const T &x) { return x; }); }
+
+            template <typename T>
+            void sort(T *first, T *last, std::false_type) { merge_sort(first, last, std::less<T>(), parallel::options()); }
+
+            template <typename T>
+            struct radix_sortable : std::integral_constant<bool,
+                std::is_arithmetic<T>::value and not std::is_same<T, bool>::value and sizeof(T) <= 8> {};
+        } // namespace detail.
+    } // namespace sorting.
+
+    //!=== Sorting
+    //* Sorts [first, last) in ascending order: radix sort for numbers, parallel merge sort with < otherwise.
+    template <typename T>
+    void sort(T *first, T *last)
+    {
+        sorting::detail::sort(first, last, sorting::detail::radix_sortable<T>{});
+    }
+
+    //* Sorts [first, last) with comp on the threads of opt.pool. Not stable, as std::sort.
+    //* A grain in opt sets the length of the runs sorted by each task.
+    template <typename T, typename Comp>
+    void sort(T *first, T *last, Comp comp, const parallel::options &opt = parallel::options())
+    {
+        sorting::detail::merge_sort(first, last, comp, opt);
+    }
+
+    //* Stable radix sort of [first, last) by the elements themselves, which must be numbers.
+    template <typename T>
+    void radix_sort(T *first, T *last)
+    {
+        sorting::detail::radix_sort(first, last, [](const T &x) { return x; });
+    }
+
+    //* Stable radix sort of [first, last) by key(element), which must return a number.
+    template <typename T, typename Key>
+    void radix_sort(T *first, T *last, Key key)
+    {
+        sorting::detail::radix_sort(first, last, key);
+    }
+
+    template <typename C>
+    parallel::detail::if_container<C> sort(C &c) { sc::sort(c.data(), c.data() + c.size()); }
+
+    template <typename C, typename Comp>
+    parallel::detail::if_container<C> sort(C &c, Comp comp, const parallel::options &opt = parallel::options())
+    {
+        sc::sort(c.data(), c.data() + c.size(), comp, opt);
+    }
+
+    template <typename C>
+    parallel::detail::if_container<C> radix_sort(C &c) { sc::radix_sort(c.data(), c.data() + c.size()); }
+
+    template <typename C, typename Key>
+    parallel::detail::if_container<C> radix_sort(C &c, Key key) { sc::radix_sort(c.data(), c.data() + c.size(), key); }
+
+} // namespace sc.
+#endif
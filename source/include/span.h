@@ -0,0 +1,119 @@
+#ifndef _SPAN_H_
+#define _SPAN_H_
+
+#include <stdexcept>    // std::out_of_range
+#include <type_traits>  // std::enable_if, std::is_convertible, std::remove_cv
+#include <utility>      // std::declval
+
+#include "vector.h"     // sc::MyForwardIterator
+
+/// Sequence container namespace.
+namespace sc {
+    /// A non-owning view over a contiguous sequence of elements.
+    /*!
+     * A span is just a pointer and a length, so it is cheap to copy and to pass
+     * by value. It can be built from a sc::vector, a sc::small_vector (of any
+     * inline capacity), a C array or a pointer range, which lets a function
+     * accept any of them without being a template on the container type.
+     *
+     * The span does not own the elements: any operation that reallocates the
+     * underlying container invalidates it.
+     *
+     * \tparam T The type of the elements; use `const T` for a read-only view.
+     */
+    template <typename T>
+    class span
+    {
+        //=== Aliases
+        public:
+            using size_type = unsigned long;                         //!< The size type.
+            using element_type = T;                                  //!< The element type, possibly const.
+            using value_type = typename std::remove_cv<T>::type;     //!< The value type.
+            using pointer = element_type*;                           //!< Pointer to an element.
+            using reference = element_type&;                         //!< Reference to an element.
+            using iterator = MyForwardIterator<element_type>;        //!< The iterator.
+
+        public:
+            //!=== [I] Special members
+            //* An empty view.
+            span(void) : m_data{nullptr}, m_size{0} { /* empty */ }
+
+            //* A view over the count elements starting at first.
+            span(pointer first, size_type count) : m_data{first}, m_size{count} { /* empty */ }
+
+            //* A view over the range [first, last).
+            span(pointer first, pointer last) : m_data{first}, m_size{static_cast<size_type>(last - first)} { /* empty */ }
+
+            //* A view over a C array.
+            template <std::size_t N>
+            span(element_type (&arr)[N]) : m_data{arr}, m_size{N} { /* empty */ }
+
+            //* A view over any contiguous container that exposes data() and size().
+            template <typename Container,
+                      typename = typename std::enable_if<
+                          std::is_convertible<decltype(std::declval<Container&>().data()), pointer>::value>::type>
+            span(Container &c) : m_data{c.data()}, m_size{static_cast<size_type>(c.size())} { /* empty */ }
+
+            //* Converts a span<U> into a span<T>, e.g. span<int> into span<const int>.
+            template <typename U,
+                      typename = typename std::enable_if<std::is_convertible<U(*)[], T(*)[]>::value>::type>
+            span(const span<U> &other) : m_data{other.data()}, m_size{other.size()} { /* empty */ }
+
+            //!=== [II] Iterators
+            //* An iterator pointing to the first element of the view.
+            iterator begin(void) const { return iterator(m_data); }
+
+            //* An iterator pointing to the position just after the last element of the view.
+            iterator end(void) const { return iterator(m_data + m_size); }
+
+            //!=== [III] Capacity
+            //* Number of elements in the view.
+            size_type size(void) const { return m_size; }
+
+            //* Number of bytes covered by the view.
+            size_type size_bytes(void) const { return m_size * sizeof(element_type); }
+
+            //* Check if the view is empty.
+            bool empty(void) const { return m_size == 0; }
+
+            //!=== [V] Element access
+            //* Access the element in the position pos, without bounds-checking.
+            reference operator[](size_type pos) const { return m_data[pos]; }
+
+            //* Returns the element in the position pos, with bounds-checking.
+            reference at(size_type pos) const
+            {
+                if (pos >= m_size)
+                    throw std::out_of_range("[span::at(pos)]: position provided is out of span range");
+                return m_data[pos];
+            }
+
+            //* The first element of the view.
+            reference front(void) const { return m_data[0]; }
+
+            //* The last element of the view.
+            reference back(void) const { return m_data[m_size - 1]; }
+
+            //* Pointer to the first element of the view.
+            pointer data(void) const { return m_data; }
+
+            //!=== Subviews
+            //* A view over the first count elements.
+            span first(size_type count) const { return span{m_data, count}; }
+
+            //* A view over the last count elements.
+            span last(size_type count) const { return span{m_data + (m_size - count), count}; }
+
+            //* A view over count elements starting at offset (up to the end if count is omitted).
+            span subspan(size_type offset, size_type count = static_cast<size_type>(-1)) const
+            {
+                return span{m_data + offset, count == static_cast<size_type>(-1) ? m_size - offset : count};
+            }
+
+        private:
+            pointer m_data;     //!< The first element of the view.
+            size_type m_size;   //!< Number of elements in the view.
+    };
+
+} // namespace sc.
+#endif
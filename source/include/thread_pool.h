@@ -0,0 +1,217 @@
+#ifndef _THREAD_POOL_H_
+#define _THREAD_POOL_H_
+
+#include <atomic>       // std::atomic<T>
+#include <condition_variable> // std::condition_variable
+#include <cstddef>      // std::size_t
+#include <cstdlib>      // std::getenv, std::atoi
+#include <deque>        // std::deque
+#include <exception>    // std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <functional>   // std::function
+#include <memory>       // std::unique_ptr
+#include <mutex>        // std::mutex, std::lock_guard, std::unique_lock
+#include <thread>       // std::thread, std::this_thread::yield
+#include <vector>       // std::vector
+
+/// Sequence container namespace.
+namespace sc {
+    /// A small work-stealing thread pool, meant to be created once and reused by every parallel call.
+    /*!
+     * A pool of size N runs N-1 background workers; the thread that starts a
+     * parallel operation is the N-th and works on it too, so thread_pool(1)
+     * simply runs everything inline.
+     *
+     * Each worker owns a task queue. Tasks of a batch are dealt round-robin over
+     * the queues; a worker takes the newest task of its own queue (still hot in
+     * its cache) and, when that is empty, steals the oldest task of another
+     * queue. The caller of run_chunks() steals too while it waits, so nested
+     * parallel calls can not deadlock.
+     *
+     *     sc::thread_pool pool(16);
+     *     pool.run_chunks(n, 1 << 16, [&](std::size_t lo, std::size_t hi) { ... });
+     */
+    class thread_pool
+    {
+        public:
+            //* Creates a pool running on threads threads in total (the caller included).
+            explicit thread_pool(std::size_t threads = default_size())
+                : m_stop{false}, m_pending{0}, m_next{0}
+            {
+                if (threads == 0)
+                    threads = 1;
+                for (std::size_t i{1} ; i < threads ; ++i)
+                    m_queues.emplace_back(new queue);
+                for (std::size_t i{0} ; i + 1 < threads ; ++i)
+                    m_workers.emplace_back([this, i] { work(i); });
+            }
+
+            thread_pool(const thread_pool &) = delete;
+            thread_pool &operator=(const thread_pool &) = delete;
+
+            //* Waits for the workers to finish their current task and joins them.
+            ~thread_pool(void)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_sleep_mutex);
+                    m_stop = true;
+                }
+                m_wake.notify_all();
+                for (auto &t : m_workers)
+                    t.join();
+            }
+
+            //* Total number of threads working on a parallel call, the caller included.
+            std::size_t size(void) const { return m_workers.size() + 1; }
+
+            //* The thread count of the shared pool: $SC_THREADS if set, else the hardware concurrency.
+            static std::size_t default_size(void)
+            {
+                const char *env = std::getenv("SC_THREADS");
+                if (env != nullptr and std::atoi(env) > 0)
+                    return static_cast<std::size_t>(std::atoi(env));
+                std::size_t hw{std::thread::hardware_concurrency()};
+                return hw == 0 ? 1 : hw;
+            }
+
+            //* The pool shared by the parallel algorithms when none is given.
+            static thread_pool &global(void)
+            {
+                static thread_pool pool;
+                return pool;
+            }
+
+            //* Calls f(lo, hi) over consecutive chunks of [0, n) of (about) grain indices, on all the threads.
+            //* Returns when every chunk is done. If some calls throw, the first exception is rethrown here.
+            template <typename F>
+            void run_chunks(std::size_t n, std::size_t grain, F f)
+            {
+                if (n == 0)
+                    return;
+                if (grain == 0)
+                    grain = 1;
+                std::size_t chunks{(n - 1) / grain + 1};
+                if (chunks == 1 or m_workers.empty()) {
+                    for (std::size_t lo{0} ; lo < n ; lo += grain)
+                        f(lo, lo + grain < n ? lo + grain : n);
+                    return;
+                }
+
+                batch b(chunks);
+                for (std::size_t k{1} ; k < chunks ; ++k) {
+                    std::size_t lo{k * grain};
+                    std::size_t hi{lo + grain < n ? lo + grain : n};
+                    push([&b, &f, lo, hi] { b.run(f, lo, hi); });
+                }
+                {
+                    // Taking the lock orders this wake-up after the check of a worker about to sleep.
+                    std::lock_guard<std::mutex> lock(m_sleep_mutex);
+                }
+                m_wake.notify_all();
+
+                // The first chunk is ours; then help with whatever is queued until the batch is done.
+                b.run(f, 0, grain);
+                while (b.remaining.load(std::memory_order_acquire) != 0) {
+                    if (not run_one(m_queues.size()))
+                        std::this_thread::yield();
+                }
+                if (b.error)
+                    std::rethrow_exception(b.error);
+            }
+
+        private:
+            using task = std::function<void(void)>;
+
+            /// A task queue, owned by one worker and open to thieves.
+            struct queue
+            {
+                std::mutex mutex;
+                std::deque<task> tasks;
+            };
+
+            /// The chunks of one run_chunks() call.
+            struct batch
+            {
+                std::atomic<std::size_t> remaining;
+                std::mutex error_mutex;
+                std::exception_ptr error;
+
+                explicit batch(std::size_t n) : remaining{n} { /* empty */ }
+
+                template <typename F>
+                void run(F &f, std::size_t lo, std::size_t hi)
+                {
+                    try {
+                        f(lo, hi);
+                    }
+                    catch (...) {
+                        std::lock_guard<std::mutex> lock(error_mutex);
+                        if (not error)
+                            error = std::current_exception();
+                    }
+                    remaining.fetch_sub(1, std::memory_order_acq_rel);
+                }
+            };
+
+            //* Deals a task to the next queue.
+            void push(task t)
+            {
+                queue &q = *m_queues[m_next.fetch_add(1, std::memory_order_relaxed) % m_queues.size()];
+                {
+                    std::lock_guard<std::mutex> lock(q.mutex);
+                    q.tasks.push_back(std::move(t));
+                }
+                m_pending.fetch_add(1, std::memory_order_release);
+            }
+
+            //* Runs one task: the newest of queue self if there is one, else the oldest of another queue.
+            //* self == m_queues.size() means the caller, which owns no queue. Returns whether a task ran.
+            bool run_one(std::size_t self)
+            {
+                task t;
+                if (self < m_queues.size()) {
+                    queue &q = *m_queues[self];
+                    std::lock_guard<std::mutex> lock(q.mutex);
+                    if (not q.tasks.empty()) {
+                        t = std::move(q.tasks.back());
+                        q.tasks.pop_back();
+                    }
+                }
+                for (std::size_t i{1} ; not t and i <= m_queues.size() ; ++i) {
+                    queue &q = *m_queues[(self + i) % m_queues.size()];
+                    std::lock_guard<std::mutex> lock(q.mutex);
+                    if (not q.tasks.empty()) {
+                        t = std::move(q.tasks.front());
+                        q.tasks.pop_front();
+                    }
+                }
+                if (not t)
+                    return false;
+                m_pending.fetch_sub(1, std::memory_order_relaxed);
+                t();
+                return true;
+            }
+
+            //* Worker loop: run tasks while there are any, sleep otherwise.
+            void work(std::size_t self)
+            {
+                while (true) {
+                    if (run_one(self))
+                        continue;
+                    std::unique_lock<std::mutex> lock(m_sleep_mutex);
+                    m_wake.wait(lock, [this] { return m_stop or m_pending.load(std::memory_order_acquire) != 0; });
+                    if (m_stop)
+                        return;
+                }
+            }
+
+            std::vector<std::unique_ptr<queue>> m_queues;   //!< One queue per worker.
+            std::vector<std::thread> m_workers;             //!< The background threads.
+            std::mutex m_sleep_mutex;                       //!< Guards m_stop and the sleeping workers.
+            std::condition_variable m_wake;                 //!< Wakes the workers up when tasks arrive.
+            bool m_stop;                                    //!< Tells the workers to exit.
+            std::atomic<std::size_t> m_pending;             //!< Tasks queued and not taken yet.
+            std::atomic<std::size_t> m_next;                //!< Round-robin cursor over the queues.
+    };
+
+} // namespace sc.
+#endif
@@ -3,34 +3,124 @@
 
 #include <exception>    // std::out_of_range
 #include <iostream>     // std::cout, std::endl
-#include <memory>       // std::unique_ptr
-#include <iterator>     // std::advance, std::begin(), std::end(), std::ostream_iterator
-#include <algorithm>    // std::copy, std::equal, std::fill
+#include <memory>       // std::unique_ptr, std::allocator_traits
+#include <utility>      // std::move, std::forward, std::move_if_noexcept
+#include <iterator>     // std::advance, std::distance, std::iterator_traits, std::begin(), std::end(), std::ostream_iterator, std::make_move_iterator
+#include <algorithm>    // std::copy, std::equal, std::fill, std::rotate
 #include <initializer_list> // std::initializer_list
 #include <cassert>      // assert()
 #include <limits>       // std::numeric_limits<T>
 #include <cstddef>      // std::size_t
 #include <sstream>      // std::ostringstream
+#include <cstring>      // std::memcpy, std::memmove
+#include <type_traits>  // std::is_trivially_copyable, std::integral_constant
+#include <functional>   // std::less
+#include <atomic>       // std::atomic_thread_fence, std::atomic_load, std::atomic_compare_exchange_strong
+
+#include "growth_policy.h" // sc::growth::doubling
+#include "compare.h"       // sc::kernels::equal, sc::kernels::lexicographical_less
+#include "snapshot.h"      // sc::vector_snapshot
+#include "checks.h"        // SC_EXPECTS, SC_EXPECTS_NONEMPTY
 
 /// Sequence container namespace.
 namespace sc {
-    /// Implements tha infrastructure to support a bidirectional iterator.
+    /// Tells whether moving a T to a new address and forgetting the old one is the same as a memcpy.
+    /*!
+     * Containers use this to relocate elements with memcpy/memmove instead of a
+     * move-construct + destroy pair per element. It holds for every trivially
+     * copyable type; specialize it to std::true_type for types that are safe to
+     * relocate bitwise even though they are not trivially copyable.
+     */
+    template <typename T>
+    struct is_trivially_relocatable
+        : std::integral_constant<bool, std::is_trivially_copyable<T>::value> {};
+
+    /// Tells whether the allocator offers `pointer reallocate(pointer p, size_t old_n, size_t new_n)`.
+    /*!
+     * Such an allocator may grow or shrink a block in place (e.g. std::realloc),
+     * which containers use to resize the storage of trivially relocatable elements.
+     */
+    template <typename Allocator>
+    class allocator_can_reallocate
+    {
+        private:
+            using pointer = typename std::allocator_traits<Allocator>::pointer;
+            template <typename A>
+            static auto test(int) -> decltype( std::declval<A&>().reallocate( std::declval<pointer>(), std::size_t{}, std::size_t{} ),
+                                               std::true_type{} );
+            template <typename A>
+            static std::false_type test(...);
+        public:
+            static constexpr bool value = decltype(test<Allocator>(0))::value;
+    };
+
+    /// Turns the Allocator argument of a container into the allocator it actually uses.
+    /*!
+     * Regular allocators are used as they are. A type with a nested
+     * `template <typename T> using allocator_for = ...;` (e.g. sc::aligned<64>)
+     * is a recipe that gets instantiated for the element type, which lets the
+     * user write `sc::vector<float, sc::aligned<64>>`.
+     */
+    template <typename T, typename Allocator>
+    class select_allocator
+    {
+        private:
+            template <typename A>
+            static auto test(int) -> typename A::template allocator_for<T>;
+            template <typename A>
+            static A test(...);
+        public:
+            using type = decltype(test<Allocator>(0));
+    };
+
+    /// The alignment guaranteed for every block returned by the allocator.
+    /*!
+     * It is Allocator::alignment when the allocator declares one (e.g.
+     * sc::aligned_allocator), alignof(value_type) otherwise.
+     */
+    template <typename Allocator>
+    class allocator_alignment
+    {
+        private:
+            using value_type = typename std::allocator_traits<Allocator>::value_type;
+            template <typename A>
+            static constexpr std::size_t get(decltype(A::alignment) *) { return A::alignment; }
+            template <typename A>
+            static constexpr std::size_t get(...) { return alignof(value_type); }
+        public:
+            static constexpr std::size_t value = get<Allocator>(nullptr);
+    };
+
+    /// Implements tha infrastructure to support a random access iterator over contiguous elements.
+    /*!
+     * A thin wrapper around a pointer: every operation is the pointer's, so
+     * the standard algorithms take their random access paths (and, in C++20,
+     * see a contiguous iterator). MyForwardIterator<T> converts implicitly to
+     * MyForwardIterator<const T>, and the two can be compared and subtracted.
+     */
     template <class T>
-    class MyForwardIterator : public std::iterator<std::bidirectional_iterator_tag, T>
+    class MyForwardIterator
     {
         public:
             typedef MyForwardIterator self_type;   //!< Alias to iterator.
             // Below we have the iterator_traits common interface
             typedef std::ptrdiff_t difference_type; //!< Difference type used to calculated distance between iterators.
-            typedef T value_type;           //!< Value type the iterator points to.
+            typedef typename std::remove_cv<T>::type value_type; //!< Value type the iterator points to.
+            typedef T element_type;         //!< The pointee, const-qualified for a const_iterator.
             typedef T* pointer;             //!< Pointer to the value type.
             typedef T& reference;           //!< Reference to the value type.
             typedef const T& const_reference;           //!< Reference to the value type.
-            typedef std::bidirectional_iterator_tag iterator_category; //!< Iterator category.
+            typedef std::random_access_iterator_tag iterator_category; //!< Iterator category.
+#if __cplusplus > 201703L
+            typedef std::contiguous_iterator_tag iterator_concept; //!< The elements are contiguous.
+#endif
 
             // Constructors.
             MyForwardIterator(pointer pt_ = nullptr) : m_ptr{pt_} {} // Regular
             MyForwardIterator(const self_type& other) : m_ptr{other.m_ptr} {} // Copy
+            //* iterator -> const_iterator.
+            template <class U, typename = typename std::enable_if<std::is_same<const U, T>::value and not std::is_const<U>::value>::type>
+            MyForwardIterator(const MyForwardIterator<U>& other) : m_ptr{&other} {}
             self_type& operator=(const self_type& other) { // Assignment Operator
                 m_ptr = other.m_ptr;
                 return *this;
@@ -74,13 +164,24 @@ namespace sc {
             reference operator*(void) const { // (*it);
                 return *m_ptr;
             }
-            pointer operator&(void) const { // &it
+            pointer operator->(void) const { // it->member
                 return m_ptr;
             }
-            difference_type operator-( self_type it ) {
-                return m_ptr - it.m_ptr;
+            reference operator[](difference_type n) const { // it[2]
+                return m_ptr[n];
+            }
+            pointer operator&(void) const { // &it
+                return m_ptr;
             }
             //* Jump operators.
+            self_type& operator+=(difference_type n) { // it += 2
+                m_ptr += n;
+                return *this;
+            }
+            self_type& operator-=(difference_type n) { // it -= 2
+                m_ptr -= n;
+                return *this;
+            }
             friend self_type operator+( difference_type n, self_type it ) { // 2+it
                 return self_type{n + it.m_ptr};
             }
@@ -93,15 +194,22 @@ namespace sc {
             friend self_type operator-( difference_type n, self_type it ) { // 2-it
                 return self_type{n - it.m_ptr};
             }
-            //* Equality/difference operators.
-            bool operator==(const self_type& other) const  { // it1 == it2
-                return m_ptr==other.m_ptr;
+            //* Distance between iterators.
+            friend difference_type operator-( const self_type& a, const self_type& b ) { // it1 - it2
+                return a.m_ptr - b.m_ptr;
             }
-            bool operator!=(const self_type& other) const { // it1 != it2
-                return !(m_ptr==other.m_ptr);
+            //* Equality/difference operators. As friends, an iterator and a const_iterator compare both ways.
+            friend bool operator==( const self_type& a, const self_type& b ) { // it1 == it2
+                return a.m_ptr == b.m_ptr;
             }
-
-
+            friend bool operator!=( const self_type& a, const self_type& b ) { // it1 != it2
+                return a.m_ptr != b.m_ptr;
+            }
+            //* Ordering operators.
+            friend bool operator<( const self_type& a, const self_type& b ) { return a.m_ptr < b.m_ptr; }
+            friend bool operator>( const self_type& a, const self_type& b ) { return a.m_ptr > b.m_ptr; }
+            friend bool operator<=( const self_type& a, const self_type& b ) { return a.m_ptr <= b.m_ptr; }
+            friend bool operator>=( const self_type& a, const self_type& b ) { return a.m_ptr >= b.m_ptr; }
 
         private:
             pointer m_ptr; //!< The raw pointer.
@@ -117,81 +225,172 @@ namespace sc {
      * This means that a pointer to an element of a vector may be passed to
      * any function that expects a pointer to an element of an array.
      *
+     * The storage area is obtained from the allocator as raw memory: only the
+     * slots in [0, size()) hold live objects, the slots in [size(), capacity())
+     * are uninitialized and are constructed only when an element is added.
+     *
      * \tparam T The type of the elements.
+     * \tparam Allocator The allocator used to acquire/release memory and to construct/destroy the elements,
+     *                   or a recipe such as sc::aligned<64> (see select_allocator).
+     * \tparam GrowthPolicy How the capacity grows when an insertion runs out of room (see growth_policy.h).
      */
-    template <typename T>
+    template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = growth::doubling>
     class vector
     {
         //=== Aliases
         public:
             using size_type = unsigned long; //!< The size type.
             using value_type = T;            //!< The value type.
+            using allocator_type = typename select_allocator<T, Allocator>::type; //!< The allocator type.
+            using growth_policy = GrowthPolicy; //!< The growth policy type.
             using pointer = value_type*;     //!< Pointer to a value stored in the container.
+            using const_pointer = const value_type*; //!< Const pointer to a value stored in the container.
             using reference = value_type&;   //!< Reference to a value stored in the container.
             using const_reference = const value_type&; //!< Const reference to a value stored in the container.
 
             using iterator = MyForwardIterator<value_type>; //!< The iterator, instantiated from a template class.
             using const_iterator = MyForwardIterator<const value_type>; //!< The const_iterator, instantiated from a template class.
+            using snapshot_type = vector_snapshot<T, allocator_type>; //!< Immutable, shared view of the contents.
+
+            //* Alignment, in bytes, of data() whenever the vector holds memory. Kernels may assume it.
+            static constexpr std::size_t alignment = allocator_alignment<allocator_type>::value;
+
+        private:
+            using alloc_traits = std::allocator_traits<allocator_type>; //!< Uniform interface to the allocator.
 
         public:
             //!=== [I] Special members
-			//* (1)/(2) Main constructor that initializes the vector with the requested capacity.
-            explicit vector(size_type new_cap = 0)
-				: m_capacity{new_cap},
-				  m_end{new_cap},
-				  m_storage{new T[m_capacity]}
-			{
-                // Let us fill the vector with instances of default-initialized objects.
-                std::fill(m_storage, m_storage+m_capacity, T{});
+            //* (1) Default constructor, creates an empty vector without allocating memory.
+            vector(void)
+                : m_end{0},
+                  m_capacity{0},
+                  m_storage{nullptr},
+                  m_alloc{}
+            { /* empty */ }
+
+            //* (1) Creates an empty vector that uses a copy of the given allocator.
+            explicit vector(const allocator_type &alloc)
+                : m_end{0},
+                  m_capacity{0},
+                  m_storage{nullptr},
+                  m_alloc{alloc}
+            { /* empty */ }
+
+            //* (2) Main constructor that initializes the vector with new_cap value-initialized elements.
+            explicit vector(size_type new_cap, const allocator_type &alloc = allocator_type())
+                : m_end{0},
+                  m_capacity{new_cap},
+                  m_alloc{alloc}
+            {
+                m_storage = allocate(m_capacity);
+                // Let us fill the vector with instances of value-initialized objects.
+                try {
+                    for ( /*empty*/ ; m_end < new_cap ; ++m_end)
+                        alloc_traits::construct(m_alloc, m_storage + m_end);
+                }
+                catch (...) {
+                    release();
+                    throw;
+                }
             }
 
             //* (3) Main constructor that initializes the vector with the contents of a range [first, last).
             template <typename InputItr>
-            vector(InputItr first, InputItr last) {
+            vector(InputItr first, InputItr last, const allocator_type &alloc = allocator_type())
+                : m_end{0},
+                  m_capacity{0},
+                  m_storage{nullptr},
+                  m_alloc{alloc}
+            {
                 size_type sz = last - first;
+                m_storage = allocate(sz);
                 m_capacity = sz;
-                m_end = sz;
-                m_storage = new T[m_capacity];
 
                 // Copy all elements from the range to the vector.
-                std::copy(first, last, this->begin());
+                construct_range(unwrap(first), unwrap(last));
             }
 
             //* (4) Copy constructor. Construct the vector from another vector by copying the elements.
             vector(const vector &other)
-                : m_capacity{other.m_capacity},
-                  m_end{other.m_end},
-                  m_storage{new T[m_capacity]}
+                : m_end{0},
+                  m_capacity{other.m_capacity},
+                  m_alloc{alloc_traits::select_on_container_copy_construction(other.m_alloc)}
             {
-                // Let us fill the array with instances of default-initialized objects.
-                std::copy(other.cbegin(), other.cend(), this->begin());
+                m_storage = allocate(m_capacity);
+                construct_range(other.m_storage, other.m_storage + other.m_end);
+            }
+
+            //* (4) Move constructor. Steals the storage area of other, which is left empty.
+            vector(vector &&other) noexcept
+                : m_end{other.m_end},
+                  m_capacity{other.m_capacity},
+                  m_storage{other.m_storage},
+                  m_alloc{std::move(other.m_alloc)},
+                  m_snapshot{std::move(other.m_snapshot)}
+            {
+                other.m_storage = nullptr;
+                other.m_end = other.m_capacity = 0;
             }
 
             //* (5) Main constructor that initializes the vector from an initializer list.
-            vector(const std::initializer_list<T> &il)
-                : m_capacity{ il.size() },
-                  m_end { il.size() },
-                  m_storage{new T[m_capacity]}
+            vector(const std::initializer_list<T> &il, const allocator_type &alloc = allocator_type())
+                : m_end{0},
+                  m_capacity{il.size()},
+                  m_alloc{alloc}
             {
+                m_storage = allocate(m_capacity);
                 // Copy all elements from the initializer list into the vector storage area.
-                std::copy(il.begin(), il.end(), m_storage);
+                construct_range(il.begin(), il.end());
             }
-            
+
             //* (6) Destructor of the vector.
-            virtual ~vector(void) { delete[] m_storage; }
+            virtual ~vector(void) { release(); }
 
             //* (7) Copy assignment operator. Replaces the contents with a copy of the contents of other.
             vector &operator=(const vector &other)
             {
                 if (this != &other) {
-                    if (m_capacity < other.m_end) {
-                        delete[] m_storage;
-                        m_storage = new T[other.m_end];
+                    unshare();
+                    if (alloc_traits::propagate_on_container_copy_assignment::value and m_alloc != other.m_alloc) {
+                        // The memory we hold can not be released by the incoming allocator.
+                        release();
+                        m_storage = nullptr;
+                        m_end = m_capacity = 0;
                     }
-                    // Copy all elements from the initializer list into the vector storage area.
-                    std::copy(other.m_storage, other.m_storage + other.m_end, m_storage);
+                    if (alloc_traits::propagate_on_container_copy_assignment::value)
+                        m_alloc = other.m_alloc;
+                    // Copy all elements from the other vector into the vector storage area.
+                    assign_range(other.m_storage, other.m_end);
+                }
+
+                return *this;
+            }
+
+            //* (7) Move assignment operator. Replaces the contents with those of other using move semantics.
+            vector &operator=(vector &&other)
+                noexcept(alloc_traits::propagate_on_container_move_assignment::value)
+            {
+                if (this == &other)
+                    return *this;
+                if (alloc_traits::propagate_on_container_move_assignment::value or m_alloc == other.m_alloc) {
+                    // The storage can change hands.
+                    release();
+                    if (alloc_traits::propagate_on_container_move_assignment::value)
+                        m_alloc = std::move(other.m_alloc);
+                    m_storage = other.m_storage;
+                    m_end = other.m_end;
+                    m_capacity = other.m_capacity;
+                    m_snapshot = std::move(other.m_snapshot);
+                    other.m_storage = nullptr;
+                    other.m_end = other.m_capacity = 0;
+                }
+                else {
+                    // Our allocator can not free other's memory: move the elements one by one.
+                    unshare();
+                    other.unshare();
+                    assign_range(std::make_move_iterator(other.m_storage), other.m_end);
+                    other.clear();
                 }
-                m_capacity = m_end = other.m_end;
 
                 return *this;
             }
@@ -199,30 +398,31 @@ namespace sc {
             //* (8) Replaces the contents with those identified by initializer list ilist.
             vector &operator=(std::initializer_list<T> il)
             {
-                if (m_capacity < il.size()) {
-                    delete[] m_storage;
-                    m_storage = new T[il.size()];
-                }
+                unshare();
                 // Copy all elements from the initializer list into the vector storage area.
-                std::copy(il.begin(), il.end(), m_storage);
-                m_capacity = m_end = il.size();
+                assign_range(il.begin(), il.size());
 
                 return *this;
             }
 
+            //* Returns a copy of the allocator associated with the vector.
+            allocator_type get_allocator(void) const { return m_alloc; }
+
             //!=== [II] Iterators
             //? Conferir se o elemento existe.
             //* An iterator pointing to the first item in the list.
-            iterator begin(void) { return iterator(&m_storage[0]); }
+            iterator begin(void) { unshare(); return iterator(&m_storage[0]); }
 
             //* A constant iterator pointing to the first item in the list.
             const_iterator cbegin(void) const { return const_iterator(&m_storage[0]); }
+            const_iterator begin(void) const { return cbegin(); }
 
             //* An iterator pointing to the position just after the last element of the list.
-            iterator end(void) { return iterator(&m_storage[m_end]); }
+            iterator end(void) { unshare(); return iterator(&m_storage[m_end]); }
 
             //* A constant iterator pointing to the position just after the last element of the list.
             const_iterator cend(void) const { return const_iterator(&m_storage[m_end]); }
+            const_iterator end(void) const { return cend(); }
 
             //!=== [III] Capacity
             //* Check the size of the vector.
@@ -233,239 +433,101 @@ namespace sc {
 
             //* Check if the vector is empty, that is, there are no elements.
             bool empty(void) const { return m_end == 0; }
-            
+
             //!=== [IV] Modifiers
-            //* Removes all elements from the container.
-            void clear(void) { m_end = 0; }
+            //* Removes all elements from the container. The capacity is left unchanged.
+            void clear(void)
+            {
+                if (m_snapshot and not reclaim()) {
+                    // The snapshots keep the elements: start over on an empty buffer of the same capacity,
+                    // allocated before letting go of the shared one so that a throw leaves *this intact.
+                    pointer fresh{allocate(m_capacity)};
+                    m_snapshot.reset();
+                    m_storage = fresh;
+                    m_end = 0;
+                    return;
+                }
+                destroy_range(0, m_end);
+                m_end = 0;
+            }
 
             //* Adds value to the end of the list.
-            void push_back(const_reference value)
+            void push_back(const_reference value) { emplace_back(value); }
+
+            //* Adds value to the end of the list, moving it into the vector.
+            void push_back(value_type &&value) { emplace_back(std::move(value)); }
+
+            //* Constructs a new element in place at the end of the list from args.
+            template <typename... Args>
+            void emplace_back(Args&&... args)
             {
+                unshare();
                 // Verify if has space for a new element.
                 if (full())  {
-                    size_type new_capacity{m_capacity};
-                    if (m_capacity == 0) new_capacity++;
-                    else new_capacity *= 2;
-                    reserve(new_capacity);
+                    grow_and_emplace_back(next_capacity(m_end + 1), reallocates_in_place{}, std::forward<Args>(args)...);
+                }
+                else {
+                    // Realize the insertion.
+                    alloc_traits::construct(m_alloc, m_storage + m_end, std::forward<Args>(args)...);
                 }
-                // Realize the insertion.
-                m_storage[m_end] = value;
                 m_end++;
             }
-            
+
             //* Removes the object at the end of the list.
-            void pop_back(void) 
-            { 
-                // Verify if has space for a new element.
-                if (empty())
-                    throw std::length_error("[vector::pop_back()]: Can not remove an element from an empty vector.");
+            void pop_back(void)
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[vector::pop_back()]: Can not remove an element from an empty vector.");
+                unshare();
                 // Remove the element of the range.
                 m_end--;
+                alloc_traits::destroy(m_alloc, m_storage + m_end);
             }
 
+            //* Inserts value before pos.
             iterator insert( iterator pos_ , const_reference value_ ) {
-                auto position = pos_ - begin();
-                // Verify if has space for a new element.
-                if (full())  {
-                    size_type new_capacity{m_capacity};
-                    if (m_capacity == 0) new_capacity++;
-                    else new_capacity *= 2;
-                    reserve(new_capacity);
-                }
-                auto old_m_end = m_end;
-                m_end++;
-
-                auto old_element = old_m_end - 1;
-                auto new_element = m_end - 1;
-                while (old_element >= position) {
-                    m_storage[new_element] = m_storage[old_element];
-                    if (old_element != 0) {
-                        new_element--;
-                        old_element--;
-                    }
-                    else {
-                        break;
-                    }
-                }
-
-                m_storage[position] = value_;
-                
-                return iterator(this->begin() + position);
+                return insert_value(index_of(pos_), value_);
             }
 
             iterator insert( const_iterator pos_ , const_reference value_ ) {
-                auto position = pos_ - begin();
-                // Verify if has space for a new element.
-                if (full())  {
-                    size_type new_capacity{m_capacity};
-                    if (m_capacity == 0) new_capacity++;
-                    else new_capacity *= 2;
-                    reserve(new_capacity);
-                }
-                auto old_m_end = m_end;
-                m_end++;
+                return insert_value(index_of(pos_), value_);
+            }
 
-                auto old_element = old_m_end - 1;
-                auto new_element = m_end - 1;
-                while (old_element >= position) {
-                    m_storage[new_element] = m_storage[old_element];
-                    if (old_element != 0) {
-                        new_element--;
-                        old_element--;
-                    }
-                    else {
-                        break;
-                    }
-                }
+            //* Inserts value before pos, moving it into the vector.
+            iterator insert( iterator pos_ , value_type &&value_ ) {
+                return insert_value(index_of(pos_), std::move(value_));
+            }
 
-                m_storage[position] = value_;
-                
-                return iterator(this->begin() + position);
+            iterator insert( const_iterator pos_ , value_type &&value_ ) {
+                return insert_value(index_of(pos_), std::move(value_));
             }
 
+            //* Inserts the elements of the range [first, last) before pos. Single-pass input iterators are accepted.
             template <typename InputItr>
             iterator insert( iterator pos_ , InputItr first_, InputItr last_ ) {
-                auto size_range = last_ - first_;
-                auto position = pos_ - begin();
-                if (capacity() + size_range > m_capacity) {
-                    size_type new_capacity{m_capacity + size_range};
-                    new_capacity *= 2;
-                    reserve(new_capacity);
-                }
-                auto old_m_end = m_end;
-                m_end += size_range;
-
-                auto old_element = old_m_end - 1;
-                auto new_element = m_end - 1;
-                while (old_element >= position) {
-                    m_storage[new_element] = m_storage[old_element];
-                    if (old_element != 0) {
-                        new_element--;
-                        old_element--;
-                    }
-                    else {
-                        break;
-                    }
-                }
-
-                for (auto i{position}; i < (position + size_range); i++) {
-                    m_storage[i] = *first_;
-                    first_++;
-                }
-                
-                return iterator(this->begin() + position);
+                return insert_range(index_of(pos_), first_, last_, typename std::iterator_traits<InputItr>::iterator_category{});
             }
 
             template <typename InputItr>
             iterator insert( const_iterator pos_ , InputItr first_, InputItr last_ ) {
-                auto size_range = last_ - first_;
-                auto position = pos_ - begin();
-                if (capacity() + size_range > m_capacity) {
-                    size_type new_capacity{m_capacity + size_range};
-                    new_capacity *= 2;
-                    reserve(new_capacity);
-                }
-                auto old_m_end = m_end;
-                m_end += size_range;
-
-                auto old_element = old_m_end - 1;
-                auto new_element = m_end - 1;
-                while (old_element >= position) {
-                    m_storage[new_element] = m_storage[old_element];
-                    if (old_element != 0) {
-                        new_element--;
-                        old_element--;
-                    }
-                    else {
-                        break;
-                    }
-                }
-
-                for (auto i{position}; i < (position + size_range); i++) {
-                    m_storage[i] = *first_;
-                    first_++;
-                }
-                
-                return iterator(this->begin() + position);
+                return insert_range(index_of(pos_), first_, last_, typename std::iterator_traits<InputItr>::iterator_category{});
             }
 
+            //* Inserts the elements of the initializer list before pos.
             iterator insert( iterator pos_, const std::initializer_list< value_type >& ilist_ ) {
-                auto size_list = ilist_.size();
-                auto position = pos_ - begin();
-                if (capacity() + size_list > m_capacity) {
-                    size_type new_capacity{m_capacity + size_list};
-                    new_capacity *= 2;
-                    reserve(new_capacity);
-                }
-                auto old_m_end = m_end;
-                m_end += size_list;
-
-                auto old_element = old_m_end - 1;
-                auto new_element = m_end - 1;
-                while (old_element >= position) {
-                    m_storage[new_element] = m_storage[old_element];
-                    if (old_element != 0) {
-                        new_element--;
-                        old_element--;
-                    }
-                    else {
-                        break;
-                    }
-                }
-
-                auto list_element = ilist_.begin();
-                for (auto i{position}; i < (position + size_list); i++) {
-                    m_storage[i] = *list_element;
-                    list_element++;
-                }
-                
-                return iterator(this->begin() + position);
+                return insert_range(index_of(pos_), ilist_.begin(), ilist_.size());
             }
 
             iterator insert( const_iterator pos_, const std::initializer_list< value_type >& ilist_ ) {
-                auto size_list = ilist_.size();
-                auto position = pos_ - begin();
-                if (capacity() + size_list > m_capacity) {
-                    size_type new_capacity{m_capacity + size_list};
-                    new_capacity *= 2;
-                    reserve(new_capacity);
-                }
-                auto old_m_end = m_end;
-                m_end += size_list;
-
-                auto old_element = old_m_end - 1;
-                auto new_element = m_end - 1;
-                while (old_element >= position) {
-                    m_storage[new_element] = m_storage[old_element];
-                    if (old_element != 0) {
-                        new_element--;
-                        old_element--;
-                    }
-                    else {
-                        break;
-                    }
-                }
-
-                auto list_element = ilist_.begin();
-                for (auto i{position}; i < (position + size_list); i++) {
-                    m_storage[i] = *list_element;
-                    list_element++;
-                }
-                
-                return iterator(this->begin() + position);
+                return insert_range(index_of(pos_), ilist_.begin(), ilist_.size());
             }
 
             //* The storage will have a capacity equal to cap_ if cap_ > m_capacity.
             void reserve(size_type cap_)
             {
                 if (cap_ > m_capacity) {
+                    unshare();
                     // Realloc the storage.
-                    T *newVec{new T[cap_]};
-                    std:copy(this->begin(), this->end(), newVec);
-                    // Update storage attributes.
-                    delete[] m_storage;
-                    m_storage = newVec;
-                    m_capacity = cap_;
+                    resize_storage(cap_, reallocates_in_place{});
                 }
             }
 
@@ -473,12 +535,8 @@ namespace sc {
             void shrink_to_fit(void)
             {
                 if (m_end < m_capacity) {
-                    T *newVec{new T[m_end]};
-                    std:copy(this->begin(), this->end(), newVec);
-                    // Update storage.
-                    delete[] m_storage;
-                    m_storage = newVec;
-                    m_capacity = m_end;
+                    unshare();
+                    resize_storage(m_end, reallocates_in_place{});
                 }
             }
 
@@ -486,96 +544,58 @@ namespace sc {
             //* Replaces the content of the vector with count copies of value.
             void assign(size_type count_, const_reference value_)
             {
+                unshare();
                 if (m_capacity < count_) {
-                    T *newVec{new T[count_]};
-                    // Update storage.
-                    delete[] m_storage;
-                    m_storage = newVec;
-                    m_capacity = count_;
+                    // value_ may live in the old storage, which rebuild() keeps until the end.
+                    rebuild(count_, [&](pointer slot) { alloc_traits::construct(m_alloc, slot, value_); });
+                    return;
                 }
+                // Set elements into the vector, counting each new one in m_end so that a throw leaks nothing.
+                size_type i{0};
+                for ( /*empty*/ ; i < count_ and i < m_end ; ++i)
+                    m_storage[i] = value_;
+                for ( /*empty*/ ; i < count_ ; ++i, ++m_end)
+                    alloc_traits::construct(m_alloc, m_storage + i, value_);
+                destroy_range(count_, m_end);
                 // Update size.
                 m_end = count_;
-                // Set elements into the vector.
-                std::fill(this->begin(), this->end(), value_);
             }
 
             //* Replaces the content of the vector with copy of the initializer list.
             void assign(const std::initializer_list<T>& il)
             {
-                if (m_capacity < il.size()) {
-                    T *newVec{new T[il.size()]};
-                    // Update storage.
-                    delete[] m_storage;
-                    m_storage = newVec;
-                    m_capacity = il.size();
-                }
                 // Copy all elements from the initializer list into the vector storage area.
-                std::copy(il.begin(), il.end(), m_storage);
-                // Update size.
-                m_end = il.size();
+                assign_range(il.begin(), il.size());
             }
 
             //* Replaces the content of the vector with copy of a range.
             template <typename InputItr>
             void assign(InputItr first, InputItr last)
             {
-                size_type sz = last - first;
-                if (m_capacity < sz) {
-                    T *newVec{new T[sz]};
-                    // Update storage.
-                    delete[] m_storage;
-                    m_storage = newVec;
-                    m_capacity = sz;
-                }
                 // Copy all elements from the range into the vector storage area.
-                std::copy(first, last, m_storage);
-                // Update size.
-                m_end = sz;
+                assign_range(unwrap(first), last - first);
             }
 
 
             iterator erase(const_iterator first, const_iterator last) {
-                const_iterator old_pos{last};
-                const_iterator new_pos{first};
-                while (old_pos != end()) {
-                    std::swap(*new_pos, *old_pos);
-                    old_pos++;
-                    new_pos++;
-                }
-                m_end -= std::distance( first, last );
-                return first;
+                size_type position{index_of(first)};
+                SC_EXPECTS(&first <= &last and &last <= m_storage + m_end, std::out_of_range,
+                           "[vector::erase()]: range provided is out of vector range");
+                return erase_range(position, &last - m_storage);
             };
 
             iterator erase(iterator first, iterator last) {
-                iterator old_pos{last};
-                iterator new_pos{first};
-                while (old_pos != end()) {
-                    std::swap(*new_pos, *old_pos);
-                    old_pos++;
-                    new_pos++;
-                }
-                m_end -= std::distance( first, last );
-                return first;
+                return erase(const_iterator(first), const_iterator(last));
             };
 
             iterator erase(const_iterator pos) {
-                const_iterator i{pos};
-                while (i != end()-1) {
-                    std::swap(*i, *(i+1));
-                    i++;
-                }
-                m_end--;
-                return pos;
+                size_type position{index_of(pos)};
+                SC_EXPECTS(position < m_end, std::out_of_range, "[vector::erase()]: position provided is out of vector range");
+                return erase_range(position, position + 1);
             }
 
             iterator erase(iterator pos) {
-                iterator i{pos};
-                while (i != end()-1) {
-                    std::swap(*i, *(i+1));
-                    i++;
-                }
-                m_end--;
-                return pos;
+                return erase(const_iterator(pos));
             };
 
             //!=== [V] Element access
@@ -583,8 +603,7 @@ namespace sc {
             const_reference back(void) const 
             {
                 // I can not return an element of an empty vector.
-                if (empty())
-                    throw std::length_error("[vector::back()]: empty vector.");
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[vector::back()]: empty vector.");
                 // There is at least one element in the vector.
                 return m_storage[m_end - 1];
             }
@@ -593,24 +612,43 @@ namespace sc {
             const_reference front(void) const 
             {
                 // I can not return an element of an empty vector.
-                if (empty())
-                    throw std::length_error("[vector::front()]: empty vector.");
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[vector::front()]: empty vector.");
                 // There is at least one element in the vector.
                 return m_storage[0];
             }
 
             //* Returns a reference of the element at the end of the list.
-            reference back(void) { return m_storage[m_end - 1]; }
+            reference back(void)
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[vector::back()]: empty vector.");
+                unshare();
+                return m_storage[m_end - 1];
+            }
 
             //* Returns a reference of the element at the beginning of the list.
-            reference front(void) { return m_storage[0]; }
+            reference front(void)
+            {
+                SC_EXPECTS_NONEMPTY(not empty(), std::length_error, "[vector::front()]: empty vector.");
+                unshare();
+                return m_storage[0];
+            }
 
-            //* Access the element in the position pos, just to read.
-            const_reference operator[](size_type pos) const { return m_storage[pos]; }
+            //* Access the element in the position pos, just to read. Checked according to SC_BOUNDS_CHECK.
+            const_reference operator[](size_type pos) const
+            {
+                SC_EXPECTS(pos < m_end, std::out_of_range, "[vector::operator[]]: position provided is out of vector range");
+                return m_storage[pos];
+            }
 
             //* Access the element in the position pos, can change the value.
+            //* For hot indexed loops, index data() instead: it unshares once for the whole loop.
             // A[i] = x; // A.operator[](i);
-            reference operator[](size_type pos) { return m_storage[pos]; }
+            reference operator[](size_type pos)
+            {
+                SC_EXPECTS(pos < m_end, std::out_of_range, "[vector::operator[]]: position provided is out of vector range");
+                unshare();
+                return m_storage[pos];
+            }
 
             //* Returns the value at the index pos_ in the vector, with bounds-checking.
             //* Just to read the value.
@@ -629,24 +667,27 @@ namespace sc {
                 if (pos < 0 or pos >= m_end)
                     throw std::out_of_range(
                         "[T array::at(pos)]: position provided is out of vector range");
+                unshare();
                 return m_storage[pos];
             }
 
             //!=== [VII] Friend functions
-            friend std::ostream & operator<<(std::ostream & os_, const vector<T> & v_)
+            friend std::ostream & operator<<(std::ostream & os_, const vector & v_)
             {
                 // What do I want to print???
+                // The slots past m_end are raw memory, so we only mark them with a '_'.
                 os_ << "{ ";
-                for( auto i{0u} ; i < v_.m_capacity ; ++i )
+                for( auto i{0ul} ; i < v_.m_capacity ; ++i )
                 {
                     if ( i == v_.m_end ) os_ << "| ";
-                    os_ << v_.m_storage[ i ] << " ";
+                    if ( i < v_.m_end ) os_ << v_.m_storage[ i ] << " ";
+                    else os_ << "_ ";
                 }
                 os_ << "}, m_end=" << v_.m_end << ", m_capacity=" << v_.m_capacity;
 
                 return os_;
             }
-            friend void swap( vector<T> & first_, vector<T> & second_ )
+            friend void swap( vector & first_, vector & second_ )
             {
                 // enable ADL
                 using std::swap;
@@ -655,6 +696,9 @@ namespace sc {
                 swap( first_.m_end,      second_.m_end      );
                 swap( first_.m_capacity, second_.m_capacity );
                 swap( first_.m_storage,  second_.m_storage  );
+                swap( first_.m_snapshot, second_.m_snapshot );
+                if ( alloc_traits::propagate_on_container_swap::value )
+                    swap( first_.m_alloc, second_.m_alloc );
             }
 
             //======================================================================
@@ -669,8 +713,9 @@ namespace sc {
                 for ( /*empty*/ ; i < m_end ; ++i )
                     oss << m_storage[i] << " ";
                 oss << "| ";
+                // Unused slots are not constructed, there is nothing to print there.
                 for ( /*empty*/ ; i < m_capacity ; ++i )
-                    oss << m_storage[i] << " ";
+                    oss << "_ ";
                 oss << "], end = " << m_end << ", capacity = " << m_capacity;
 
                 // [ 1 2 3 ]
@@ -678,41 +723,541 @@ namespace sc {
             }
             
             //* For debugging purposes, if you are using std::unique_ptr.
-            pointer data(void) { return m_storage; };
-            const_reference data(void) const { return m_storage; };
+            pointer data(void) { unshare(); return m_storage; };
+            const_pointer data(void) const { return m_storage; };
+
+            //!=== [VIII] Snapshots
+            //* An immutable view of the current contents, in O(1): the buffer becomes shared, and the
+            //* next call that may change the vector (any modifier, and the non-const begin(), end(),
+            //* data(), operator[], at(), front() and back()) copies it if a snapshot is still alive.
+            //* Iterators, pointers and references taken before the snapshot must not be used to
+            //* write afterwards. Like the other const members, it may be called from several
+            //* threads at once on a vector that nobody changes meanwhile: the first call publishes
+            //* the shared block with an atomic compare-exchange, the others load it.
+            snapshot_type snapshot(void) const
+            {
+                static_assert(std::is_copy_constructible<T>::value, "[vector::snapshot()]: The elements must be copyable.");
+                auto shared = std::atomic_load(&m_snapshot);
+                if (not shared) {
+                    auto fresh = std::make_shared<snapshot_detail::block<T, allocator_type>>(m_storage, m_end, m_capacity, m_alloc);
+                    if (std::atomic_compare_exchange_strong(&m_snapshot, &shared, fresh))
+                        shared = std::move(fresh);
+                    else
+                        fresh->storage = nullptr; // Another thread published first: the buffer is not ours to free.
+                }
+                return snapshot_type(std::move(shared));
+            }
 
         private:
+            //* Elements may be moved around with memcpy/memmove.
+            using relocatable = std::integral_constant<bool, is_trivially_relocatable<T>::value>;
+            //* The storage may be resized through allocator_type::reallocate().
+            using reallocates_in_place = std::integral_constant<bool, relocatable::value and allocator_can_reallocate<allocator_type>::value>;
+            //* Copies from a range of InputItr may be done with memcpy/memmove.
+            template <typename InputItr>
+            using bitwise_copyable = std::integral_constant<bool, std::is_trivially_copyable<T>::value and
+                                                                  (std::is_same<InputItr, T*>::value or std::is_same<InputItr, const T*>::value)>;
+
+            //* Index of pos, which must be in [begin(), end()]. Checked according to SC_BOUNDS_CHECK.
+            size_type index_of(const_iterator pos) const
+            {
+                SC_EXPECTS(m_storage <= &pos and &pos <= m_storage + m_end, std::out_of_range,
+                           "[vector]: iterator provided is out of vector range");
+                return static_cast<size_type>(&pos - m_storage);
+            }
+
+            //* The pointer behind an iterator over contiguous elements, so that copies from it take the memcpy paths.
+            template <typename U>
+            static U *unwrap(MyForwardIterator<U> it) { return &it; }
+
+            //* Any other iterator is used as it is.
+            template <typename It>
+            static It unwrap(It it) { return it; }
+
+            //* Makes the storage private again before it changes. A single branch when there is no snapshot.
+            void unshare(void)
+            {
+                if (m_snapshot)
+                    detach();
+            }
+
+            //* Takes the storage back if no snapshot holds it any more. Returns whether it did.
+            bool reclaim(void)
+            {
+                if (m_snapshot.use_count() != 1)
+                    return false;
+                // Pairs with the release decrement of the last snapshot: its reads are done.
+                std::atomic_thread_fence(std::memory_order_acquire);
+                m_snapshot->storage = nullptr;
+                m_snapshot.reset();
+                return true;
+            }
+
+            //* Goes on with a private copy of the elements, leaving the shared buffer to the snapshots.
+            void detach(void)
+            {
+                if (reclaim())
+                    return;
+                pointer copy{allocate(m_capacity)};
+                detach_into(copy, std::integral_constant<int, bitwise_copyable<const_pointer>::value ? 2 :
+                                                              std::is_copy_constructible<T>::value ? 1 : 0>{});
+                m_storage = copy;
+                m_snapshot.reset();
+            }
+
+            //* Fast path: one memcpy.
+            void detach_into(pointer copy, std::integral_constant<int, 2>)
+            {
+                if (m_end != 0)
+                    std::memcpy(copy, m_storage, m_end * sizeof(T));
+            }
+
+            //* Move-only elements: snapshot() does not compile for them, so there is never a buffer to copy.
+            void detach_into(pointer, std::integral_constant<int, 0>) { /* empty */ }
+
+            void detach_into(pointer copy, std::integral_constant<int, 1>)
+            {
+                size_type i{0};
+                try {
+                    for ( /*empty*/ ; i < m_end ; ++i)
+                        alloc_traits::construct(m_alloc, copy + i, m_storage[i]);
+                }
+                catch (...) {
+                    for (size_type j{0} ; j < i ; ++j)
+                        alloc_traits::destroy(m_alloc, copy + j);
+                    deallocate(copy, m_capacity);
+                    throw;
+                }
+            }
+
             //* Check if the maximum capacity has been reached.
             bool full(void) const { return m_end == m_capacity; }
 
+            //* The capacity to grow to when an insertion needs room for required elements.
+            size_type next_capacity(size_type required) const
+            {
+                size_type proposed = growth_policy::grow(m_capacity, required, sizeof(T));
+                return proposed < required ? required : proposed;
+            }
+
+            //* Requests raw memory for n elements. No element is constructed.
+            pointer allocate(size_type n)
+            {
+                return n == 0 ? nullptr : alloc_traits::allocate(m_alloc, n);
+            }
+
+            //* Gives back to the allocator the raw memory acquired with allocate(n).
+            void deallocate(pointer p, size_type n)
+            {
+                if (p != nullptr) alloc_traits::deallocate(m_alloc, p, n);
+            }
+
+            //* Destroys the live elements in [first, last).
+            void destroy_range(size_type first, size_type last)
+            {
+                for ( /*empty*/ ; first < last ; ++first)
+                    alloc_traits::destroy(m_alloc, m_storage + first);
+            }
+
+            //* Destroys every element and gives the storage back. Members are left dangling.
+            //* A storage still held by snapshots is left to them.
+            void release(void)
+            {
+                if (m_snapshot and not reclaim()) {
+                    m_snapshot.reset();
+                    return;
+                }
+                destroy_range(0, m_end);
+                deallocate(m_storage, m_capacity);
+            }
+
+            //* Replaces the storage with a buffer of exactly count elements, each built by make(slot).
+            //* The old buffer is released only once every element is built: if the allocation or
+            //* an element throws, *this is left untouched.
+            template <typename Make>
+            void rebuild(size_type count, Make make)
+            {
+                pointer new_storage{allocate(count)};
+                size_type built{0};
+                try {
+                    for ( /*empty*/ ; built < count ; ++built)
+                        make(new_storage + built);
+                }
+                catch (...) {
+                    while (built > 0)
+                        alloc_traits::destroy(m_alloc, new_storage + --built);
+                    deallocate(new_storage, count);
+                    throw;
+                }
+                release();
+                m_storage = new_storage;
+                m_end = m_capacity = count;
+            }
+
+            //* Copy-constructs [first, last) into the raw slots starting at m_end, growing m_end.
+            //* If a copy throws, the elements built so far are destroyed and the storage released:
+            //* only for constructors, where no destructor runs afterwards.
+            template <typename InputItr>
+            void construct_range(InputItr first, InputItr last)
+            {
+                construct_range(first, last, bitwise_copyable<InputItr>{});
+            }
+
+            //* Fast path: a single memcpy from a contiguous range of trivially copyable elements.
+            template <typename InputItr>
+            void construct_range(InputItr first, InputItr last, std::true_type)
+            {
+                if (first != last)
+                    std::memcpy(m_storage + m_end, first, (last - first) * sizeof(T));
+                m_end += last - first;
+            }
+
+            template <typename InputItr>
+            void construct_range(InputItr first, InputItr last, std::false_type)
+            {
+                try {
+                    for ( /*empty*/ ; first != last ; ++first, ++m_end)
+                        alloc_traits::construct(m_alloc, m_storage + m_end, *first);
+                }
+                catch (...) {
+                    release();
+                    throw;
+                }
+            }
+
+            //* Moves the live elements into new_storage (capacity new_cap) and frees the old buffer.
+            //* Elements from index gap_at on land gap slots further, leaving room for elements the caller
+            //* has already built in new_storage; those are destroyed too if the relocation fails.
+            void relocate_to(pointer new_storage, size_type new_cap, size_type gap_at = 0, size_type gap = 0)
+            {
+                relocate_to(new_storage, new_cap, gap_at, gap, relocatable{});
+            }
+
+            //* Fast path: the buffer is relocated with (at most) two memcpy, nothing is left to destroy.
+            void relocate_to(pointer new_storage, size_type new_cap, size_type gap_at, size_type gap, std::true_type)
+            {
+                if (gap_at != 0)
+                    std::memcpy(new_storage, m_storage, gap_at * sizeof(T));
+                if (gap_at != m_end)
+                    std::memcpy(new_storage + gap_at + gap, m_storage + gap_at, (m_end - gap_at) * sizeof(T));
+                deallocate(m_storage, m_capacity);
+                m_storage = new_storage;
+                m_capacity = new_cap;
+            }
+
+            //* Elements are copied instead if their move constructor may throw, so a failure leaves *this intact.
+            void relocate_to(pointer new_storage, size_type new_cap, size_type gap_at, size_type gap, std::false_type)
+            {
+                size_type i{0};
+                try {
+                    for ( /*empty*/ ; i < m_end ; ++i)
+                        alloc_traits::construct(m_alloc, new_storage + i + (i < gap_at ? 0 : gap), std::move_if_noexcept(m_storage[i]));
+                }
+                catch (...) {
+                    for (size_type j{0} ; j < i ; ++j)
+                        alloc_traits::destroy(m_alloc, new_storage + j + (j < gap_at ? 0 : gap));
+                    for (size_type j{gap_at} ; j < gap_at + gap ; ++j)
+                        alloc_traits::destroy(m_alloc, new_storage + j);
+                    deallocate(new_storage, new_cap);
+                    throw;
+                }
+                release();
+                m_storage = new_storage;
+                m_capacity = new_cap;
+            }
+
+            //* Changes the capacity to new_cap (>= size()), moving the elements to a new buffer.
+            void resize_storage(size_type new_cap, std::false_type)
+            {
+                relocate_to(allocate(new_cap), new_cap);
+            }
+
+            //* Lets the allocator resize the block, in place if it can.
+            void resize_storage(size_type new_cap, std::true_type)
+            {
+                if (new_cap == 0) {
+                    deallocate(m_storage, m_capacity);
+                    m_storage = nullptr;
+                }
+                else {
+                    m_storage = m_alloc.reallocate(m_storage, m_capacity, new_cap);
+                }
+                m_capacity = new_cap;
+            }
+
+            //* Grows the storage to new_cap and appends an element built from args.
+            template <typename... Args>
+            void grow_and_emplace_back(size_type new_capacity, std::false_type, Args&&... args)
+            {
+                // The new element is built before the old buffer goes away, since args may live there.
+                pointer new_storage{allocate(new_capacity)};
+                try {
+                    alloc_traits::construct(m_alloc, new_storage + m_end, std::forward<Args>(args)...);
+                }
+                catch (...) {
+                    deallocate(new_storage, new_capacity);
+                    throw;
+                }
+                relocate_to(new_storage, new_capacity, m_end, 1);
+            }
+
+            template <typename... Args>
+            void grow_and_emplace_back(size_type new_capacity, std::true_type, Args&&... args)
+            {
+                // reallocate() may free the old block, where args may live: build the element first.
+                value_type value(std::forward<Args>(args)...);
+                resize_storage(new_capacity, std::true_type{});
+                alloc_traits::construct(m_alloc, m_storage + m_end, std::move(value));
+            }
+
+            //* Removes the elements in [first, last), shifting the tail down.
+            iterator erase_range(size_type first, size_type last)
+            {
+                unshare();
+                if (first != last) {
+                    erase_range(first, last, relocatable{});
+                    m_end -= last - first;
+                }
+                return iterator(m_storage + first);
+            }
+
+            //* Fast path: the tail is slid down over the erased slots with a single memmove.
+            void erase_range(size_type first, size_type last, std::true_type)
+            {
+                destroy_range(first, last);
+                std::memmove(m_storage + first, m_storage + last, (m_end - last) * sizeof(T));
+            }
+
+            void erase_range(size_type first, size_type last, std::false_type)
+            {
+                std::move(m_storage + last, m_storage + m_end, m_storage + first);
+                destroy_range(m_end - (last - first), m_end);
+            }
+
+            //* Replaces the contents with count elements read from first.
+            template <typename FwdItr>
+            void assign_range(FwdItr first, size_type count)
+            {
+                unshare();
+                assign_range(first, count, bitwise_copyable<FwdItr>{});
+            }
+
+            //* Fast path: trivially copyable elements are just overwritten (the source may overlap).
+            template <typename FwdItr>
+            void assign_range(FwdItr first, size_type count, std::true_type)
+            {
+                if (count > m_capacity) {
+                    // The old buffer goes away only after the copy, first may point into it.
+                    pointer new_storage{allocate(count)};
+                    std::memcpy(new_storage, first, count * sizeof(T));
+                    deallocate(m_storage, m_capacity);
+                    m_storage = new_storage;
+                    m_capacity = count;
+                }
+                else if (count != 0) {
+                    std::memmove(m_storage, first, count * sizeof(T));
+                }
+                m_end = count;
+            }
+
+            template <typename FwdItr>
+            void assign_range(FwdItr first, size_type count, std::false_type)
+            {
+                if (count > m_capacity) {
+                    // Not enough room: build a buffer of the exact size (first may point into the old one).
+                    rebuild(count, [&](pointer slot) { alloc_traits::construct(m_alloc, slot, *first); ++first; });
+                    return;
+                }
+                size_type i{0};
+                // Overwrite the live elements, then build the remaining ones on raw memory,
+                // counting each one in m_end so that a throwing copy leaks nothing.
+                for ( /*empty*/ ; i < count and i < m_end ; ++i, ++first)
+                    m_storage[i] = *first;
+                for ( /*empty*/ ; i < count ; ++i, ++first, ++m_end)
+                    alloc_traits::construct(m_alloc, m_storage + i, *first);
+                destroy_range(count, m_end);
+                m_end = count;
+            }
+
+            //* Inserts a copy of value at index position.
+            iterator insert_value(size_type position, const_reference value)
+            {
+                // Shifting the tail would overwrite value if it is one of our elements: copy it out first.
+                if (not full() and owns(std::addressof(value))) {
+                    value_type copy(value);
+                    return insert_range(position, std::make_move_iterator(std::addressof(copy)), 1);
+                }
+                return insert_range(position, std::addressof(value), 1);
+            }
+
+            //* Inserts value at index position, moving it into the vector.
+            iterator insert_value(size_type position, value_type &&value)
+            {
+                if (not full() and owns(std::addressof(value))) {
+                    value_type moved(std::move(value));
+                    return insert_range(position, std::make_move_iterator(std::addressof(moved)), 1);
+                }
+                return insert_range(position, std::make_move_iterator(std::addressof(value)), 1);
+            }
+
+            //* Whether p points to one of the live elements.
+            bool owns(const_pointer p) const
+            {
+                return not std::less<const_pointer>()(p, m_storage) and std::less<const_pointer>()(p, m_storage + m_end);
+            }
+
+            //* A multi-pass range is measured first, so the insertion is done in one step.
+            template <typename FwdItr>
+            iterator insert_range(size_type position, FwdItr first, FwdItr last, std::forward_iterator_tag)
+            {
+                return insert_range(position, unwrap(first), static_cast<size_type>(std::distance(first, last)));
+            }
+
+            //* A single-pass range can only be read once: append it, then rotate it into place.
+            template <typename InputItr>
+            iterator insert_range(size_type position, InputItr first, InputItr last, std::input_iterator_tag)
+            {
+                unshare();
+                size_type old_end{m_end};
+                try {
+                    for ( /*empty*/ ; first != last ; ++first)
+                        emplace_back(*first);
+                }
+                catch (...) {
+                    destroy_range(old_end, m_end);
+                    m_end = old_end;
+                    throw;
+                }
+                std::rotate(m_storage + position, m_storage + old_end, m_storage + m_end);
+                return iterator(m_storage + position);
+            }
+
+            //* Inserts count elements read from first at index position, growing the storage if needed.
+            template <typename FwdItr>
+            iterator insert_range(size_type position, FwdItr first, size_type count)
+            {
+                unshare();
+                if (m_end + count > m_capacity) {
+                    grow_and_insert(position, first, count);
+                }
+                else {
+                    shift_and_insert(position, first, count, relocatable{});
+                }
+                m_end += count;
+
+                return iterator(m_storage + position);
+            }
+
+            //* Moves to a new buffer in a single pass: the new elements are built in place, then the
+            //* prefix and the suffix are relocated around them. Each old element moves exactly once.
+            //* The allocator's reallocate() is not used here, it would relocate the suffix twice.
+            template <typename FwdItr>
+            void grow_and_insert(size_type position, FwdItr first, size_type count)
+            {
+                size_type new_capacity{next_capacity(m_end + count)};
+                pointer new_storage{allocate(new_capacity)};
+                size_type i{0};
+                try {
+                    // Built while the old buffer is intact, since first may point into it.
+                    for ( /*empty*/ ; i < count ; ++i, ++first)
+                        alloc_traits::construct(m_alloc, new_storage + position + i, *first);
+                }
+                catch (...) {
+                    for (size_type j{0} ; j < i ; ++j)
+                        alloc_traits::destroy(m_alloc, new_storage + position + j);
+                    deallocate(new_storage, new_capacity);
+                    throw;
+                }
+                relocate_to(new_storage, new_capacity, position, count);
+            }
+
+            //* Fast path: the tail is slid up with a single memmove and the elements are built on the raw gap.
+            //* Requires size()+count <= capacity().
+            template <typename FwdItr>
+            void shift_and_insert(size_type position, FwdItr first, size_type count, std::true_type)
+            {
+                std::memmove(m_storage + position + count, m_storage + position, (m_end - position) * sizeof(T));
+                for (size_type i{position} ; i < position + count ; ++i, ++first)
+                    alloc_traits::construct(m_alloc, m_storage + i, *first);
+            }
+
+            template <typename FwdItr>
+            void shift_and_insert(size_type position, FwdItr first, size_type count, std::false_type)
+            {
+                // Shift [position, m_end) count slots to the right, back to front.
+                // Slots past the old end are raw memory and must be constructed, not assigned.
+                for (size_type i{m_end} ; i > position ; --i) {
+                    size_type src{i - 1};
+                    size_type dst{src + count};
+                    if (dst >= m_end) alloc_traits::construct(m_alloc, m_storage + dst, std::move(m_storage[src]));
+                    else m_storage[dst] = std::move(m_storage[src]);
+                }
+                // Fill the gap, same rule as above.
+                for (size_type i{position} ; i < position + count ; ++i, ++first) {
+                    if (i < m_end) m_storage[i] = *first;
+                    else alloc_traits::construct(m_alloc, m_storage + i, *first);
+                }
+            }
+
             size_type m_end;                //!< The list's current size (or index past-last valid element).
             size_type m_capacity;           //!< The list's storage capacity.
             // std::unique_ptr<T[]> m_storage; //!< The list's data storage area.
             T *m_storage;                   //!< The list's data storage area.
+            allocator_type m_alloc;         //!< The allocator that owns the storage area.
+            //* Set while snapshots may share m_storage; it is then read-only until unshare().
+            mutable std::shared_ptr<snapshot_detail::block<T, allocator_type>> m_snapshot;
     };
 
+    template <typename T, typename Allocator, typename GrowthPolicy>
+    constexpr std::size_t vector<T, Allocator, GrowthPolicy>::alignment;
+
     //!=== [VI] Operators
     //* Checks if the contents of lhs and rhs are equal.
     //* Same size and equal values in the same positions.
-    template <typename T>
-    bool operator==(const vector<T> &lhs, const vector<T> &rhs)
+    //* Integers and other types with a unique representation are compared with memcmp, floats with SIMD.
+    template <typename T, typename Allocator, typename GrowthPolicy>
+    bool operator==(const vector<T, Allocator, GrowthPolicy> &lhs, const vector<T, Allocator, GrowthPolicy> &rhs)
 	{
 		if (lhs.size() != rhs.size())
 			return false;
-		for (int i{0}; i < lhs.size(); i++)
-			if (lhs[i] != rhs[i])
-				return false;
-		return true;
+		return kernels::equal(lhs.data(), rhs.data(), lhs.size());
 	}
 
     //* The negation of the above operation, the opposite result.
-    template <typename T>
-    bool operator!=(const vector<T> &lhs, const vector<T> &rhs)
+    template <typename T, typename Allocator, typename GrowthPolicy>
+    bool operator!=(const vector<T, Allocator, GrowthPolicy> &lhs, const vector<T, Allocator, GrowthPolicy> &rhs)
 	{
 		if (not (lhs == rhs))
 			return true;
 		return false;
 	}
 
+    //* Checks if lhs comes before rhs in lexicographical order, as std::lexicographical_compare.
+    //* Arithmetic elements jump straight to the first mismatch with a SIMD search.
+    template <typename T, typename Allocator, typename GrowthPolicy>
+    bool operator<(const vector<T, Allocator, GrowthPolicy> &lhs, const vector<T, Allocator, GrowthPolicy> &rhs)
+	{
+		return kernels::lexicographical_less(lhs.data(), lhs.size(), rhs.data(), rhs.size());
+	}
+
+    //* The other orderings follow from the one above.
+    template <typename T, typename Allocator, typename GrowthPolicy>
+    bool operator>(const vector<T, Allocator, GrowthPolicy> &lhs, const vector<T, Allocator, GrowthPolicy> &rhs)
+	{
+		return rhs < lhs;
+	}
+
+    template <typename T, typename Allocator, typename GrowthPolicy>
+    bool operator<=(const vector<T, Allocator, GrowthPolicy> &lhs, const vector<T, Allocator, GrowthPolicy> &rhs)
+	{
+		return not (rhs < lhs);
+	}
+
+    template <typename T, typename Allocator, typename GrowthPolicy>
+    bool operator>=(const vector<T, Allocator, GrowthPolicy> &lhs, const vector<T, Allocator, GrowthPolicy> &rhs)
+	{
+		return not (lhs < rhs);
+	}
+
 } // namespace sc.
 #endif
@@ -0,0 +1,209 @@
+#include<cstdio>
+#include<string>
+#include<stdexcept>
+
+#include "tm/test_manager.h"
+#include "../include/vector.h"
+#include "../include/small_vector.h"
+#include "../include/bit_vector.h"
+#include "../include/devector.h"
+#include "../include/segmented_vector.h"
+#include "../include/soa_vector.h"
+#include "../include/packed_int_vector.h"
+#ifdef __linux__
+#include "../include/mapped_vector.h"
+#include <unistd.h>
+#endif
+
+// Built with SC_BOUNDS_CHECK=SC_BOUNDS_THROWING and SC_EMPTY_CHECK=SC_BOUNDS_THROWING: every
+// precondition violation must throw.
+
+// Returns true if f() throws an Exception.
+template < typename Exception, typename F >
+bool throws( F f )
+{
+    try { f(); }
+    catch ( Exception & e ) { return true; }
+    return false;
+}
+
+int main( void )
+{
+    TestManager tm{ "Bounds-checking policy testing"};
+
+    {
+        BEGIN_TEST(tm, "Policy","sc::bounds_checking and sc::empty_checking reflect the macros");
+        EXPECT_EQ( static_cast<int>( sc::bounds_checking ), SC_BOUNDS_THROWING );
+        EXPECT_EQ( static_cast<int>( sc::empty_checking ), SC_BOUNDS_THROWING );
+    }
+
+    {
+        BEGIN_TEST(tm, "Vector","sc::vector checks operator[], front, back, pop_back, insert and erase");
+        sc::vector<int> vec{ 1, 2, 3 };
+        const sc::vector<int> & cvec = vec;
+
+        EXPECT_EQ( vec[2], 3 );
+        EXPECT_EQ( cvec[0], 1 );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ vec[3] = 0; } ) );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ (void)cvec[3]; } ) );
+
+        // Invalid positions leave the vector untouched.
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ vec.insert( vec.end() + 1, 4 ); } ) );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ vec.insert( vec.begin() - 1, { 4, 5 } ); } ) );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ vec.erase( vec.end() ); } ) );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ vec.erase( vec.begin() + 2, vec.begin() + 1 ); } ) );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ vec.erase( vec.begin(), vec.end() + 1 ); } ) );
+        EXPECT_EQ( vec, ( sc::vector<int>{ 1, 2, 3 } ) );
+
+        // The edges are valid positions.
+        vec.insert( vec.end(), 4 );
+        vec.erase( vec.begin(), vec.begin() );
+        vec.erase( vec.begin() + 1, vec.end() );
+        EXPECT_EQ( vec, ( sc::vector<int>{ 1 } ) );
+
+        vec.pop_back();
+        EXPECT_TRUE( throws<std::length_error>( [&]{ vec.pop_back(); } ) );
+        EXPECT_TRUE( throws<std::length_error>( [&]{ vec.front() = 0; } ) );
+        EXPECT_TRUE( throws<std::length_error>( [&]{ vec.back() = 0; } ) );
+        EXPECT_TRUE( throws<std::length_error>( [&]{ (void)cvec.front(); } ) );
+        EXPECT_TRUE( throws<std::length_error>( [&]{ (void)cvec.back(); } ) );
+    }
+
+    {
+        BEGIN_TEST(tm, "SmallVector","sc::small_vector checks operator[], front, back, pop_back, insert and erase");
+        sc::small_vector<int, 2> vec{ 1, 2, 3 };
+
+        EXPECT_EQ( vec[2], 3 );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ vec[3] = 0; } ) );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ vec.insert( vec.end() + 1, 4 ); } ) );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ vec.erase( vec.end() ); } ) );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ vec.erase( vec.begin(), vec.end() + 1 ); } ) );
+        EXPECT_EQ( vec.size(), 3 );
+
+        vec.clear();
+        EXPECT_TRUE( throws<std::length_error>( [&]{ vec.pop_back(); } ) );
+        EXPECT_TRUE( throws<std::length_error>( [&]{ vec.front() = 0; } ) );
+        EXPECT_TRUE( throws<std::length_error>( [&]{ vec.back() = 0; } ) );
+    }
+
+    {
+        BEGIN_TEST(tm, "BitVector","sc::bit_vector checks operator[], front, back and pop_back");
+        sc::bit_vector bits{ true, false };
+        EXPECT_TRUE( bits.front() and not bits.back() );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ bits[2] = true; } ) );
+        bits.clear();
+        EXPECT_TRUE( throws<std::length_error>( [&]{ (void)bits.front(); } ) );
+        EXPECT_TRUE( throws<std::length_error>( [&]{ (void)bits.back(); } ) );
+        EXPECT_TRUE( throws<std::length_error>( [&]{ bits.pop_back(); } ) );
+    }
+
+    {
+        BEGIN_TEST(tm, "Devector","sc::devector checks operator[], front, back, pop_back, pop_front, insert and erase");
+        sc::devector<int> dv;
+        for ( auto i{0} ; i < 4 ; ++i )
+            dv.push_back( i );
+
+        EXPECT_EQ( dv[3], 3 );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ dv[4] = 0; } ) );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ dv.insert( dv.end() + 1, 9 ); } ) );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ dv.erase( dv.end() ); } ) );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ dv.erase( dv.begin() + 2, dv.begin() + 1 ); } ) );
+        EXPECT_EQ( dv.size(), 4 );
+
+        dv.clear();
+        EXPECT_TRUE( throws<std::length_error>( [&]{ dv.pop_back(); } ) );
+        EXPECT_TRUE( throws<std::length_error>( [&]{ dv.pop_front(); } ) );
+        EXPECT_TRUE( throws<std::length_error>( [&]{ dv.front() = 0; } ) );
+        EXPECT_TRUE( throws<std::length_error>( [&]{ dv.back() = 0; } ) );
+    }
+
+    {
+        BEGIN_TEST(tm, "SegmentedVector","sc::segmented_vector checks operator[], front, back and pop_back");
+        sc::segmented_vector<int> sv;
+        sv.push_back( 1 );
+
+        EXPECT_EQ( sv[0], 1 );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ sv[1] = 0; } ) );
+
+        sv.pop_back();
+        EXPECT_TRUE( throws<std::length_error>( [&]{ sv.pop_back(); } ) );
+        EXPECT_TRUE( throws<std::length_error>( [&]{ sv.front() = 0; } ) );
+        EXPECT_TRUE( throws<std::length_error>( [&]{ sv.back() = 0; } ) );
+    }
+
+    {
+        BEGIN_TEST(tm, "SoaVector","sc::soa_vector checks operator[], pop_back, insert and erase");
+        sc::soa_vector<int, double> soa;
+        soa.push_back( 1, 1.5 );
+
+        EXPECT_EQ( soa.get<0>( 0 ), 1 );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ (void)soa[1]; } ) );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ soa.insert( soa.end() + 1, 2, 2.5 ); } ) );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ soa.erase( soa.end() ); } ) );
+        EXPECT_EQ( soa.size(), 1 );
+
+        soa.pop_back();
+        EXPECT_TRUE( throws<std::length_error>( [&]{ soa.pop_back(); } ) );
+    }
+
+    {
+        BEGIN_TEST(tm, "PackedIntVector","sc::packed_int_vector and sc::delta_packed_vector check operator[], set, front, back and pop_back");
+        sc::packed_int_vector<unsigned> packed( 3u );
+        EXPECT_TRUE( throws<std::length_error>( [&]{ (void)packed.front(); } ) );
+        EXPECT_TRUE( throws<std::length_error>( [&]{ (void)packed.back(); } ) );
+        EXPECT_TRUE( throws<std::length_error>( [&]{ packed.pop_back(); } ) );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ (void)packed[0]; } ) );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ packed.set( 0, 1 ); } ) );
+
+        packed.push_back( 5 );
+        packed.set( 0, 6 );
+        EXPECT_EQ( packed.front() + packed.back() + packed[0], 18u );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ (void)packed[1]; } ) );
+        // A rejected set() does not widen the elements either.
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ packed.set( 1, 1000 ); } ) );
+        EXPECT_EQ( packed.width(), 3u );
+
+        sc::delta_packed_vector<unsigned> deltas{ sc::vector<unsigned>{ 1, 2, 4 } };
+        EXPECT_EQ( deltas.front() + deltas.back() + deltas[1], 7u );
+        EXPECT_TRUE( throws<std::out_of_range>( [&]{ (void)deltas[3]; } ) );
+        sc::delta_packed_vector<unsigned> none;
+        EXPECT_TRUE( throws<std::length_error>( [&]{ (void)none.front(); } ) );
+        EXPECT_TRUE( throws<std::length_error>( [&]{ (void)none.back(); } ) );
+    }
+
+#ifdef __linux__
+    {
+        BEGIN_TEST(tm, "MappedVector","sc::mapped_vector checks operator[], front, back, pop_back and writable access");
+        std::string path{ "/tmp/sc_checks_" + std::to_string( getpid() ) + ".bin" };
+        {
+            sc::mapped_vector<int> vec{ path, sc::mapped_vector<int>::mode::read_write, 7 };
+            vec.push_back( 1 );
+
+            EXPECT_EQ( vec[0], 1 );
+            EXPECT_TRUE( throws<std::out_of_range>( [&]{ vec[1] = 0; } ) );
+
+            vec.pop_back();
+            EXPECT_TRUE( throws<std::length_error>( [&]{ vec.pop_back(); } ) );
+            EXPECT_TRUE( throws<std::length_error>( [&]{ vec.front() = 0; } ) );
+            EXPECT_TRUE( throws<std::length_error>( [&]{ vec.back() = 0; } ) );
+            vec.push_back( 2 );
+        }
+        {
+            // Writable access to a read-only file is refused; const access is fine.
+            sc::mapped_vector<int> vec{ path, sc::mapped_vector<int>::mode::read_only, 7 };
+            const sc::mapped_vector<int> & cvec = vec;
+            EXPECT_EQ( cvec[0], 2 );
+            EXPECT_TRUE( throws<std::logic_error>( [&]{ vec[0] = 0; } ) );
+            EXPECT_TRUE( throws<std::logic_error>( [&]{ (void)vec.data(); } ) );
+            EXPECT_TRUE( throws<std::logic_error>( [&]{ (void)vec.begin(); } ) );
+            EXPECT_TRUE( throws<std::logic_error>( [&]{ vec.front() = 0; } ) );
+            EXPECT_EQ( cvec.front(), 2 );
+        }
+        std::remove( path.c_str() );
+    }
+#endif
+
+    tm.summary();
+
+    return 0;
+}
@@ -1,13 +1,124 @@
 #include<iostream>
 #include<vector>
+#include<memory>
+#include<cstdint>
+#include<cstdio>
+#include<string>
+#include<limits>
+#include<sstream>
+#include<iterator>
+#include<algorithm>
+#include<stdexcept>
+#include<functional>
+#include<utility>
+#include<thread>
+#include<atomic>
 
 #include "tm/test_manager.h"
 #include "../include/vector.h"
+#include "../include/allocator.h"
+#include "../include/span.h"
+#include "../include/small_vector.h"
+#include "../include/recycling_allocator.h"
+#include "../include/compact.h"
+#include "../include/kernels.h"
+#include "../include/parallel.h"
+#include "../include/sort.h"
+#include "../include/flat_set.h"
+#include "../include/flat_map.h"
+#include "../include/bit_vector.h"
+#include "../include/soa_vector.h"
+#include "../include/segmented_vector.h"
+#include "../include/devector.h"
+#include "../include/concurrent_vector.h"
+#include "../include/packed_int_vector.h"
+#ifdef __linux__
+#include "../include/mmap_allocator.h"
+#include "../include/mapped_vector.h"
+#include <unistd.h>
+#endif
 
 #define which_lib sc
 // To run tests with the STL's vector, uncomment the line below.
 // #define which_lib std
 
+// ============================================================================
+// AUXILIARY TYPES
+// ============================================================================
+
+/// A type without default constructor that keeps track of how many instances are alive.
+struct Tracked {
+    static int alive;  //!< Number of live instances.
+    static int copies; //!< Number of copy constructions.
+    int value;         //!< The payload.
+    explicit Tracked( int v ) : value{ v } { ++alive; }
+    Tracked( const Tracked & other ) : value{ other.value } { ++alive; ++copies; }
+    Tracked & operator=( const Tracked & ) = default;
+    ~Tracked() { --alive; }
+    bool operator==( const Tracked & other ) const { return value == other.value; }
+    bool operator!=( const Tracked & other ) const { return value != other.value; }
+};
+int Tracked::alive{0};
+int Tracked::copies{0};
+
+/// A type whose copy constructor throws once a budget of copies runs out.
+struct Fragile {
+    static int alive;  //!< Number of live instances.
+    static int budget; //!< Copies left before one throws; negative means unlimited.
+    int value;         //!< The payload.
+    explicit Fragile( int v ) : value{ v } { ++alive; }
+    Fragile( const Fragile & other ) : value{ other.value }
+    {
+        if ( budget == 0 ) throw std::runtime_error( "[Fragile]: copy budget exhausted" );
+        if ( budget > 0 ) --budget;
+        ++alive;
+    }
+    Fragile & operator=( const Fragile & ) = default;
+    ~Fragile() { --alive; }
+};
+int Fragile::alive{0};
+int Fragile::budget{-1};
+
+/// An allocator that throws std::bad_alloc once its budget of allocations is spent.
+template < typename T >
+struct Stingy {
+    using value_type = T;
+    static int budget; //!< Allocations left before one throws; negative means unlimited.
+    Stingy( void ) = default;
+    template < typename U > Stingy( const Stingy<U> & ) { /* empty */ }
+    T * allocate( std::size_t n )
+    {
+        if ( budget == 0 ) throw std::bad_alloc();
+        if ( budget > 0 ) --budget;
+        return std::allocator<T>().allocate( n );
+    }
+    void deallocate( T * p, std::size_t n ) { std::allocator<T>().deallocate( p, n ); }
+    friend bool operator==( const Stingy &, const Stingy & ) { return true; }
+    friend bool operator!=( const Stingy &, const Stingy & ) { return false; }
+};
+template < typename T > int Stingy<T>::budget{-1};
+
+/// A custom growth policy: grows in fixed steps of 10 elements.
+struct grow_by_ten {
+    static std::size_t grow( std::size_t capacity, std::size_t, std::size_t ) { return capacity + 10; }
+};
+
+/// Modifies a small vector whatever its inline capacity.
+void append_squares( sc::small_vector_base<int> & vec, int count )
+{
+    for ( auto i{0} ; i < count ; ++i )
+        vec.push_back( i*i );
+}
+
+/// Reads either a sc::vector or a sc::small_vector through a view.
+long sum( sc::span<const int> values )
+{
+    long total{0};
+    for ( const auto & e : values )
+        total += e;
+    return total;
+}
+
 // ============================================================================
 // TESTING VECTOR AS A CONTAINER OF INTEGERS
 // ============================================================================
@@ -91,19 +202,19 @@ int main( void )
             EXPECT_EQ( (int)i+1, vec2[i] );
     }
 
-    // {
-    // BEGIN_TEST(tm, "MoveConstructor", "move the elements from another");
-    // // Range = the entire vector.
-    // which_lib::vector<int> vec{ 1, 2, 3, 4, 5 };
-    // which_lib::vector<int> vec2( std::move( vec ) );
+    {
+        BEGIN_TEST(tm, "MoveConstructor", "move the elements from another");
+        // Range = the entire vector.
+        which_lib::vector<int> vec{ 1, 2, 3, 4, 5 };
+        which_lib::vector<int> vec2( std::move( vec ) );
 
-    // EXPECT_EQ( vec2.size(), 5 );
-    // // EXPECT_FALSE( vec2.empty() );
+        EXPECT_EQ( vec2.size(), 5 );
+        EXPECT_FALSE( vec2.empty() );
 
-    // // CHeck whether the copy worked.
-    // for( auto i{0u} ; i < vec2.size() ; ++i )
-    // EXPECT_EQ( (int)i+1, vec2[i] );
-    // }
+        // CHeck whether the copy worked.
+        for( auto i{0u} ; i < vec2.size() ; ++i )
+            EXPECT_EQ( (int)i+1, vec2[i] );
+    }
 
 
     {
@@ -123,23 +234,23 @@ int main( void )
     }
 
 
-        // {
-        // BEGIN_TEST(tm, "MoveAssignOperator", "Move Assign Operator");
-        // // Range = the entire vector.
-        // which_lib::vector<int> vec{ 1, 2, 3, 4, 5 };
-        // which_lib::vector<int> vec2;
-
-        // vec2 = std::move( vec );
-        // EXPECT_EQ( vec2.size(), 5 );
-        // EXPECT_FALSE( vec2.empty() );
-        // EXPECT_EQ( vec.size(), 0 );
-        // EXPECT_EQ( vec.capacity(), 0 );
-        // EXPECT_TRUE( vec.empty() );
-
-        // // CHeck whether the copy worked.
-        // for( auto i{0u} ; i < vec2.size() ; ++i )
-        // EXPECT_EQ( (int)i+1, vec2[i] );
-        // }
+    {
+        BEGIN_TEST(tm, "MoveAssignOperator", "Move Assign Operator");
+        // Range = the entire vector.
+        which_lib::vector<int> vec{ 1, 2, 3, 4, 5 };
+        which_lib::vector<int> vec2;
+
+        vec2 = std::move( vec );
+        EXPECT_EQ( vec2.size(), 5 );
+        EXPECT_FALSE( vec2.empty() );
+        EXPECT_EQ( vec.size(), 0 );
+        EXPECT_EQ( vec.capacity(), 0 );
+        EXPECT_TRUE( vec.empty() );
+
+        // CHeck whether the copy worked.
+        for( auto i{0u} ; i < vec2.size() ; ++i )
+            EXPECT_EQ( (int)i+1, vec2[i] );
+    }
 
 
     {
@@ -663,6 +774,1282 @@ int main( void )
         EXPECT_EQ( vec.size() , 4 );
     }
 
+    {
+        BEGIN_TEST(tm, "RawStorage","only live elements are constructed");
+        {
+            which_lib::vector<Tracked> vec;
+            vec.reserve( 100 );
+            // Reserving memory must not construct anything.
+            EXPECT_EQ( Tracked::alive, 0 );
+
+            for ( auto i{0} ; i < 10 ; ++i )
+                vec.push_back( Tracked{ i } );
+            EXPECT_EQ( Tracked::alive, 10 );
+
+            vec.pop_back();
+            EXPECT_EQ( Tracked::alive, 9 );
+            vec.erase( vec.begin() );
+            EXPECT_EQ( Tracked::alive, 8 );
+            vec.erase( vec.begin(), std::next( vec.begin(), 3 ) );
+            EXPECT_EQ( Tracked::alive, 5 );
+            vec.insert( vec.begin(), Tracked{ 42 } );
+            EXPECT_EQ( Tracked::alive, 6 );
+            EXPECT_EQ( vec[0].value, 42 );
+            EXPECT_EQ( vec[1].value, 4 );
+
+            vec.assign( 2, Tracked{ 7 } );
+            EXPECT_EQ( Tracked::alive, 2 );
+            vec.shrink_to_fit();
+            EXPECT_EQ( Tracked::alive, 2 );
+
+            vec.clear();
+            EXPECT_EQ( Tracked::alive, 0 );
+            vec.push_back( Tracked{ 1 } );
+        }
+        // The destructor must destroy what is left.
+        EXPECT_EQ( Tracked::alive, 0 );
+    }
+
+    {
+        BEGIN_TEST(tm, "ThrowingCopy","a copy that throws while assigning leaves the vector intact");
+        {
+            which_lib::vector<Fragile> vec;
+            vec.push_back( Fragile{ 1 } );
+            vec.push_back( Fragile{ 2 } );
+            which_lib::vector<Fragile> other;
+            for ( auto i{0} ; i < 8 ; ++i )
+                other.push_back( Fragile{ 10 + i } );
+            auto check = [&]( bool thrown ) {
+                EXPECT_TRUE( thrown );
+                EXPECT_EQ( vec.size(), 2 );
+                EXPECT_EQ( vec[0].value + vec[1].value, 3 );
+                EXPECT_EQ( Fragile::alive, 10 );
+            };
+
+            // Growing: assign, copy operator= and initializer list operator=.
+            bool thrown{ false };
+            Fragile::budget = 3;
+            try { vec.assign( other.begin(), other.end() ); }
+            catch ( const std::runtime_error & ) { thrown = true; }
+            check( thrown );
+
+            thrown = false;
+            Fragile::budget = 3;
+            try { vec = other; }
+            catch ( const std::runtime_error & ) { thrown = true; }
+            check( thrown );
+
+            thrown = false;
+            try { Fragile::budget = 1; vec = { Fragile{ 5 }, Fragile{ 6 }, Fragile{ 7 } }; }
+            catch ( const std::runtime_error & ) { thrown = true; }
+            check( thrown );
+
+            thrown = false;
+            Fragile::budget = 4;
+            try { vec.assign( 8, vec[0] ); }
+            catch ( const std::runtime_error & ) { thrown = true; }
+            check( thrown );
+
+            // Within the capacity, the elements built before the throw are kept and destroyed later.
+            Fragile::budget = -1;
+            vec.reserve( 16 );
+            Fragile::budget = 5;
+            try { vec.assign( other.begin(), other.end() ); }
+            catch ( const std::runtime_error & ) { thrown = true; }
+            EXPECT_EQ( Fragile::alive, 8 + static_cast<int>( vec.size() ) );
+            Fragile::budget = -1;
+
+            thrown = false;
+            vec.assign( 2, Fragile{ 1 } );
+            Fragile::budget = 5;
+            try { vec.assign( 12, vec[1] ); }
+            catch ( const std::runtime_error & ) { thrown = true; }
+            EXPECT_TRUE( thrown );
+            EXPECT_EQ( Fragile::alive, 8 + static_cast<int>( vec.size() ) );
+            Fragile::budget = -1;
+        }
+        EXPECT_EQ( Fragile::alive, 0 );
+    }
+
+    {
+        BEGIN_TEST(tm, "MoveOnlyElements","push_back(T&&), insert(pos, T&&) and growth with move-only types");
+        which_lib::vector< std::unique_ptr<int> > vec;
+
+        // Each growth must move the elements, unique_ptr can not be copied.
+        for ( auto i{0} ; i < 10 ; ++i )
+            vec.push_back( std::unique_ptr<int>( new int{ i } ) );
+        vec.insert( vec.begin(), std::unique_ptr<int>( new int{ -1 } ) );
+        vec.shrink_to_fit();
+
+        EXPECT_EQ( vec.size(), 11 );
+        for ( auto i{0u} ; i < vec.size() ; ++i )
+            EXPECT_EQ( *vec[i], (int)i-1 );
+
+        // Moving a vector of vectors steals the inner buffers.
+        which_lib::vector< which_lib::vector<int> > outer;
+        outer.push_back( which_lib::vector<int>{ 1, 2, 3 } );
+        auto inner_data = outer[0].data();
+        outer.reserve( 100 );
+        EXPECT_EQ( outer[0].data(), inner_data );
+    }
+
+    {
+        BEGIN_TEST(tm, "ReallocatingAllocator","growth, insert and erase through malloc_allocator::reallocate()");
+        which_lib::vector< int, sc::malloc_allocator<int> > vec;
+
+        for ( auto i{0} ; i < 1000 ; ++i )
+            vec.push_back( i );
+        EXPECT_EQ( vec.size(), 1000 );
+
+        // Insert at the front and in the middle, then undo it.
+        vec.insert( vec.begin(), { -3, -2, -1 } );
+        vec.insert( std::next( vec.begin(), 503 ), 0 );
+        EXPECT_EQ( vec[0], -3 );
+        EXPECT_EQ( vec[503], 0 );
+        EXPECT_EQ( vec[504], 500 );
+        vec.erase( std::next( vec.begin(), 503 ) );
+        vec.erase( vec.begin(), std::next( vec.begin(), 3 ) );
+
+        vec.reserve( 5000 );
+        vec.shrink_to_fit();
+        EXPECT_EQ( vec.capacity(), 1000 );
+        bool same{ true };
+        for ( auto i{0u} ; i < vec.size() ; ++i )
+            same = same and vec[i] == (int)i;
+        EXPECT_TRUE( same );
+    }
+
+    {
+        BEGIN_TEST(tm, "GrowthPolicy","capacity sequence of the built-in and custom growth policies");
+        sc::vector<int> doubling;
+        sc::vector< int, std::allocator<int>, sc::growth::one_and_half > one_and_half;
+        sc::vector< int, std::allocator<int>, sc::growth::size_class_aware > size_class;
+        sc::vector< int, std::allocator<int>, grow_by_ten > custom;
+
+        which_lib::vector<unsigned long> caps, caps15, caps_custom;
+        bool bucketed{ true };
+        for ( auto i{0} ; i < 100 ; ++i )
+        {
+            if ( doubling.size() == doubling.capacity() ) caps.push_back( doubling.capacity() );
+            if ( one_and_half.size() == one_and_half.capacity() ) caps15.push_back( one_and_half.capacity() );
+            if ( custom.size() == custom.capacity() ) caps_custom.push_back( custom.capacity() );
+            doubling.push_back( i );
+            one_and_half.push_back( i );
+            size_class.push_back( i );
+            custom.push_back( i );
+            auto bytes = size_class.capacity() * sizeof(int);
+            bucketed = bucketed and sc::growth::size_class( bytes ) == bytes;
+        }
+        EXPECT_EQ( caps, ( which_lib::vector<unsigned long>{ 0, 1, 2, 4, 8, 16, 32, 64 } ) );
+        EXPECT_EQ( caps15, ( which_lib::vector<unsigned long>{ 0, 1, 2, 3, 4, 6, 9, 13, 19, 28, 42, 63, 94 } ) );
+        EXPECT_EQ( caps_custom, ( which_lib::vector<unsigned long>{ 0, 10, 20, 30, 40, 50, 60, 70, 80, 90 } ) );
+        EXPECT_TRUE( bucketed );
+        EXPECT_EQ( sc::growth::size_class( 100 ), 112 );
+        EXPECT_EQ( sc::growth::size_class( 129 ), 160 );
+
+        // Range inserts follow the policy too, and never get less than they need.
+        custom.insert( custom.end(), doubling.begin(), doubling.end() );
+        EXPECT_EQ( custom.size(), 200 );
+        EXPECT_GE( custom.capacity(), 200 );
+    }
+
+#ifdef __linux__
+    {
+        BEGIN_TEST(tm, "MmapAllocator","growth and shrink across the mmap threshold");
+        // Blocks of 64 KiB or more are mapped.
+        using alloc_t = sc::mmap_allocator< int, 64 * 1024, true >;
+        which_lib::vector< int, alloc_t > vec;
+
+        for ( auto i{0} ; i < 100000 ; ++i )
+            vec.push_back( i );
+        EXPECT_GE( vec.capacity() * sizeof(int), alloc_t::threshold );
+        vec.erase( std::next( vec.begin(), 1000 ), vec.end() );
+        vec.shrink_to_fit();
+        EXPECT_EQ( vec.capacity(), 1000 );
+        vec.reserve( 200000 );
+        vec.insert( vec.begin(), -1 );
+
+        EXPECT_EQ( vec.size(), 1001 );
+        bool same{ vec[0] == -1 };
+        for ( auto i{1u} ; i < vec.size() ; ++i )
+            same = same and vec[i] == (int)i-1;
+        EXPECT_TRUE( same );
+    }
+
+    {
+        BEGIN_TEST(tm, "MappedVector","sc::mapped_vector persists its elements in a file");
+        std::string path{ "/tmp/sc_mapped_vector_" + std::to_string( getpid() ) + ".bin" };
+        const std::uint64_t tag{ 42 };
+        {
+            sc::mapped_vector<long> vec{ path, sc::mapped_vector<long>::mode::read_write, tag };
+            EXPECT_TRUE( vec.empty() );
+            for ( auto i{0l} ; i < 10000 ; ++i )
+                vec.push_back( i * 3 );
+            long more[]{ -1, -2 };
+            vec.append( more, more + 2 );
+            vec.shrink_to_fit();
+            EXPECT_EQ( vec.capacity(), 10002 );
+        }
+        {
+            // Reopening is just a mapping: the elements are there.
+            // A read-only file is read through const access.
+            sc::mapped_vector<long> vec{ path, sc::mapped_vector<long>::mode::read_only, tag };
+            const sc::mapped_vector<long> & cvec = vec;
+            EXPECT_EQ( cvec.size(), 10002 );
+            EXPECT_EQ( cvec[9999], 29997 );
+            EXPECT_EQ( cvec.back(), -2 );
+
+            // The moved-from vector is closed and empty.
+            sc::mapped_vector<long> moved{ std::move( vec ) };
+            EXPECT_EQ( moved.size(), 10002 );
+            EXPECT_TRUE( cvec.empty() );
+            EXPECT_EQ( cvec.capacity(), 0 );
+            EXPECT_TRUE( cvec.data() == nullptr );
+            EXPECT_TRUE( cvec.begin() == cvec.end() );
+
+            bool worked{ false };
+            try { moved.push_back( 1 ); }
+            catch ( std::logic_error & e ) { worked = true; }
+            EXPECT_TRUE( worked );
+        }
+        {
+            // Opening with another element type or tag must fail.
+            bool worked{ false };
+            try { sc::mapped_vector<int> vec{ path, sc::mapped_vector<int>::mode::read_only, tag }; }
+            catch ( std::runtime_error & e ) { worked = true; }
+            EXPECT_TRUE( worked );
+
+            worked = false;
+            try { sc::mapped_vector<long> vec{ path, sc::mapped_vector<long>::mode::read_only, tag + 1 }; }
+            catch ( std::runtime_error & e ) { worked = true; }
+            EXPECT_TRUE( worked );
+        }
+        std::remove( path.c_str() );
+    }
+#endif
+
+    {
+        BEGIN_TEST(tm, "AlignedStorage","data() stays aligned across reserve, shrink_to_fit, assign and copy");
+        using vec_t = sc::vector< float, sc::aligned<64> >;
+        static_assert( vec_t::alignment == 64, "alignment must be exposed at compile time" );
+        static_assert( sc::vector< double, sc::aligned_allocator<double, 32> >::alignment == 32, "" );
+        static_assert( sc::vector< double >::alignment == alignof(double), "" );
+
+        auto aligned = []( const float * p ) { return reinterpret_cast<std::uintptr_t>( p ) % 64 == 0; };
+        vec_t vec;
+        bool always{ true };
+        for ( auto i{0} ; i < 1000 ; ++i )
+        {
+            vec.push_back( i );
+            always = always and aligned( vec.data() );
+        }
+        EXPECT_TRUE( always );
+        vec.reserve( 5000 );
+        EXPECT_TRUE( aligned( vec.data() ) );
+        vec.erase( std::next( vec.begin(), 3 ), vec.end() );
+        vec.shrink_to_fit();
+        EXPECT_TRUE( aligned( vec.data() ) );
+        vec.assign( 100, 1.5f );
+        EXPECT_TRUE( aligned( vec.data() ) );
+
+        vec_t copy{ vec };
+        EXPECT_TRUE( aligned( copy.data() ) );
+        EXPECT_EQ( copy, vec );
+        EXPECT_EQ( sc::assume_aligned<vec_t::alignment>( copy.data() )[99], 1.5f );
+    }
+
+    {
+        BEGIN_TEST(tm, "RecyclingAllocator","short-lived vectors reuse the blocks kept by the thread-local recycling pool");
+        using vec_t = sc::vector< int, sc::recycling_allocator<int> >;
+        auto & pool = sc::recycling_pool::local();
+        pool.trim();
+        pool.reset_stats();
+
+        for ( auto round{0} ; round < 100 ; ++round )
+        {
+            vec_t vec;
+            for ( auto i{0} ; i < 200 ; ++i )
+                vec.push_back( i );
+            EXPECT_EQ( vec[199], 199 );
+        }
+        auto st = pool.stats();
+        // Only the first round misses; later rounds find every growth step in the free lists.
+        EXPECT_TRUE( st.hits > 0 );
+        EXPECT_TRUE( st.hit_rate() > 0.9 );
+        EXPECT_TRUE( st.retained_bytes > 0 );
+        EXPECT_TRUE( st.retained_blocks > 0 );
+
+        EXPECT_EQ( pool.trim(), st.retained_bytes );
+        EXPECT_EQ( pool.stats().retained_bytes, 0u );
+        EXPECT_EQ( pool.stats().retained_blocks, 0u );
+    }
+
+    {
+        BEGIN_TEST(tm, "RecyclingTeardown","the thread-local recycling pool outlives the vectors of the thread, and later frees bypass it");
+        using vec_t = sc::vector< int, sc::recycling_allocator<int> >;
+        static std::atomic<int> pool_alive{ -1 }, late_pool_alive{ -1 };
+        // Destroyed after the pool, since it is built before any recycling_allocator of the thread.
+        struct late_user {
+            ~late_user() {
+                late_pool_alive = sc::recycling_pool::local_alive();
+                vec_t vec;
+                for ( auto i{0} ; i < 100 ; ++i )
+                    vec.push_back( i );
+            }
+        };
+        // Built after the pool: the allocator constructs it first, so the pool outlives it.
+        struct early_user {
+            vec_t vec;
+            ~early_user() { pool_alive = sc::recycling_pool::local_alive(); }
+        };
+        std::thread worker( []{
+            thread_local late_user late;
+            thread_local early_user early;
+            (void)late;
+            for ( auto i{0} ; i < 100 ; ++i )
+                early.vec.push_back( i );
+        } );
+        worker.join();
+        EXPECT_EQ( pool_alive.load(), 1 );
+        EXPECT_EQ( late_pool_alive.load(), 0 );
+    }
+
+    {
+        BEGIN_TEST(tm, "InsertGrowth","growing insert moves each element once; input iterators and aliased values");
+        which_lib::vector< Tracked > vec;
+        for ( auto i{0} ; i < 100 ; ++i )
+            vec.push_back( Tracked{ i } );
+        vec.shrink_to_fit();
+        Tracked::copies = 0;
+        Tracked extra[] = { Tracked{ -1 }, Tracked{ -2 }, Tracked{ -3 } };
+        vec.insert( vec.begin() + 50, std::begin( extra ), std::end( extra ) );
+        // 100 relocated elements plus 3 new ones, nothing shifted a second time.
+        EXPECT_EQ( Tracked::copies, 103 );
+        EXPECT_EQ( vec.size(), 103 );
+        EXPECT_EQ( vec[49].value, 49 );
+        EXPECT_EQ( vec[50].value, -1 );
+        EXPECT_EQ( vec[52].value, -3 );
+        EXPECT_EQ( vec[53].value, 50 );
+        EXPECT_EQ( vec[102].value, 99 );
+
+        // Single-pass input iterators.
+        which_lib::vector<int> ints{ 1, 2, 3 };
+        std::istringstream in{ "7 8 9" };
+        auto it = ints.insert( ints.begin() + 1, std::istream_iterator<int>{ in }, std::istream_iterator<int>{} );
+        EXPECT_EQ( *it, 7 );
+        EXPECT_EQ( ints, ( which_lib::vector<int>{ 1, 7, 8, 9, 2, 3 } ) );
+
+        // The value may be one of the elements, with or without growth.
+        ints.reserve( 20 );
+        ints.insert( ints.begin(), ints[2] );
+        EXPECT_EQ( ints, ( which_lib::vector<int>{ 8, 1, 7, 8, 9, 2, 3 } ) );
+        ints.shrink_to_fit();
+        ints.insert( ints.begin(), ints.back() );
+        EXPECT_EQ( ints, ( which_lib::vector<int>{ 3, 8, 1, 7, 8, 9, 2, 3 } ) );
+        which_lib::vector< std::string > words{ "a", "b", "c" };
+        words.reserve( 10 );
+        words.insert( words.begin(), words[1] );
+        words.insert( words.begin(), std::move( words[3] ) );
+        EXPECT_EQ( words[0], std::string{ "c" } );
+        EXPECT_EQ( words[1], std::string{ "b" } );
+        EXPECT_EQ( words[3], std::string{ "b" } );
+    }
+
+    {
+        BEGIN_TEST(tm, "SimdLevelNames","every level documented for SC_SIMD is recognized");
+        using sc::simd::level;
+        auto parsed = []( const char * name, level fallback ) { return static_cast<int>( sc::simd::detail::parse( name, fallback ) ); };
+        EXPECT_EQ( parsed( "scalar", level::avx2 ), static_cast<int>( level::scalar ) );
+        EXPECT_EQ( parsed( "sse2", level::scalar ), static_cast<int>( level::sse2 ) );
+        EXPECT_EQ( parsed( "avx2", level::scalar ), static_cast<int>( level::avx2 ) );
+        EXPECT_EQ( parsed( "avx512", level::scalar ), static_cast<int>( level::avx512 ) );
+        EXPECT_EQ( parsed( "neon", level::sse2 ), static_cast<int>( level::sse2 ) );
+        EXPECT_EQ( parsed( nullptr, level::sse2 ), static_cast<int>( level::sse2 ) );
+    }
+
+    {
+        BEGIN_TEST(tm, "EraseIf","sc::erase_if() and sc::erase() compact in one pass, on every SIMD level");
+        bool same{ true };
+        for ( auto lvl : { sc::simd::level::scalar, sc::simd::level::avx2, sc::simd::level::avx512 } )
+        {
+            sc::simd::set_max_level( lvl );
+            // Sizes around the register widths exercise the vector loop and the scalar tail.
+            for ( int n : { 0, 1, 7, 8, 9, 16, 17, 100, 1000 } )
+            {
+                sc::vector<int> ints;
+                sc::vector<double> reals;
+                sc::vector<long long> longs;
+                sc::vector<float> floats;
+                std::vector<int> expected;
+                for ( auto i{0} ; i < n ; ++i )
+                {
+                    ints.push_back( i % 3 );
+                    reals.push_back( i % 3 );
+                    longs.push_back( i % 3 );
+                    floats.push_back( i % 3 );
+                    if ( i % 3 != 1 ) expected.push_back( i % 3 );
+                }
+                auto removed = sc::erase( ints, 1 );
+                sc::erase( reals, 1.0 );
+                sc::erase( longs, 1LL );
+                sc::erase( floats, 1.0f );
+                same = same and removed == (std::size_t)( n - (int)expected.size() ) and ints.size() == expected.size();
+                for ( auto i{0u} ; i < expected.size() ; ++i )
+                    same = same and ints[i] == expected[i] and reals[i] == expected[i]
+                                and longs[i] == expected[i] and floats[i] == expected[i];
+            }
+        }
+        sc::simd::set_max_level( sc::simd::level::avx512 );
+        EXPECT_TRUE( same );
+
+        // NaN never compares equal, so it is never erased by value.
+        sc::vector<float> nan{ 1.0f, std::numeric_limits<float>::quiet_NaN(), 1.0f };
+        EXPECT_EQ( sc::erase( nan, std::numeric_limits<float>::quiet_NaN() ), 0u );
+        EXPECT_EQ( sc::erase( nan, 1.0f ), 2u );
+        EXPECT_EQ( nan.size(), 1u );
+
+        // Predicates and non-trivial elements.
+        sc::vector<int> ints{ 1, 2, 3, 4, 5, 6 };
+        EXPECT_EQ( sc::erase_if( ints, []( int x ) { return x % 2 == 0; } ), 3u );
+        EXPECT_EQ( ints, ( sc::vector<int>{ 1, 3, 5 } ) );
+        sc::vector< std::string > words{ "a", "bb", "a", "ccc" };
+        EXPECT_EQ( sc::erase( words, words[0] ), 2u );
+        EXPECT_EQ( words, ( sc::vector< std::string >{ "bb", "ccc" } ) );
+        EXPECT_EQ( sc::erase_if( words, []( const std::string & w ) { return w.size() > 2; } ), 1u );
+        EXPECT_EQ( words.size(), 1u );
+
+        // The value is not converted to the element type before comparing.
+        sc::vector<int> twos{ 1, 2, 3, 2 };
+        EXPECT_EQ( sc::erase( twos, 2.5 ), 0u );
+        EXPECT_EQ( sc::erase( twos, 2.0 ), 2u );
+        EXPECT_EQ( twos, ( sc::vector<int>{ 1, 3 } ) );
+        EXPECT_EQ( sc::erase( words, "bb" ), 1u );
+        EXPECT_TRUE( words.empty() );
+    }
+
+    {
+        BEGIN_TEST(tm, "OrderingOperators","vec1 < vec2, <=, >, >= and == agree with std::vector on every SIMD level");
+        bool same{ true };
+        for ( auto lvl : { sc::simd::level::scalar, sc::simd::level::sse2, sc::simd::level::avx2, sc::simd::level::avx512 } )
+        {
+            sc::simd::set_max_level( lvl );
+            // A mismatch at every position of vectors longer than a register, plus prefixes.
+            for ( int at{0} ; at <= 130 ; ++at )
+            {
+                std::vector<short> s1( 130, 7 ), s2( 130, 7 );
+                std::vector<double> d1( 130, 0.5 ), d2( 130, 0.5 );
+                if ( at < 130 ) { s2[at] = -1; d2[at] = 1.5; }
+                sc::vector<short> v1( s1.begin(), s1.end() ), v2( s2.begin(), s2.end() );
+                sc::vector<double> w1( d1.begin(), d1.end() ), w2( d2.begin(), d2.end() );
+                same = same and ( v1 == v2 ) == ( s1 == s2 ) and ( v1 < v2 ) == ( s1 < s2 ) and ( v2 < v1 ) == ( s2 < s1 );
+                same = same and ( w1 == w2 ) == ( d1 == d2 ) and ( w1 < w2 ) == ( d1 < d2 ) and ( w2 < w1 ) == ( d2 < d1 );
+                sc::vector<short> prefix( s1.begin(), s1.begin() + at );
+                same = same and ( prefix < v1 ) == ( at < 130 ) and not ( v1 < prefix );
+            }
+        }
+        sc::simd::set_max_level( sc::simd::level::avx512 );
+        EXPECT_TRUE( same );
+
+        sc::vector<int> a{ 1, 2, 3 }, b{ 1, 2, 4 }, c{ 1, 2 };
+        EXPECT_TRUE( a < b );
+        EXPECT_TRUE( a <= b );
+        EXPECT_TRUE( b > a );
+        EXPECT_TRUE( b >= a );
+        EXPECT_TRUE( c < a );
+        EXPECT_TRUE( a <= a );
+        EXPECT_TRUE( a >= a );
+        EXPECT_TRUE( not ( a < a ) );
+
+        // Floats compare by value: -0.0 == 0.0, NaN is neither equal nor ordered.
+        const float nan{ std::numeric_limits<float>::quiet_NaN() };
+        sc::vector<float> zeros{ 0.0f, 1.0f }, negzeros{ -0.0f, 1.0f };
+        EXPECT_TRUE( zeros == negzeros );
+        sc::vector<float> n1{ nan, 1.0f }, n2{ nan, 2.0f };
+        EXPECT_TRUE( n1 != n1 );
+        EXPECT_TRUE( n1 < n2 );
+
+        // Any type with operator<.
+        sc::vector< std::string > w1{ "abc", "d" }, w2{ "abc", "e" };
+        EXPECT_TRUE( w1 < w2 );
+        EXPECT_TRUE( w1 != w2 );
+    }
+
+    {
+        BEGIN_TEST(tm, "Kernels","sc::kernels agree with the scalar loops on every SIMD level");
+        bool same{ true };
+        for ( auto lvl : { sc::simd::level::scalar, sc::simd::level::sse2, sc::simd::level::avx2, sc::simd::level::avx512 } )
+        {
+            sc::simd::set_max_level( lvl );
+            for ( int n : { 1, 3, 8, 15, 16, 17, 33, 64, 100, 1000 } )
+            {
+                sc::vector<int> ints;
+                sc::vector<unsigned long> longs;
+                sc::vector<double> reals;
+                sc::vector<short> shorts;
+                long long isum{0}, idot{0};
+                unsigned long long lsum{0};
+                double rsum{0};
+                int imin{1000000}, imax{-1000000};
+                for ( auto i{0} ; i < n ; ++i )
+                {
+                    int x = ( i * 7919 ) % 201 - 100;
+                    ints.push_back( x );
+                    longs.push_back( (unsigned long)( i % 13 ) );
+                    reals.push_back( x * 0.5 );
+                    shorts.push_back( (short)x );
+                    isum += x; idot += (long long)x * x; lsum += i % 13; rsum += x * 0.5;
+                    imin = std::min( imin, x ); imax = std::max( imax, x );
+                }
+                auto mm = sc::kernels::minmax( ints );
+                same = same and sc::kernels::sum( ints ) == isum and sc::kernels::dot( ints, ints ) == idot
+                            and sc::kernels::sum( longs ) == lsum and sc::kernels::sum( reals ) == rsum
+                            and sc::kernels::sum( shorts ) == isum
+                            and mm.first == imin and mm.second == imax
+                            and sc::kernels::min( reals ) == imin * 0.5 and sc::kernels::max( shorts ) == imax
+                            and sc::kernels::find( ints, ints[n - 1] ) == (std::size_t)std::distance( ints.begin(), std::find( ints.begin(), ints.end(), ints[n - 1] ) )
+                            and sc::kernels::find( reals, 1000.0 ) == (std::size_t)n
+                            and sc::kernels::count( longs, 0ul ) == (std::size_t)( ( n + 12 ) / 13 )
+                            and sc::kernels::contains( longs, 12ul ) == ( n > 12 );
+            }
+        }
+        sc::simd::set_max_level( sc::simd::level::avx512 );
+        EXPECT_TRUE( same );
+
+        // Integer sums are computed on 64 bits.
+        sc::vector<int> big;
+        big.assign( std::size_t{ 100 }, std::numeric_limits<int>::max() );
+        EXPECT_EQ( sc::kernels::sum( big ), 100LL * std::numeric_limits<int>::max() );
+        sc::span<const int> view( big.data(), 10 );
+        EXPECT_EQ( sc::kernels::count( view, std::numeric_limits<int>::max() ), 10u );
+
+        sc::vector<float> empty;
+        bool worked{ false };
+        try { sc::kernels::min( empty ); }
+        catch ( const std::length_error & ) { worked = true; }
+        EXPECT_TRUE( worked );
+    }
+
+    {
+        BEGIN_TEST(tm, "Parallel", "Parallel algorithms over a thread pool, against their serial results.");
+
+        // Small grains, so every chunk boundary and the stealing are exercised.
+        sc::thread_pool pool( 4 );
+        EXPECT_EQ( pool.size(), 4u );
+        sc::parallel::options opt( pool, 1000 );
+
+        const std::size_t n{ 100003 };
+        sc::vector<long long> v;
+        v.assign( n, 0LL );
+        sc::parallel::fill( v, 3LL, opt );
+        EXPECT_EQ( std::count( v.begin(), v.end(), 3LL ), static_cast<long>( n ) );
+
+        sc::parallel::for_each( v.begin(), v.end(), []( long long &x ) { x += 1; }, opt );
+        EXPECT_EQ( sc::parallel::reduce( v, 0LL, opt ), 4LL * static_cast<long long>( n ) );
+
+        std::vector<long long> idx( n );
+        for ( std::size_t i{0} ; i < n ; ++i ) idx[i] = static_cast<long long>( i );
+        sc::parallel::transform( idx.data(), idx.data() + n, v.data(), []( long long x ) { return 2 * x; }, opt );
+        EXPECT_EQ( v[n - 1], 2LL * static_cast<long long>( n - 1 ) );
+
+        sc::vector<long long> scan;
+        scan.assign( n, 0LL );
+        sc::parallel::inclusive_scan( idx, scan, opt );
+        bool scan_ok{ true };
+        for ( std::size_t i{0} ; i < n ; ++i )
+            scan_ok = scan_ok and scan[i] == static_cast<long long>( i ) * static_cast<long long>( i + 1 ) / 2;
+        EXPECT_TRUE( scan_ok );
+
+        // Non-commutative op: chunks must be combined in order.
+        std::vector<std::string> words( 2500, "a" );
+        words[0] = "x"; words[2499] = "z";
+        std::string joined = sc::parallel::reduce( words.begin(), words.end(), std::string( ">" ),
+                []( const std::string &a, const std::string &b ) { return a + b; }, sc::parallel::options( pool, 7 ) );
+        EXPECT_EQ( joined.size(), 2501u );
+        EXPECT_EQ( joined.substr( 0, 2 ), std::string( ">x" ) );
+        EXPECT_EQ( joined.back(), 'z' );
+
+        sc::vector<long long> out;
+        out.assign( n, 0LL );
+        sc::parallel::copy( v, out, opt );
+        EXPECT_TRUE( out == v );
+
+        // The pool is reusable, the shared pool works, and exceptions reach the caller.
+        EXPECT_EQ( sc::parallel::reduce( v.data(), v.data() + n, 0LL ), sc::parallel::reduce( v, 0LL, opt ) );
+        bool thrown{ false };
+        try { sc::parallel::for_each( v, []( long long &x ) { if ( x == 100 ) throw std::runtime_error( "x" ); }, opt ); }
+        catch ( const std::runtime_error & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+
+        sc::vector<long long> shorter;
+        bool worked{ false };
+        try { sc::parallel::copy( v, shorter ); }
+        catch ( const std::length_error & ) { worked = true; }
+        EXPECT_TRUE( worked );
+    }
+
+    {
+        BEGIN_TEST(tm, "Sort", "Radix sort and parallel merge sort, against std::sort and std::stable_sort.");
+
+        // A small linear congruential generator, so the data is the same on every run.
+        std::uint64_t seed{ 42 };
+        auto next = [&seed]() { seed = seed * 6364136223846793005ull + 1442695040888963407ull; return seed >> 11; };
+
+        const std::size_t n{ 50000 };
+        sc::vector<std::uint64_t> keys;
+        sc::vector<std::int32_t> ints;
+        sc::vector<double> reals;
+        for ( std::size_t i{0} ; i < n ; ++i )
+        {
+            keys.push_back( next() );
+            ints.push_back( static_cast<std::int32_t>( next() ) );
+            reals.push_back( ( static_cast<double>( next() % 20001 ) - 10000.0 ) / 7.0 );
+        }
+        reals[0] = -0.0; reals[1] = 0.0;
+
+        std::vector<std::uint64_t> k2( keys.begin(), keys.end() );
+        std::sort( k2.begin(), k2.end() );
+        sc::sort( keys );
+        EXPECT_TRUE( std::equal( k2.begin(), k2.end(), keys.data() ) );
+
+        std::vector<std::int32_t> i2( ints.begin(), ints.end() );
+        std::sort( i2.begin(), i2.end() );
+        sc::radix_sort( ints.data(), ints.data() + n );
+        EXPECT_TRUE( std::equal( i2.begin(), i2.end(), ints.data() ) );
+
+        sc::radix_sort( reals );
+        EXPECT_TRUE( std::is_sorted( reals.data(), reals.data() + n ) );
+
+        // Key extractor: the sort is stable, so equal keys keep the order of their second member.
+        typedef std::pair<std::int16_t, std::uint32_t> record;
+        sc::vector<record> records;
+        for ( std::size_t i{0} ; i < n ; ++i )
+            records.push_back( record( static_cast<std::int16_t>( next() % 300 ) - 150, static_cast<std::uint32_t>( i ) ) );
+        std::vector<record> r2( records.begin(), records.end() );
+        std::stable_sort( r2.begin(), r2.end(), []( const record &a, const record &b ) { return a.first < b.first; } );
+        sc::radix_sort( records, []( const record &r ) { return r.first; } );
+        EXPECT_TRUE( std::equal( r2.begin(), r2.end(), records.data() ) );
+
+        // Merge sort, with runs and merge pieces small enough to split every pair over the threads.
+        sc::thread_pool pool( 3 );
+        sc::vector<std::string> words;
+        for ( std::size_t i{0} ; i < 5000 ; ++i )
+            words.push_back( std::to_string( next() % 1000 ) );
+        std::vector<std::string> w2( words.begin(), words.end() );
+        std::sort( w2.begin(), w2.end(), std::greater<std::string>() );
+        sc::sort( words, std::greater<std::string>(), sc::parallel::options( pool, 333 ) );
+        EXPECT_TRUE( std::equal( w2.begin(), w2.end(), words.data() ) );
+
+        sc::sort( r2.data(), r2.data() + n, []( const record &a, const record &b ) { return a.second < b.second; },
+                  sc::parallel::options( pool, 1000 ) );
+        bool ordered{ true };
+        for ( std::size_t i{0} ; i < n ; ++i )
+            ordered = ordered and r2[i].second == i;
+        EXPECT_TRUE( ordered );
+
+        sc::vector<int> tiny{ 3, 1, 2 };
+        sc::sort( tiny );
+        EXPECT_TRUE( tiny == ( sc::vector<int>{ 1, 2, 3 } ) );
+    }
+
+    {
+        BEGIN_TEST(tm, "FlatSetMap", "flat_set/flat_map lookups, single and bulk insertion, erasure.");
+
+        // The branch-free searches agree with the standard ones, on every size and every probe.
+        bool bounds_ok{ true };
+        for ( std::size_t n{0} ; n < 40 ; ++n )
+        {
+            std::vector<int> a;
+            for ( std::size_t i{0} ; i < n ; ++i ) a.push_back( static_cast<int>( i / 2 * 2 ) );
+            for ( int key{-1} ; key <= static_cast<int>( n ) + 1 ; ++key )
+            {
+                std::size_t lo = std::lower_bound( a.begin(), a.end(), key ) - a.begin();
+                std::size_t hi = std::upper_bound( a.begin(), a.end(), key ) - a.begin();
+                bounds_ok = bounds_ok and sc::kernels::lower_bound( a.data(), n, key, std::less<int>() ) == lo
+                                      and sc::kernels::upper_bound( a.data(), n, key, std::less<int>() ) == hi;
+            }
+        }
+        EXPECT_TRUE( bounds_ok );
+
+        sc::flat_set<int> set{ 5, 1, 3, 1 };
+        EXPECT_EQ( set.size(), 3u );
+        EXPECT_TRUE( set.insert( 2 ).second );
+        EXPECT_TRUE( not set.insert( 3 ).second );
+        int bulk[] = { 9, 0, 4, 4, 3, 7 };
+        set.insert( std::begin( bulk ), std::end( bulk ) );
+        EXPECT_TRUE( std::equal( set.begin(), set.end(), std::vector<int>{ 0, 1, 2, 3, 4, 5, 7, 9 }.begin() ) );
+        EXPECT_EQ( set.erase( 4 ), 1u );
+        EXPECT_EQ( set.erase( 4 ), 0u );
+        EXPECT_TRUE( set.contains( 7 ) and not set.contains( 6 ) );
+        EXPECT_TRUE( set.find( 6 ) == set.end() );
+        EXPECT_EQ( *set.lower_bound( 6 ), 7 );
+        EXPECT_EQ( *set.upper_bound( 7 ), 9 );
+        set.reserve( 100 );
+        EXPECT_TRUE( set.capacity() >= 100u );
+        set.shrink_to_fit();
+        EXPECT_EQ( set.capacity(), set.size() );
+
+        // Bulk insertion: stored entries and the first of repeated keys win.
+        sc::flat_map<std::string, int> map;
+        map["b"] = 2;
+        map.insert( std::make_pair( std::string( "d" ), 4 ) );
+        std::vector< std::pair<std::string, int> > batch{ { "c", 3 }, { "a", 1 }, { "b", 20 }, { "c", 30 }, { "e", 5 } };
+        map.insert( batch.begin(), batch.end() );
+        EXPECT_EQ( map.size(), 5u );
+        EXPECT_EQ( map.at( "b" ), 2 );
+        EXPECT_EQ( map.at( "c" ), 3 );
+        EXPECT_TRUE( std::is_sorted( map.keys().data(), map.keys().data() + map.size() ) );
+        std::string walked;
+        for ( auto it = map.begin() ; it != map.end() ; ++it ) walked += it->first;
+        EXPECT_EQ( walked, std::string( "abcde" ) );
+        auto first = map.begin(), last = map.end();
+        EXPECT_TRUE( first < last and last > first and first <= first and last >= first and not ( first >= last ) );
+
+        map.find( "e" )->second = 50;
+        EXPECT_EQ( map.values()[4], 50 );
+        EXPECT_TRUE( not map.insert_or_assign( std::string( "a" ), 10 ).second );
+        EXPECT_EQ( map["a"], 10 );
+        EXPECT_EQ( map["z"], 0 );
+        EXPECT_EQ( map.erase( "z" ), 1u );
+        sc::flat_map<std::string, int>::const_iterator cit = map.find( "c" );
+        EXPECT_EQ( ( *map.erase( cit ) ).first, std::string( "d" ) );
+        EXPECT_TRUE( not map.contains( "c" ) );
+
+        bool thrown{ false };
+        try { map.at( "missing" ); }
+        catch ( const std::out_of_range & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+
+        // Built from sorted data: the entries are appended without a merge.
+        sc::flat_map<int, int> squares;
+        std::vector< std::pair<int, int> > sorted;
+        for ( int i{0} ; i < 1000 ; ++i ) sorted.push_back( std::make_pair( i, i * i ) );
+        squares.insert( sorted.begin(), sorted.end() );
+        squares.insert( sorted.begin(), sorted.begin() + 10 );
+        EXPECT_EQ( squares.size(), 1000u );
+        EXPECT_EQ( squares.at( 999 ), 998001 );
+    }
+
+    {
+        BEGIN_TEST(tm, "BitVector", "Packed bits: proxy references, counting, searching, bitwise operators, rank/select.");
+
+        sc::bit_vector bits;
+        std::vector<bool> model;
+        std::uint64_t seed{ 7 };
+        for ( std::size_t i{0} ; i < 1000 ; ++i )
+        {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            bool b = ( seed >> 60 ) % 3 == 0;
+            bits.push_back( b );
+            model.push_back( b );
+        }
+        EXPECT_EQ( bits.size(), 1000u );
+        EXPECT_EQ( bits.word_count(), 16u );
+        EXPECT_EQ( bits.count(), static_cast<unsigned long>( std::count( model.begin(), model.end(), true ) ) );
+
+        // The proxy reads and writes single bits.
+        bits[3] = true;
+        bits.at( 4 ) = false;
+        bits[5] = bits[3];
+        model[3] = true; model[4] = false; model[5] = true;
+        EXPECT_TRUE( bits[3] and not bits[4] and bits[5] );
+        EXPECT_TRUE( std::equal( model.begin(), model.end(), bits.cbegin() ) );
+        EXPECT_TRUE( bits.cbegin() < bits.cend() and bits.cend() > bits.cbegin() and bits.cbegin() <= bits.cbegin() and bits.cend() >= bits.cbegin() and not ( bits.cbegin() >= bits.cend() ) );
+
+        // find_first/find_next visit exactly the set bits, in order; rank/select agree with them.
+        sc::rank_select index( bits );
+        bool walk_ok{ true };
+        unsigned long k{ 0 };
+        for ( auto i = bits.find_first() ; i != bits.size() ; i = bits.find_next( i ), ++k )
+            walk_ok = walk_ok and model[i] and bits.rank( i ) == k and index.rank( i ) == k
+                              and bits.select( k ) == i and index.select( k ) == i;
+        EXPECT_TRUE( walk_ok );
+        EXPECT_EQ( k, bits.count() );
+        EXPECT_EQ( index.rank( bits.size() ), bits.count() );
+        EXPECT_EQ( index.select( k ), bits.size() );
+        EXPECT_EQ( sc::bit_vector::select_in_word( 0x8000000000000001ull, 1 ), 63u );
+
+        // Bitwise operators, and the tail bits past size() staying clear.
+        sc::bit_vector inverse = ~bits;
+        EXPECT_EQ( inverse.count(), bits.size() - bits.count() );
+        EXPECT_EQ( ( bits & inverse ).count(), 0u );
+        EXPECT_TRUE( ( bits | inverse ).all() );
+        EXPECT_TRUE( ( bits ^ inverse ) == sc::bit_vector( 1000, true ) );
+
+        sc::bit_vector other( 999 );
+        bool thrown{ false };
+        try { bits &= other; }
+        catch ( const std::length_error & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+        thrown = false;
+        try { bits.at( 1000 ); }
+        catch ( const std::out_of_range & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+
+        sc::bit_vector grow{ true, false, true };
+        grow.resize( 130, true );
+        EXPECT_EQ( grow.count(), 129u );
+        grow.resize( 65 );
+        EXPECT_EQ( grow.count(), 64u );
+        grow.pop_back();
+        EXPECT_EQ( grow.word_count(), 1u );
+        EXPECT_TRUE( grow.none() == false and grow.find_next( 63 ) == grow.size() );
+
+        // An empty vector, with or without words, has no set bit to find.
+        sc::bit_vector empty;
+        EXPECT_EQ( empty.find_first(), 0u );
+        EXPECT_EQ( empty.find_next( 0 ), 0u );
+        EXPECT_EQ( empty.select( 0 ), 0u );
+        EXPECT_EQ( empty.count(), 0u );
+        EXPECT_TRUE( empty.none() and empty.all() );
+        grow.resize( 0 );
+        EXPECT_EQ( grow.find_first(), 0u );
+    }
+
+    {
+        BEGIN_TEST(tm, "SoaVector", "Structure of arrays: columns move together, spans, zip iterators, rollback.");
+
+        sc::soa_vector<float, int, std::string> soa;
+        for ( int i{0} ; i < 100 ; ++i )
+            soa.push_back( i * 0.5f, i, std::to_string( i ) );
+        EXPECT_EQ( soa.size(), 100u );
+        EXPECT_TRUE( soa.capacity() >= soa.size() );
+
+        // Each column is one contiguous array.
+        sc::span<float> x = soa.column<0>();
+        sc::span<const int> id = static_cast<const sc::soa_vector<float, int, std::string> &>( soa ).column<1>();
+        EXPECT_EQ( x.size(), 100u );
+        EXPECT_TRUE( x.data() == soa.data<0>() and &id[99] == &id[0] + 99 );
+        long sum{0};
+        for ( std::size_t i{0} ; i < id.size() ; ++i ) sum += id[i];
+        EXPECT_EQ( sum, 4950 );
+
+        // Records through operator[] and the zip iterators.
+        std::get<0>( soa[10] ) = -1.f;
+        EXPECT_EQ( x[10], -1.f );
+        EXPECT_EQ( std::get<2>( soa.at( 42 ) ), std::string( "42" ) );
+        EXPECT_EQ( soa.get<1>( 7 ), 7 );
+        int walked{0};
+        bool in_order{ true };
+        for ( auto it = soa.begin() ; it != soa.end() ; ++it, ++walked )
+            in_order = in_order and std::get<1>( *it ) == walked;
+        EXPECT_TRUE( in_order );
+        EXPECT_EQ( walked, 100 );
+        EXPECT_EQ( soa.cend() - soa.cbegin(), 100 );
+        EXPECT_TRUE( soa.cbegin() < soa.cend() and soa.cend() > soa.cbegin() and soa.cbegin() <= soa.cbegin() and soa.cend() >= soa.cbegin() and not ( soa.cbegin() >= soa.cend() ) );
+
+        // insert() and erase() shift every column.
+        auto pos = soa.insert( soa.cbegin() + 1, 9.f, -5, std::string( "new" ) );
+        EXPECT_EQ( pos.index(), 1u );
+        EXPECT_EQ( std::get<1>( soa[1] ), -5 );
+        EXPECT_EQ( std::get<2>( soa[2] ), std::string( "1" ) );
+        soa.erase( soa.cbegin() + 1 );
+        soa.erase( soa.cbegin(), soa.cbegin() + 50 );
+        EXPECT_EQ( soa.size(), 50u );
+        EXPECT_TRUE( std::get<1>( soa[0] ) == 50 and std::get<2>( soa[0] ) == "50" );
+        soa.pop_back();
+        EXPECT_EQ( std::get<1>( soa[soa.size() - 1] ), 98 );
+        soa.push_back( std::make_tuple( 1.f, 1000, std::string( "t" ) ) );
+        EXPECT_EQ( soa.get<1>( soa.size() - 1 ), 1000 );
+
+        soa.reserve( 1000 );
+        EXPECT_TRUE( soa.capacity() >= 1000 );
+        soa.shrink_to_fit();
+        EXPECT_EQ( soa.capacity(), soa.size() );
+
+        // A column that throws leaves the record out of every column.
+        struct picky
+        {
+            int v;
+            picky( int v_ ) : v{v_} { if ( v_ < 0 ) throw std::invalid_argument( "negative" ); }
+        };
+        sc::soa_vector<int, picky> guarded;
+        guarded.push_back( 1, 1 );
+        bool thrown{ false };
+        try { guarded.push_back( 2, -1 ); }
+        catch ( const std::invalid_argument & ) { thrown = true; }
+        EXPECT_TRUE( thrown and guarded.size() == 1 and guarded.column<0>().size() == 1 );
+        thrown = false;
+        try { guarded.insert( guarded.cbegin(), 3, -1 ); }
+        catch ( const std::invalid_argument & ) { thrown = true; }
+        EXPECT_TRUE( thrown and guarded.size() == 1 and guarded.get<0>( 0 ) == 1 );
+
+        soa.clear();
+        EXPECT_TRUE( soa.empty() );
+        thrown = false;
+        try { soa.pop_back(); }
+        catch ( const std::length_error & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+    }
+
+    {
+        BEGIN_TEST(tm, "SegmentedVector", "Chunked storage: growth never moves elements, O(1) indexing, chunk-wise iteration.");
+
+        sc::segmented_vector<long> seg;
+        seg.push_back( 0 );
+        const long *first = &seg[0];
+        std::vector<const long *> addresses;
+        for ( long i{1} ; i < 100000 ; ++i )
+        {
+            seg.push_back( i );
+            if ( i % 997 == 0 ) addresses.push_back( &seg.back() );
+        }
+        // Nothing moved while growing.
+        EXPECT_TRUE( first == &seg[0] and *first == 0 );
+        bool stable{ true };
+        for ( std::size_t j{0} ; j < addresses.size() ; ++j )
+            stable = stable and addresses[j] == &seg[ 997 * ( j + 1 ) ] and *addresses[j] == long( 997 * ( j + 1 ) );
+        EXPECT_TRUE( stable );
+        EXPECT_EQ( seg.size(), 100000u );
+        EXPECT_TRUE( seg.capacity() >= seg.size() and seg.capacity() < 2 * seg.size() + 2 * seg.first_chunk );
+
+        // Indexing, iterators and chunks all see the same sequence.
+        bool indexed{ true };
+        for ( long i{0} ; i < 100000 ; ++i ) indexed = indexed and seg[i] == i;
+        EXPECT_TRUE( indexed );
+        long expected{0};
+        bool walked{ true };
+        for ( const long & v : seg ) walked = walked and v == expected++;
+        EXPECT_TRUE( walked and expected == 100000 );
+        long sum{0};
+        std::size_t chunks{0};
+        seg.for_each_chunk( [&]( sc::span<const long> c ) { ++chunks; for ( long v : c ) sum += v; } );
+        EXPECT_EQ( sum, 4999950000L );
+        EXPECT_EQ( chunks, seg.chunk_count() );
+        auto it = seg.begin() + 70000;
+        EXPECT_EQ( *it, 70000 );
+        EXPECT_EQ( *( it - 69999 ), 1 );
+        EXPECT_EQ( seg.end() - it, 30000 );
+        EXPECT_TRUE( seg.begin() < it and it > seg.begin() and it <= it and seg.end() >= it and not ( it >= seg.end() ) );
+        sc::segmented_vector<long>::const_iterator cit = it;
+        EXPECT_EQ( cit[5], 70005 );
+
+        // Shrinking frees the trailing chunks only.
+        seg.resize( 10 );
+        EXPECT_TRUE( first == &seg[0] and seg.back() == 9 );
+        seg.shrink_to_fit();
+        EXPECT_TRUE( first == &seg[0] and seg.capacity() < 100 );
+
+        // Copies are deep, moves keep the chunks.
+        sc::segmented_vector<std::string> words{ "a", "b", "c" };
+        sc::segmented_vector<std::string> copy{ words };
+        copy[0] = "z";
+        EXPECT_TRUE( words[0] == "a" and copy != words );
+        const std::string *b = &words[1];
+        sc::segmented_vector<std::string> moved{ std::move( words ) };
+        EXPECT_TRUE( &moved[1] == b and words.empty() );
+        copy = moved;
+        EXPECT_TRUE( copy == moved );
+
+        bool thrown{ false };
+        try { moved.at( 3 ); }
+        catch ( const std::out_of_range & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+        moved.clear();
+        thrown = false;
+        try { moved.pop_back(); }
+        catch ( const std::length_error & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+    }
+
+    {
+        BEGIN_TEST(tm, "Devector", "Double-ended contiguous storage: push/pop at both ends, middle insert/erase, sliding window.");
+
+        sc::devector<int> dv;
+        for ( int i{0} ; i < 1000 ; ++i )
+        {
+            dv.push_back( i );
+            dv.push_front( -i - 1 );
+        }
+        EXPECT_EQ( dv.size(), 2000u );
+        bool in_order{ true };
+        for ( int i{0} ; i < 2000 ; ++i ) in_order = in_order and dv[i] == i - 1000;
+        EXPECT_TRUE( in_order );
+        EXPECT_TRUE( dv.front() == -1000 and dv.back() == 999 );
+        // Contiguous, so data() works as a C array.
+        EXPECT_TRUE( dv.data() == &dv[0] and &dv[1999] == dv.data() + 1999 );
+
+        // A sliding window re-centres in place instead of growing.
+        dv.shrink_to_fit();
+        dv.reserve( 4096 );
+        auto cap = dv.capacity();
+        for ( int i{0} ; i < 100000 ; ++i )
+        {
+            dv.pop_front();
+            dv.push_back( 999 + 1 + i );
+        }
+        EXPECT_EQ( dv.capacity(), cap );
+        EXPECT_TRUE( dv.front() == 100000 - 1000 and dv.back() == 100999 and dv.size() == 2000 );
+
+        // Middle insert and erase shift the shorter side.
+        sc::devector<std::string> words{ "b", "c", "e", "f" };
+        words.insert( words.begin() + 2, std::string( "d" ) );
+        words.insert( words.begin(), std::string( "a" ) );
+        words.insert( words.begin() + 1, std::string( "ab" ) );
+        words.insert( words.end(), std::string( "g" ) );
+        EXPECT_TRUE( ( words == sc::devector<std::string>{ "a", "ab", "b", "c", "d", "e", "f", "g" } ) );
+        auto next = words.erase( words.begin() + 1 );
+        EXPECT_EQ( *next, std::string( "b" ) );
+        words.erase( words.begin() + 4, words.end() - 1 );
+        EXPECT_TRUE( ( words == sc::devector<std::string>{ "a", "b", "c", "d", "g" } ) );
+        words.emplace_front( 3, 'z' );
+        EXPECT_EQ( words.front(), std::string( "zzz" ) );
+        // An element of the container itself as the argument, across a re-balance.
+        words.shrink_to_fit();
+        words.push_front( words.back() );
+        EXPECT_TRUE( words.front() == "g" and words.size() == 7 );
+
+        sc::devector<std::string> copy{ words };
+        sc::devector<std::string> moved{ std::move( copy ) };
+        EXPECT_TRUE( moved == words and copy.empty() );
+
+        bool thrown{ false };
+        try { copy.pop_front(); }
+        catch ( const std::length_error & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+        thrown = false;
+        try { words.at( 7 ); }
+        catch ( const std::out_of_range & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+        words.clear();
+        EXPECT_TRUE( words.empty() and words.front_capacity() > 0 and words.back_capacity() > 0 );
+    }
+
+    {
+        BEGIN_TEST(tm, "ConcurrentVector", "Lock-free appends from many threads, stable elements, published prefix.");
+
+        sc::concurrent_vector<long> cv;
+        const long per_thread{ 20000 };
+        const int producers{ 4 };
+        std::atomic<bool> done{ false };
+        std::atomic<bool> prefix_ok{ true };
+        // A reader checks that every published element is constructed while the producers run.
+        std::thread reader( [&] {
+            while ( not done.load() )
+            {
+                auto n = cv.size();
+                for ( decltype( n ) i{0} ; i < n ; i += 97 )
+                    if ( cv[i] < 0 or cv[i] >= producers * per_thread ) prefix_ok = false;
+            }
+        } );
+        std::vector<std::thread> threads;
+        for ( int t{0} ; t < producers ; ++t )
+            threads.emplace_back( [&cv, &prefix_ok, t, per_thread] {
+                for ( long i{0} ; i < per_thread ; ++i )
+                {
+                    auto at = cv.push_back( t * per_thread + i );
+                    if ( cv[at] != t * per_thread + i ) prefix_ok = false;
+                }
+            } );
+        for ( auto & th : threads ) th.join();
+        done = true;
+        reader.join();
+
+        EXPECT_TRUE( prefix_ok.load() );
+        EXPECT_EQ( cv.size(), std::size_t( producers * per_thread ) );
+        EXPECT_EQ( cv.claimed(), cv.size() );
+        std::vector<bool> seen( producers * per_thread, false );
+        bool unique{ true };
+        for ( std::size_t i{0} ; i < cv.size() ; ++i )
+        {
+            unique = unique and not seen[ cv[i] ];
+            seen[ cv[i] ] = true;
+        }
+        EXPECT_TRUE( unique );
+
+        // Elements never move, and grow_by hands out consecutive slots.
+        const long *first = &cv[0];
+        auto block = cv.grow_by( 1000, -7L );
+        EXPECT_TRUE( first == &cv[0] and cv[block] == -7 and cv[block + 999] == -7 );
+        EXPECT_TRUE( cv.is_published( block + 999 ) and not cv.is_published( block + 1000 ) );
+        EXPECT_TRUE( cv.capacity() >= cv.size() );
+
+        bool thrown{ false };
+        try { cv.at( cv.size() ); }
+        catch ( const std::out_of_range & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+
+        sc::concurrent_vector<std::string> names;
+        names.reserve( 10000 );
+        auto cap = names.capacity();
+        names.push_back( std::string( "x" ) );
+        names.grow_by( 3 );
+        EXPECT_TRUE( cap >= 10000 and names.capacity() == cap and names.size() == 4 and names[3].empty() );
+        names.clear();
+        EXPECT_TRUE( names.empty() );
+        EXPECT_EQ( names.push_back( std::string( "again" ) ), 0u );
+    }
+
+    {
+        BEGIN_TEST(tm, "VectorSnapshot", "O(1) immutable snapshots, copy-on-write on the next change, atomic publication.");
+
+        sc::vector<int> v{ 1, 2, 3, 4, 5 };
+        auto s = v.snapshot();
+        // Nothing is copied: the snapshot reads the vector's buffer.
+        EXPECT_TRUE( s.data() == static_cast<const sc::vector<int> &>( v ).data() and s.size() == 5 );
+        auto again = v.snapshot();
+        EXPECT_TRUE( again.data() == s.data() and again == s );
+
+        // The next change gives the vector its own copy; the snapshots keep the old contents.
+        v.push_back( 6 );
+        v.front() = 100;
+        EXPECT_TRUE( s.size() == 5 and s[0] == 1 and s.back() == 5 );
+        EXPECT_TRUE( ( v == sc::vector<int>{ 100, 2, 3, 4, 5, 6 } ) );
+        EXPECT_TRUE( s.data() != v.data() and s.use_count() == 2 );
+        // Writing through operator[] copies too.
+        auto u = v.snapshot();
+        v[2] = 300;
+        EXPECT_TRUE( u[2] == 3 and v[2] == 300 and u.data() != v.data() );
+
+        // Once no snapshot is left the vector takes its buffer back instead of copying.
+        {
+            auto t = v.snapshot();
+            EXPECT_EQ( t.use_count(), 2 );
+        }
+        const int *before = v.data();
+        v[1] = 200;
+        EXPECT_TRUE( v.data() == before and v[1] == 200 );
+
+        // Snapshots of non-trivial elements outlive the vector.
+        sc::vector<std::string> words{ "alpha", "beta" };
+        auto w = words.snapshot();
+        words.erase( words.begin() );
+        words.clear();
+        EXPECT_TRUE( words.empty() and w.size() == 2 and w.front() == "alpha" );
+
+        // A throwing allocation while clearing a shared buffer leaves both sides intact.
+        sc::vector< int, Stingy<int> > tight{ 1, 2, 3 };
+        const auto & ctight = tight;
+        auto kept = tight.snapshot();
+        bool failed{ false };
+        Stingy<int>::budget = 0;
+        try { tight.clear(); }
+        catch ( const std::bad_alloc & ) { failed = true; }
+        Stingy<int>::budget = -1;
+        EXPECT_TRUE( failed and ctight.size() == 3 and ctight[2] == 3 and kept.size() == 3 );
+        tight.clear();
+        EXPECT_TRUE( tight.empty() and kept[0] == 1 );
+
+        auto gone = sc::vector<std::string>{ "x", "y", "z" }.snapshot();
+        EXPECT_TRUE( gone.size() == 3 and gone.at( 2 ) == "z" );
+
+        bool thrown{ false };
+        try { gone.at( 3 ); }
+        catch ( const std::out_of_range & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+        thrown = false;
+        try { sc::vector_snapshot<int, std::allocator<int>>{}.front(); }
+        catch ( const std::length_error & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+
+        // Threads sharing a const vector may take snapshots at once: they all get the same block.
+        const sc::vector<int> shared{ 7, 8, 9 };
+        sc::vector_snapshot<int, std::allocator<int>> taken[4];
+        std::thread takers[4];
+        for ( int t{0} ; t < 4 ; ++t )
+            takers[t] = std::thread( [&, t] { taken[t] = shared.snapshot(); } );
+        for ( auto & t : takers ) t.join();
+        bool same_block{ true };
+        for ( auto & t : taken )
+            same_block = same_block and t.data() == shared.data() and t == taken[0];
+        EXPECT_TRUE( same_block );
+
+        // One writer publishes while readers load: every snapshot a reader sees is consistent.
+        sc::vector<int> table;
+        table.assign( 64u, 0 );
+        sc::atomic_snapshot<int> current{ table.snapshot() };
+        std::atomic<bool> done{ false };
+        std::atomic<bool> consistent{ true };
+        std::thread reader( [&] {
+            while ( not done.load() )
+            {
+                auto seen = current.load();
+                for ( auto x : seen )
+                    if ( x != seen.front() ) consistent = false;
+            }
+        } );
+        for ( int round{1} ; round <= 500 ; ++round )
+        {
+            auto data = table.data();
+            for ( std::size_t i{0} ; i < table.size() ; ++i ) data[i] = round;
+            current.store( table.snapshot() );
+        }
+        done = true;
+        reader.join();
+        EXPECT_TRUE( consistent.load() );
+        EXPECT_EQ( current.load()[63], 500 );
+    }
+
+    {
+        BEGIN_TEST(tm, "PackedIntVector", "Bit-packed integers with widening, block-delta encoding and SIMD block decode.");
+
+        sc::packed_int_vector<std::uint32_t> pv;
+        pv.push_back( 3 );
+        EXPECT_EQ( pv.width(), 2u );
+        pv.push_back( 1000 );
+        pv.push_back( 0 );
+        EXPECT_TRUE( pv.width() == 10 and pv[0] == 3 and pv[1] == 1000 and pv[2] == 0 );
+        // Widening repacks every element in place, including those straddling two words.
+        sc::vector<std::uint32_t> plain;
+        for ( std::uint32_t i{0} ; i < 1000 ; ++i ) { pv.push_back( i * 7 ); plain.push_back( i * 7 ); }
+        pv.set( 500, 0xFFFFFFFFu );
+        EXPECT_EQ( pv.width(), 32u );
+        plain[497] = 0xFFFFFFFFu;
+        bool same{ true };
+        for ( std::size_t i{0} ; i < plain.size() ; ++i ) same = same and pv[i + 3] == plain[i];
+        EXPECT_TRUE( same and pv.size() == 1003 );
+        pv.set( 500, 1 );
+        pv.pop_back();
+        EXPECT_TRUE( pv.back() == 998 * 7 and pv.size() == 1002 );
+
+        sc::vector<std::uint64_t> ids;
+        for ( std::uint64_t i{0} ; i < 5000 ; ++i ) ids.push_back( i * 3 + ( i % 5 ) );
+        sc::packed_int_vector<std::uint64_t> packed( ids );
+        EXPECT_TRUE( packed.width() == 14 and packed.to_vector() == ids );
+        EXPECT_TRUE( packed.bytes() * 4 < ids.size() * sizeof( std::uint64_t ) );
+        EXPECT_TRUE( ( std::equal( packed.begin(), packed.end(), ids.begin() ) ) );
+        EXPECT_TRUE( packed.begin() < packed.end() and packed.end() > packed.begin() and packed.begin() <= packed.begin() and packed.end() >= packed.begin() and not ( packed.begin() >= packed.end() ) );
+        EXPECT_TRUE( ( sc::packed_int_vector<std::uint64_t>{ 1, 2, 3 } == sc::packed_int_vector<std::uint64_t>{ 1, 2, 3 } ) );
+        sc::packed_int_vector<std::uint64_t> wide( 40u );
+        wide.resize( 3, 2 );
+        EXPECT_TRUE( ( wide == sc::packed_int_vector<std::uint64_t>{ 2, 2, 2 } ) );
+
+        bool thrown{ false };
+        try { packed.at( 5000 ); }
+        catch ( const std::out_of_range & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+        thrown = false;
+        try { sc::packed_int_vector<std::uint32_t> bad( 33u ); }
+        catch ( const std::invalid_argument & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+
+        // Sorted IDs shrink to a few bits per element; unsorted and wrapping data still round-trips.
+        sc::delta_packed_vector<std::uint64_t> sorted( ids );
+        EXPECT_TRUE( sorted.size() == 5000 and sorted.block_count() == 40 and sorted[4321] == ids[4321] );
+        EXPECT_TRUE( sorted.bytes() * 8 < ids.size() * sizeof( std::uint64_t ) );
+        sc::vector<std::uint32_t> noisy;
+        std::uint32_t x{ 12345 };
+        for ( int i{0} ; i < 1001 ; ++i ) { x = x * 1664525u + 1013904223u; noisy.push_back( i % 3 == 0 ? x : 4000000000u - i ); }
+        sc::delta_packed_vector<std::uint32_t> mixed( noisy );
+        bool exact{ true };
+        for ( auto lvl : { sc::simd::level::scalar, sc::simd::level::sse2, sc::simd::level::avx2, sc::simd::level::avx512 } )
+        {
+            sc::simd::set_max_level( lvl );
+            exact = exact and mixed.to_vector() == noisy and sorted.to_vector() == ids;
+        }
+        sc::simd::set_max_level( sc::simd::level::avx512 );
+        for ( std::size_t i{0} ; i < noisy.size() ; i += 7 ) exact = exact and mixed[i] == noisy[i];
+        EXPECT_TRUE( exact and mixed.back() == noisy.back() );
+        std::uint64_t total{ 0 }, expected{ 0 };
+        for ( auto v : ids ) expected += v;
+        sorted.for_each_block( [&]( const std::uint64_t *values, std::size_t n ) { for ( std::size_t i{0} ; i < n ; ++i ) total += values[i]; } );
+        EXPECT_EQ( total, expected );
+        EXPECT_TRUE( sc::delta_packed_vector<std::uint64_t>( ids ) == sorted and sorted != sc::delta_packed_vector<std::uint64_t>() );
+        thrown = false;
+        try { mixed.at( 1001 ); }
+        catch ( const std::out_of_range & ) { thrown = true; }
+        EXPECT_TRUE( thrown );
+    }
+
     tm.summary();
     std::cout << "\n\n";
 
@@ -927,7 +2314,194 @@ int main( void )
         EXPECT_FALSE( it1 != it2 );
     }
 
+    {
+        BEGIN_TEST(tm2, "RandomAccess","it[n], it += n, it -= n, it->, <, >, <=, >=");
+
+        which_lib::vector<std::pair<int,int>> vec { {1,1}, {2,4}, {3,9}, {4,16}, {5,25} };
+
+        auto it = vec.begin();
+        EXPECT_EQ( it[3].second , 16 );
+        it += 4;
+        EXPECT_EQ( it->first , 5 );
+        it -= 2;
+        EXPECT_EQ( (*it).second , 9 );
+        EXPECT_TRUE( vec.begin() < it and it > vec.begin() and it <= it and it >= vec.begin() );
+        EXPECT_FALSE( vec.end() < it );
+        EXPECT_TRUE( ( std::is_same<std::iterator_traits<decltype(it)>::iterator_category, std::random_access_iterator_tag>::value ) );
+    }
+
+    {
+        BEGIN_TEST(tm2, "ConstConversion","iterator -> const_iterator, mixed comparison and distance");
+
+        which_lib::vector<int> vec { 1, 2, 4, 5, 6 };
+
+        which_lib::vector<int>::const_iterator cit = vec.begin();
+        auto it = vec.begin() + 2;
+        EXPECT_TRUE( cit == vec.begin() and vec.begin() == cit and it != cit );
+        EXPECT_EQ( it - cit , 2 );
+        EXPECT_EQ( cit - it , -2 );
+        EXPECT_TRUE( cit < it );
+        // A const vector iterates with const_iterators.
+        const which_lib::vector<int> & cref = vec;
+        int sum{0};
+        for ( const auto & x : cref ) sum += x;
+        EXPECT_EQ( sum , 18 );
+        EXPECT_FALSE( ( std::is_convertible<which_lib::vector<int>::const_iterator, which_lib::vector<int>::iterator>::value ) );
+        // Erasing through a const_iterator obtained from an iterator.
+        vec.erase( which_lib::vector<int>::const_iterator( vec.begin() ) );
+        EXPECT_EQ( vec.front() , 2 );
+    }
+
+    {
+        BEGIN_TEST(tm2, "StdAlgorithms","std::sort, std::lower_bound, std::distance, std::reverse over sc::vector");
+
+        which_lib::vector<int> vec;
+        for ( int i{0} ; i < 1000 ; ++i ) vec.push_back( ( i * 7919 ) % 1000 );
+        std::sort( vec.begin(), vec.end() );
+        EXPECT_TRUE( std::is_sorted( vec.begin(), vec.end() ) );
+        auto at = std::lower_bound( vec.begin(), vec.end(), 500 );
+        EXPECT_TRUE( *at == 500 and std::distance( vec.begin(), at ) == 500 );
+        std::reverse( vec.begin(), vec.end() );
+        EXPECT_EQ( vec.front() , 999 );
+        // Copies from a contiguous range.
+        which_lib::vector<int> copy( vec.begin(), vec.end() );
+        EXPECT_TRUE( copy == vec );
+        copy.assign( vec.cbegin() + 10, vec.cend() );
+        EXPECT_TRUE( copy.size() == 990 and copy.front() == 989 );
+        copy.insert( copy.begin(), vec.cbegin(), vec.cbegin() + 10 );
+        EXPECT_TRUE( copy == vec );
+    }
+
     tm2.summary();
+    std::cout << "\n\n";
+
+
+    // Third batch of tests, focused on the small vector.
+
+    TestManager tm3{ "Small vector testing"};
+
+    {
+        BEGIN_TEST(tm3, "InlineStorage","no heap memory up to N elements");
+        sc::small_vector<int, 4> vec;
+
+        EXPECT_TRUE( vec.empty() );
+        EXPECT_EQ( vec.capacity(), 4 );
+        for ( auto i{0} ; i < 4 ; ++i )
+            vec.push_back( i+1 );
+        EXPECT_TRUE( vec.is_inline() );
+        EXPECT_EQ( vec.capacity(), 4 );
+
+        // One more element spills to the heap.
+        vec.push_back( 5 );
+        EXPECT_FALSE( vec.is_inline() );
+        EXPECT_EQ( vec.size(), 5 );
+        for ( auto i{0u} ; i < vec.size() ; ++i )
+            EXPECT_EQ( vec[i], (int)i+1 );
+    }
+
+    {
+        BEGIN_TEST(tm3, "InsertErase","insert(), erase() and assign() inline and spilled");
+        {
+            sc::small_vector<Tracked, 3> vec;
+            vec.push_back( Tracked{ 1 } );
+            vec.push_back( Tracked{ 4 } );
+            vec.insert( std::next( vec.begin(), 1 ), { Tracked{ 2 }, Tracked{ 3 } } );
+            EXPECT_FALSE( vec.is_inline() );
+            EXPECT_EQ( vec.size(), 4 );
+            for ( auto i{0u} ; i < vec.size() ; ++i )
+                EXPECT_EQ( vec[i].value, (int)i+1 );
+
+            // Inserting a copy of one of our own elements.
+            vec.insert( vec.begin(), vec.back() );
+            EXPECT_EQ( vec.front().value, 4 );
+            vec.erase( vec.begin(), std::next( vec.begin(), 2 ) );
+            EXPECT_EQ( vec.front().value, 2 );
+            vec.erase( vec.begin() );
+            EXPECT_EQ( vec.size(), 2 );
+            EXPECT_EQ( Tracked::alive, 2 );
+
+            vec.assign( 5, Tracked{ 9 } );
+            EXPECT_EQ( vec.size(), 5 );
+            EXPECT_EQ( vec.at( 4 ).value, 9 );
+        }
+        EXPECT_EQ( Tracked::alive, 0 );
+
+        // Two integers are a count and a value, not a range.
+        sc::small_vector<int, 2> ints;
+        ints.assign( 3, 7 );
+        EXPECT_EQ( ints.size(), 3 );
+        EXPECT_EQ( ints[0] + ints[1] + ints[2], 21 );
+    }
+
+    {
+        BEGIN_TEST(tm3, "CopyMove","copy and move, inline and spilled");
+        sc::small_vector<int, 4> small{ 1, 2, 3 };
+        sc::small_vector<int, 4> big{ 1, 2, 3, 4, 5, 6 };
+
+        sc::small_vector<int, 4> copy{ big };
+        EXPECT_EQ( copy, big );
+        // Assignment keeps the heap buffer already in use.
+        copy = small;
+        EXPECT_EQ( copy, small );
+        EXPECT_FALSE( copy.is_inline() );
+
+        // Moving a spilled vector steals its buffer.
+        auto big_data = big.data();
+        sc::small_vector<int, 4> moved{ std::move( big ) };
+        EXPECT_EQ( moved.data(), big_data );
+        EXPECT_TRUE( big.empty() );
+        EXPECT_TRUE( big.is_inline() );
+
+        // Moving an inline vector moves the elements.
+        sc::small_vector<int, 4> moved_small;
+        moved_small = std::move( small );
+        EXPECT_EQ( moved_small, ( sc::small_vector<int, 4>{ 1, 2, 3 } ) );
+        EXPECT_TRUE( moved_small.is_inline() );
+    }
+
+    {
+        BEGIN_TEST(tm3, "ShrinkToFit","shrink_to_fit() goes back inline");
+        sc::small_vector<int, 4> vec{ 1, 2, 3, 4, 5, 6 };
+        vec.erase( std::next( vec.begin(), 2 ), vec.end() );
+        EXPECT_FALSE( vec.is_inline() );
+        vec.shrink_to_fit();
+        EXPECT_TRUE( vec.is_inline() );
+        EXPECT_EQ( vec, ( sc::small_vector<int, 4>{ 1, 2 } ) );
+    }
+
+    {
+        BEGIN_TEST(tm3, "BaseInterop","small_vector_base<T>& accepts any N");
+        sc::small_vector<int, 2> two;
+        sc::small_vector<int, 8> eight;
+        append_squares( two, 5 );
+        append_squares( eight, 5 );
+        EXPECT_FALSE( two.is_inline() );
+        EXPECT_TRUE( eight.is_inline() );
+        EXPECT_EQ( two, eight );
+
+        sc::small_vector<int, 8> from_two{ two };
+        EXPECT_EQ( from_two, two );
+        EXPECT_TRUE( from_two.is_inline() );
+    }
+
+    {
+        BEGIN_TEST(tm3, "SpanInterop","sc::span<const T> accepts sc::vector and sc::small_vector");
+        sc::vector<int> vec{ 1, 2, 3, 4 };
+        sc::small_vector<int, 2> small{ 1, 2, 3, 4 };
+        const sc::small_vector<int, 8> const_small{ 1, 2, 3, 4 };
+
+        EXPECT_EQ( sum( vec ), 10 );
+        EXPECT_EQ( sum( small ), 10 );
+        EXPECT_EQ( sum( const_small ), 10 );
+
+        sc::span<int> view{ vec };
+        view[0] = 100;
+        EXPECT_EQ( vec[0], 100 );
+        EXPECT_EQ( view.subspan( 1 ).size(), 3 );
+        EXPECT_EQ( sum( view.last( 2 ) ), 7 );
+    }
+
+    tm3.summary();
 
     return 0;
 }